@@ -0,0 +1,146 @@
+#include "media/rtmp/rtmp_export_chunk.h"
+#include "media/rtmp/rtmp_import_chunk.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//====================================================================================================
+// Chunk allocation bench
+//  - counts heap allocations(replaced operator new) of the chunk codec per chunk/message
+//  - import : one message(type 0 chunks) imported repeatedly, body buffers come from BufferPool
+//  - export : stream export(header compression) and message export of the same body
+//====================================================================================================
+namespace {
+std::atomic<uint64_t> allocCount{0};
+
+void *CountAlloc(size_t size) {
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *CountAlignedAlloc(size_t size, std::align_val_t align) {
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  auto alignment = static_cast<size_t>(align);
+  if (void *ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(size_t size) { return CountAlloc(size); }
+void *operator new[](size_t size) { return CountAlloc(size); }
+void *operator new(size_t size, std::align_val_t align) { return CountAlignedAlloc(size, align); }
+void *operator new[](size_t size, std::align_val_t align) { return CountAlignedAlloc(size, align); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace {
+constexpr size_t MessageSize = 1024 * 1024; // byte, video key frame class
+constexpr int MessageCount = 100;
+constexpr int WarmupCount = 4; // BufferPool free lists
+
+struct BenchResult {
+  uint64_t allocCount = 0;
+  double elapsed = 0; // ms
+};
+
+template <typename Func> BenchResult Measure(int count, Func &&func) {
+  for (int index = 0; index < WarmupCount; ++index) {
+    func(index);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto startCount = allocCount.load(std::memory_order_relaxed);
+
+  for (int index = 0; index < count; ++index) {
+    func(index);
+  }
+
+  BenchResult result;
+  result.allocCount = allocCount.load(std::memory_order_relaxed) - startCount;
+  result.elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+//====================================================================================================
+// Import(chunk parsing + message assembly)
+//====================================================================================================
+BenchResult BenchImport(int chunkSize, const std::shared_ptr<std::vector<uint8_t>> &body) {
+  RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream), 0,
+                          static_cast<int>(Rtmp::MsgType::VideoMsg), 1, body->size());
+  auto wire = RtmpExportChunk::ExportMsgData(chunkSize, header, body);
+  RtmpImportChunk importChunk(chunkSize);
+
+  return Measure(MessageCount, [&](int) {
+    int procSize = 0;
+    while (procSize < static_cast<int>(wire->size())) {
+      auto [size, isComplete] = importChunk.ImportStreamData(wire->data() + procSize, wire->size() - procSize);
+      if (size <= 0) {
+        std::fprintf(stderr, "import fail - chunk(%d) size(%d)\n", chunkSize, size);
+        std::exit(1);
+      }
+      procSize += size;
+    }
+
+    while (auto msg = importChunk.GetMessage()) {
+    }
+  });
+}
+
+//====================================================================================================
+// Export(stream : header compression, message : type 0)
+//====================================================================================================
+BenchResult BenchExportStream(int chunkSize, const std::shared_ptr<std::vector<uint8_t>> &body) {
+  RtmpExportChunk exportChunk(true, chunkSize);
+
+  return Measure(MessageCount, [&](int index) {
+    RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream), index * 40,
+                            static_cast<int>(Rtmp::MsgType::VideoMsg), 1, body->size());
+    auto data = exportChunk.ExportStreamData(header, body);
+  });
+}
+
+BenchResult BenchExportMsg(int chunkSize, const std::shared_ptr<std::vector<uint8_t>> &body) {
+  return Measure(MessageCount, [&](int index) {
+    RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream), index * 40,
+                            static_cast<int>(Rtmp::MsgType::VideoMsg), 1, body->size());
+    auto data = RtmpExportChunk::ExportMsgData(chunkSize, header, body);
+  });
+}
+} // namespace
+
+int main() {
+  auto body = std::make_shared<std::vector<uint8_t>>(MessageSize, 0x01);
+
+  std::printf("message(%zuKB) count(%d)\n", MessageSize / 1024, MessageCount);
+
+  for (int chunkSize : {Rtmp::DefaultChunkSize, 4096}) {
+    const double chunkCount = static_cast<double>((MessageSize + chunkSize - 1) / chunkSize) * MessageCount;
+
+    auto import = BenchImport(chunkSize, body);
+    auto exportStream = BenchExportStream(chunkSize, body);
+    auto exportMsg = BenchExportMsg(chunkSize, body);
+
+    std::printf("chunk(%d) import : %.3f alloc/chunk %.1f alloc/msg %.3f ms/msg\n", chunkSize,
+                import.allocCount / chunkCount, static_cast<double>(import.allocCount) / MessageCount,
+                import.elapsed / MessageCount);
+    std::printf("chunk(%d) export stream : %.1f alloc/msg %.3f ms/msg\n", chunkSize,
+                static_cast<double>(exportStream.allocCount) / MessageCount, exportStream.elapsed / MessageCount);
+    std::printf("chunk(%d) export msg : %.1f alloc/msg %.3f ms/msg\n", chunkSize,
+                static_cast<double>(exportMsg.allocCount) / MessageCount, exportMsg.elapsed / MessageCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,317 @@
+#include "buffer_pool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+
+//===============================================================================================
+// BufferBlock(pooled buffer + its shared_ptr control block)
+//===============================================================================================
+struct BufferBlock {
+  static constexpr size_t ControlSize = 64; // byte, shared_ptr control block(deleter + allocator)
+
+  alignas(std::max_align_t) std::byte control[ControlSize];
+  std::vector<uint8_t> buffer;
+  LocalBufferPool *owner = nullptr;
+  int classIndex = 0;
+  BufferBlock *next = nullptr; // free list, return list
+};
+
+//===============================================================================================
+// BufferBlockAllocator
+//  - control block is placed in the block, the block goes back to the pool when it is destroyed
+//    (after the last weak reference, the deleter does nothing)
+//===============================================================================================
+template <typename T> struct BufferBlockAllocator {
+  using value_type = T;
+
+  explicit BufferBlockAllocator(BufferBlock *block) : block(block) {}
+  template <typename U> BufferBlockAllocator(const BufferBlockAllocator<U> &other) : block(other.block) {}
+
+  T *allocate(size_t) {
+    static_assert(sizeof(T) <= BufferBlock::ControlSize && alignof(T) <= alignof(std::max_align_t),
+                  "BufferBlock::ControlSize");
+    return reinterpret_cast<T *>(block->control); // count : 1(one control block)
+  }
+  void deallocate(T *, size_t) { BufferPool::Release(block); }
+
+  template <typename U> bool operator==(const BufferBlockAllocator<U> &other) const { return block == other.block; }
+  template <typename U> bool operator!=(const BufferBlockAllocator<U> &other) const { return block != other.block; }
+
+  BufferBlock *block;
+};
+
+struct BufferBlockDeleter {
+  void operator()(std::vector<uint8_t> *) const {}
+};
+
+//===============================================================================================
+// LocalBufferPool(one per thread)
+//  - free lists : owner thread only
+//  - return list : other threads push(lock free), the owner takes all when a free list is empty
+//  - pools are never freed(blocks point at them), a thread exit leaves an orphan for the next thread
+//===============================================================================================
+struct LocalBufferPool {
+  enum class State { None, Alive, Destroyed };
+
+  BufferBlock *Pop(int classIndex);
+  void Push(BufferBlock *block);
+  void PushReturn(BufferBlock *block);
+  void TakeReturns();
+  void Clear();
+
+  static void Count(std::atomic<uint64_t> &counter, int64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); // owner only
+  }
+
+  std::array<BufferBlock *, BufferPool::ClassCount> freeLists{};
+  std::array<size_t, BufferPool::ClassCount> freeCounts{};
+  std::atomic<BufferBlock *> returnList{nullptr};
+  std::atomic<bool> isOrphan{false};
+
+  // written by the owner thread, read by GetStats
+  std::atomic<uint64_t> allocCount{0};
+  std::atomic<uint64_t> hitCount{0};
+  std::atomic<uint64_t> overCount{0};
+  std::atomic<uint64_t> returnCount{0};
+  std::atomic<uint64_t> residentSize{0};
+};
+
+namespace {
+struct PoolRegistry {
+  std::mutex lock;
+  std::vector<LocalBufferPool *> pools;
+  std::vector<LocalBufferPool *> orphans;
+};
+
+// never destroyed : buffers released by static destructors still reach their pool
+PoolRegistry &GetRegistry() {
+  static auto *registry = new PoolRegistry();
+  return *registry;
+}
+
+struct LocalPoolHandle {
+  LocalPoolHandle();
+  ~LocalPoolHandle();
+
+  LocalBufferPool *pool = nullptr;
+};
+
+thread_local LocalBufferPool::State localPoolState = LocalBufferPool::State::None;
+thread_local LocalPoolHandle localPoolHandle;
+
+// thread exit 이후 alloc/release 는 pool 없이 처리
+LocalBufferPool *GetLocalPool() {
+  return localPoolState == LocalBufferPool::State::Destroyed ? nullptr : localPoolHandle.pool;
+}
+
+LocalPoolHandle::LocalPoolHandle() {
+  auto &registry = GetRegistry();
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(registry.lock);
+    if (!registry.orphans.empty()) {
+      pool = registry.orphans.back();
+      registry.orphans.pop_back();
+    } else {
+      pool = new LocalBufferPool();
+      registry.pools.push_back(pool);
+    }
+  }
+
+  pool->isOrphan.store(false, std::memory_order_release);
+  localPoolState = LocalBufferPool::State::Alive;
+}
+
+LocalPoolHandle::~LocalPoolHandle() {
+  localPoolState = LocalBufferPool::State::Destroyed;
+
+  // releases after this point delete the block(returns pushed before are taken by the next owner)
+  pool->isOrphan.store(true, std::memory_order_release);
+  pool->TakeReturns();
+  pool->Clear();
+
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.lock);
+  registry.orphans.push_back(pool);
+}
+} // namespace
+
+//===============================================================================================
+// LocalBufferPool - free list
+//===============================================================================================
+BufferBlock *LocalBufferPool::Pop(int classIndex) {
+  if (freeLists[classIndex] == nullptr) {
+    TakeReturns();
+  }
+
+  auto *block = freeLists[classIndex];
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  freeLists[classIndex] = block->next;
+  freeCounts[classIndex]--;
+  Count(residentSize, -static_cast<int64_t>(block->buffer.capacity()));
+  return block;
+}
+
+void LocalBufferPool::Push(BufferBlock *block) {
+  auto classIndex = block->classIndex;
+  auto classSize = BufferPool::MinClassSize << (classIndex * 2);
+  auto maxCount = std::min(BufferPool::MaxLocalClassCount,
+                           std::max<size_t>(BufferPool::MaxLocalClassSize / classSize, 1));
+
+  if (block->buffer.capacity() < classSize || freeCounts[classIndex] >= maxCount) {
+    delete block;
+    return;
+  }
+
+  Count(residentSize, static_cast<int64_t>(block->buffer.capacity()));
+  block->next = freeLists[classIndex];
+  freeLists[classIndex] = block;
+  freeCounts[classIndex]++;
+}
+
+//===============================================================================================
+// LocalBufferPool - return list
+//  - push : any thread, take : owner thread(whole list at once, no ABA)
+//===============================================================================================
+void LocalBufferPool::PushReturn(BufferBlock *block) {
+  auto *head = returnList.load(std::memory_order_relaxed);
+  do {
+    block->next = head;
+  } while (!returnList.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void LocalBufferPool::TakeReturns() {
+  auto *block = returnList.exchange(nullptr, std::memory_order_acquire);
+  while (block != nullptr) {
+    auto *next = block->next;
+    Count(returnCount, 1);
+    Push(block);
+    block = next;
+  }
+}
+
+void LocalBufferPool::Clear() {
+  for (size_t classIndex = 0; classIndex < freeLists.size(); ++classIndex) {
+    while (auto *block = freeLists[classIndex]) {
+      freeLists[classIndex] = block->next;
+      Count(residentSize, -static_cast<int64_t>(block->buffer.capacity()));
+      delete block;
+    }
+    freeCounts[classIndex] = 0;
+  }
+}
+
+//===============================================================================================
+// GetClassIndex
+//===============================================================================================
+int BufferPool::GetClassIndex(size_t size) {
+  if (size > MaxClassSize) {
+    return -1;
+  }
+
+  int classIndex = 0;
+  for (size_t classSize = MinClassSize; classSize < size; classSize <<= 2) {
+    classIndex++;
+  }
+  return classIndex;
+}
+
+//===============================================================================================
+// Alloc
+//===============================================================================================
+std::shared_ptr<std::vector<uint8_t>> BufferPool::Alloc(size_t size) {
+  auto pool = GetLocalPool();
+  if (pool == nullptr) {
+    return std::make_shared<std::vector<uint8_t>>(size);
+  }
+
+  auto classIndex = GetClassIndex(size);
+  if (classIndex < 0) {
+    LocalBufferPool::Count(pool->overCount, 1);
+    return std::make_shared<std::vector<uint8_t>>(size);
+  }
+
+  LocalBufferPool::Count(pool->allocCount, 1);
+
+  auto *block = pool->Pop(classIndex);
+  if (block != nullptr) {
+    LocalBufferPool::Count(pool->hitCount, 1);
+  } else {
+    block = new BufferBlock();
+    block->buffer.reserve(MinClassSize << (classIndex * 2));
+    block->owner = pool;
+    block->classIndex = classIndex;
+  }
+
+  block->buffer.resize(size);
+
+  return std::shared_ptr<std::vector<uint8_t>>(&block->buffer, BufferBlockDeleter(),
+                                               BufferBlockAllocator<std::vector<uint8_t>>(block));
+}
+
+//===============================================================================================
+// Alloc(copy)
+//===============================================================================================
+std::shared_ptr<std::vector<uint8_t>> BufferPool::Alloc(const uint8_t *data, size_t size) {
+  auto buffer = Alloc(size);
+  if (size > 0) {
+    std::memcpy(buffer->data(), data, size);
+  }
+  return buffer;
+}
+
+//===============================================================================================
+// Release(control block deallocation)
+//  - owner thread : free list, other thread : owner return list, orphan owner : delete
+//===============================================================================================
+void BufferPool::Release(BufferBlock *block) {
+  auto *owner = block->owner;
+
+  if (GetLocalPool() == owner) {
+    owner->Push(block);
+  } else if (owner->isOrphan.load(std::memory_order_acquire)) {
+    delete block;
+  } else {
+    owner->PushReturn(block);
+  }
+}
+
+//===============================================================================================
+// GetStats
+//  - sum of the pools(alive + orphan, counters of exited threads are kept)
+//===============================================================================================
+BufferPoolStats BufferPool::GetStats() {
+  BufferPoolStats stats;
+  auto &registry = GetRegistry();
+
+  std::lock_guard<std::mutex> lock(registry.lock);
+  for (const auto *pool : registry.pools) {
+    stats.allocCount += pool->allocCount.load(std::memory_order_relaxed);
+    stats.hitCount += pool->hitCount.load(std::memory_order_relaxed);
+    stats.overCount += pool->overCount.load(std::memory_order_relaxed);
+    stats.returnCount += pool->returnCount.load(std::memory_order_relaxed);
+    stats.residentSize += pool->residentSize.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+//===============================================================================================
+// GetStatsString
+//===============================================================================================
+std::string BufferPool::GetStatsString() {
+  auto stats = GetStats();
+
+  std::ostringstream oss;
+  oss << "alloc(" << stats.allocCount << ") hit(" << stats.hitCount << ":" << static_cast<int>(stats.GetHitRate())
+      << "%) over(" << stats.overCount << ") return(" << stats.returnCount << ") resident("
+      << stats.residentSize / 1024 << "KB)";
+  return oss.str();
+}
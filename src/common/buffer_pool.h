@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct BufferPoolStats {
+  uint64_t allocCount = 0;   // pool class size request
+  uint64_t hitCount = 0;     // reused buffer
+  uint64_t overCount = 0;    // over max class size(not pooled)
+  uint64_t returnCount = 0;  // released on another thread, back to the owner pool
+  uint64_t residentSize = 0; // byte, cached(free) buffers
+
+  double GetHitRate() const { return allocCount == 0 ? 0 : static_cast<double>(hitCount) * 100 / allocCount; }
+};
+
+struct BufferBlock;
+struct LocalBufferPool;
+
+//===============================================================================================
+// BufferPool
+//  - size classes 256B ~ 4MB(x4), free lists are thread local(no lock)
+//  - handle is a shared_ptr whose control block lives in the pooled block(no allocation on a hit)
+//  - a buffer released on another thread goes back to the owner pool(lock free return list),
+//    fan-out(publisher alloc, player release) keeps hitting the publisher pool
+//  - stats are counted per pool(owner thread) and summed by GetStats
+//  - buffer contents are not cleared
+//===============================================================================================
+class BufferPool {
+public:
+  static std::shared_ptr<std::vector<uint8_t>> Alloc(size_t size);
+  static std::shared_ptr<std::vector<uint8_t>> Alloc(const uint8_t *data, size_t size);
+  static BufferPoolStats GetStats();
+  static std::string GetStatsString();
+
+  static constexpr size_t MinClassSize = 256;
+  static constexpr size_t ClassCount = 8;
+  static constexpr size_t MaxClassSize = MinClassSize << ((ClassCount - 1) * 2);
+  static constexpr size_t MaxLocalClassSize = 8 * 1024 * 1024; // byte, per class per thread
+  static constexpr size_t MaxLocalClassCount = 256;
+
+private:
+  static int GetClassIndex(size_t size);
+  static void Release(BufferBlock *block); // control block deallocation(last shared/weak reference)
+
+  template <typename T> friend struct BufferBlockAllocator;
+  friend struct LocalBufferPool;
+};
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <pthread.h>
 #include <random>
 #include <regex>
 #include <sstream>
@@ -115,6 +116,152 @@ uint64_t ConvertTimescale(uint64_t timestamp, uint32_t fromTimescale, uint32_t t
   return static_cast<uint64_t>(static_cast<double>(timestamp) * ratio);
 }
 
+//====================================================================================================
+// CPU set parse
+//  - "0-3,6" : range and single cpu, sorted without duplicates
+//====================================================================================================
+std::vector<int> ParseCpuSet(const std::string &cpuSet) {
+  std::vector<int> cpus;
+  auto items = StringHelper::Tokenize(cpuSet, ",");
+
+  for (const auto &item : *items) {
+    int first = -1;
+    int last = -1;
+
+    if (std::sscanf(item.c_str(), "%d-%d", &first, &last) == 1) {
+      last = first;
+    }
+
+    if (first < 0 || last < first || last >= CPU_SETSIZE) {
+      continue;
+    }
+
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+//====================================================================================================
+// Current thread cpu affinity
+//  - threads created after the call inherit the set
+//====================================================================================================
+bool SetCurrentThreadCpuSet(const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return false;
+  }
+
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &cpuSet);
+  }
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+//====================================================================================================
+// SHA-1
+//  - 64 byte blocks, message + 0x80 + zero padding + 64bit bit length(big endian)
+//====================================================================================================
+std::array<uint8_t, 20> Sha1(const uint8_t *data, size_t size) {
+  uint32_t hash[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+  auto rotate = [](uint32_t value, int bits) { return (value << bits) | (value >> (32 - bits)); };
+
+  auto paddedSize = ((size + 8) / 64 + 1) * 64;
+  std::vector<uint8_t> message(paddedSize, 0);
+  std::copy(data, data + size, message.begin());
+  message[size] = 0x80;
+
+  uint64_t bitSize = static_cast<uint64_t>(size) * 8;
+  for (int index = 0; index < 8; ++index) {
+    message[paddedSize - 1 - index] = static_cast<uint8_t>(bitSize >> (index * 8));
+  }
+
+  for (size_t offset = 0; offset < paddedSize; offset += 64) {
+    uint32_t words[80];
+
+    for (int index = 0; index < 16; ++index) {
+      const auto *word = message.data() + offset + index * 4;
+      words[index] = (static_cast<uint32_t>(word[0]) << 24) | (static_cast<uint32_t>(word[1]) << 16) |
+                     (static_cast<uint32_t>(word[2]) << 8) | word[3];
+    }
+    for (int index = 16; index < 80; ++index) {
+      words[index] = rotate(words[index - 3] ^ words[index - 8] ^ words[index - 14] ^ words[index - 16], 1);
+    }
+
+    uint32_t a = hash[0], b = hash[1], c = hash[2], d = hash[3], e = hash[4];
+
+    for (int index = 0; index < 80; ++index) {
+      uint32_t f, k;
+      if (index < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5a827999;
+      } else if (index < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ed9eba1;
+      } else if (index < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8f1bbcdc;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xca62c1d6;
+      }
+
+      uint32_t temp = rotate(a, 5) + f + e + k + words[index];
+      e = d;
+      d = c;
+      c = rotate(b, 30);
+      b = a;
+      a = temp;
+    }
+
+    hash[0] += a;
+    hash[1] += b;
+    hash[2] += c;
+    hash[3] += d;
+    hash[4] += e;
+  }
+
+  std::array<uint8_t, 20> digest;
+  for (int index = 0; index < 20; ++index) {
+    digest[index] = static_cast<uint8_t>(hash[index / 4] >> ((3 - index % 4) * 8));
+  }
+
+  return digest;
+}
+
+//====================================================================================================
+// Base64 encode
+//====================================================================================================
+std::string Base64Encode(const uint8_t *data, size_t size) {
+  static constexpr char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string text;
+  text.reserve((size + 2) / 3 * 4);
+
+  for (size_t offset = 0; offset < size; offset += 3) {
+    uint32_t value = static_cast<uint32_t>(data[offset]) << 16;
+    if (offset + 1 < size) {
+      value |= static_cast<uint32_t>(data[offset + 1]) << 8;
+    }
+    if (offset + 2 < size) {
+      value |= data[offset + 2];
+    }
+
+    text += table[(value >> 18) & 0x3f];
+    text += table[(value >> 12) & 0x3f];
+    text += offset + 1 < size ? table[(value >> 6) & 0x3f] : '=';
+    text += offset + 2 < size ? table[value & 0x3f] : '=';
+  }
+
+  return text;
+}
+
 /*
 //====================================================================================================
 // ConvertTimescale
@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <array>
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
@@ -22,4 +24,15 @@ extern uint64_t ConvertTimescale(uint64_t timestamp, uint32_t from_timescale, ui
 
 extern std::string HostToIp(const std::string &host);
 
+// "0-3,6" -> 0 1 2 3 6(invalid item skipped)
+extern std::vector<int> ParseCpuSet(const std::string &cpuSet);
+
+extern bool SetCurrentThreadCpuSet(const std::vector<int> &cpus);
+
+// FIPS 180-4 SHA-1(websocket accept key, not for security)
+extern std::array<uint8_t, 20> Sha1(const uint8_t *data, size_t size);
+
+// RFC 4648 base64(padding)
+extern std::string Base64Encode(const uint8_t *data, size_t size);
+
 // extern std::string HexStringDump(int dataSize, const uint8_t* data);
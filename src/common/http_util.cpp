@@ -0,0 +1,156 @@
+#include "http_util.h"
+#include "string_helper.hpp"
+#include <algorithm>
+#include <cctype>
+
+//===============================================================================================
+// Get header value
+//===============================================================================================
+std::string HttpRequest::GetHeader(std::string_view name) const {
+  std::string_view lines(header);
+  size_t lineStart = 0;
+
+  while (lineStart < lines.size()) {
+    auto lineEnd = lines.find("\r\n", lineStart);
+    auto line = lines.substr(lineStart, lineEnd == std::string_view::npos ? lineEnd : lineEnd - lineStart);
+
+    auto colon = line.find(':');
+    if (colon != std::string_view::npos && HttpUtil::IsEqualNoCase(line.substr(0, colon), name)) {
+      auto value = line.substr(colon + 1);
+      value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+      return std::string(value.substr(0, value.find_last_not_of(" \t") + 1));
+    }
+
+    if (lineEnd == std::string_view::npos) {
+      break;
+    }
+    lineStart = lineEnd + 2;
+  }
+
+  return "";
+}
+
+//===============================================================================================
+// Get query parameter
+//===============================================================================================
+std::string HttpRequest::GetQuery(std::string_view name) const {
+  std::string_view params(query);
+
+  while (!params.empty()) {
+    auto paramEnd = params.find('&');
+    auto param = params.substr(0, paramEnd);
+
+    auto equal = param.find('=');
+    if (param.substr(0, equal) == name) {
+      return equal == std::string_view::npos ? "" : std::string(param.substr(equal + 1));
+    }
+
+    if (paramEnd == std::string_view::npos) {
+      break;
+    }
+    params.remove_prefix(paramEnd + 1);
+  }
+
+  return "";
+}
+
+//===============================================================================================
+// Keep alive(http/1.1 default)
+//===============================================================================================
+bool HttpRequest::IsKeepAlive() const {
+  auto connection = GetHeader("Connection");
+  if (version == "HTTP/1.0") {
+    return HttpUtil::IsEqualNoCase(connection, "keep-alive");
+  }
+  return !HttpUtil::IsEqualNoCase(connection, "close");
+}
+
+//===============================================================================================
+// Parse request
+//  - request line : METHOD /path[?query] HTTP/1.x
+//===============================================================================================
+int HttpUtil::ParseRequest(std::span<const uint8_t> data, HttpRequest &request, size_t maxSize) {
+  std::string_view text(reinterpret_cast<const char *>(data.data()), data.size());
+
+  auto headerEnd = text.find("\r\n\r\n");
+  if (headerEnd == std::string_view::npos) {
+    return data.size() > maxSize ? -1 : 0;
+  }
+
+  if (headerEnd > maxSize) {
+    return -1;
+  }
+
+  auto lineEnd = text.find("\r\n");
+  auto requestLine = text.substr(0, lineEnd);
+  request = HttpRequest();
+  request.header = text.substr(std::min(lineEnd + 2, headerEnd), headerEnd - std::min(lineEnd + 2, headerEnd));
+
+  auto methodEnd = requestLine.find(' ');
+  auto pathEnd = methodEnd == std::string_view::npos ? methodEnd : requestLine.find(' ', methodEnd + 1);
+  if (pathEnd != std::string_view::npos && methodEnd != 0) {
+    auto target = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    auto queryStart = target.find('?');
+
+    request.method = requestLine.substr(0, methodEnd);
+    request.path = target.substr(0, queryStart);
+    request.query = queryStart == std::string_view::npos ? "" : target.substr(queryStart + 1);
+    request.version = requestLine.substr(pathEnd + 1);
+  }
+
+  return static_cast<int>(headerEnd + 4);
+}
+
+//===============================================================================================
+// Make response header
+//===============================================================================================
+std::string HttpUtil::MakeResponseHeader(int statusCode, std::string_view contentType, int64_t contentLength,
+                                         bool isKeepAlive) {
+  std::string response = StringHelper::Format("HTTP/1.1 %d %s\r\n", statusCode, GetStatusText(statusCode));
+
+  if (!contentType.empty()) {
+    response += "Content-Type: ";
+    response += contentType;
+    response += "\r\n";
+  }
+
+  if (contentLength >= 0) {
+    response += StringHelper::Format("Content-Length: %lld\r\n", static_cast<long long>(contentLength));
+  }
+
+  response += isKeepAlive && contentLength >= 0 ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+  response += "Cache-Control: no-cache\r\n"
+              "Access-Control-Allow-Origin: *\r\n\r\n";
+  return response;
+}
+
+//===============================================================================================
+// Get status text
+//===============================================================================================
+const char *HttpUtil::GetStatusText(int statusCode) {
+  switch (statusCode) {
+  case 101:
+    return "Switching Protocols";
+  case 200:
+    return "OK";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "Unknown";
+  }
+}
+
+//===============================================================================================
+// Compare(ascii case insensitive)
+//===============================================================================================
+bool HttpUtil::IsEqualNoCase(std::string_view left, std::string_view right) {
+  return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin(), [](char a, char b) {
+           return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+         });
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+//===============================================================================================
+// HttpRequest(header only, no body)
+//===============================================================================================
+struct HttpRequest {
+  std::string method; // empty : request line error
+  std::string path;   // query excluded
+  std::string query;
+  std::string version;
+  std::string header; // header lines(request line excluded)
+
+  std::string GetHeader(std::string_view name) const; // case insensitive name, trimmed value
+  std::string GetQuery(std::string_view name) const;  // name=value&..., no percent decoding
+  bool IsKeepAlive() const;
+};
+
+//===============================================================================================
+// HttpUtil(minimal server side http/1.x)
+//===============================================================================================
+class HttpUtil {
+public:
+  // return processed size(0: need more data, -1: request over maxSize)
+  static int ParseRequest(std::span<const uint8_t> data, HttpRequest &request, size_t maxSize);
+
+  // contentLength < 0 : close delimited body
+  static std::string MakeResponseHeader(int statusCode, std::string_view contentType, int64_t contentLength,
+                                        bool isKeepAlive);
+  static const char *GetStatusText(int statusCode);
+  static bool IsEqualNoCase(std::string_view left, std::string_view right);
+};
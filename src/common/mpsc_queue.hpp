@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+//====================================================================================================
+// MpscQueue(multi producer, single consumer, lock free)
+//  - Push : one atomic exchange, never blocks(any thread)
+//  - Pop : consumer thread only, a push in progress can be seen one Pop later
+//====================================================================================================
+template <typename T> class MpscQueue {
+public:
+  MpscQueue() : _head(new Node()), _tail(_head.load()) {}
+
+  ~MpscQueue() {
+    T value;
+    while (Pop(value)) {
+    }
+    delete _tail;
+  }
+
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue &operator=(const MpscQueue &) = delete;
+
+  void Push(T value) {
+    auto *node = new Node(std::move(value));
+    auto *prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  bool Pop(T &value) {
+    auto *next = _tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+
+    value = std::move(next->value);
+    delete _tail;
+    _tail = next;
+    return true;
+  }
+
+private:
+  struct Node {
+    Node() = default;
+    explicit Node(T value_) : value(std::move(value_)) {}
+
+    std::atomic<Node *> next{nullptr};
+    T value{};
+  };
+
+  std::atomic<Node *> _head; // producer side(last pushed)
+  Node *_tail;               // consumer side(stub, value already taken)
+};
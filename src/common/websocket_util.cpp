@@ -0,0 +1,122 @@
+#include "websocket_util.h"
+#include "buffer_pool.h"
+#include "common_function.h"
+#include <cstring>
+
+//===============================================================================================
+// Get frame header size
+//===============================================================================================
+size_t WebSocketUtil::GetFrameHeaderSize(uint64_t payloadSize) {
+  if (payloadSize < 126) {
+    return 2;
+  }
+  return payloadSize <= 0xffff ? 4 : 10;
+}
+
+//===============================================================================================
+// Write frame header
+//  - FIN(1) RSV(3) Opcode(4) | MASK(1) Length(7) [Extended length(16/64)]
+//===============================================================================================
+size_t WebSocketUtil::WriteFrameHeader(uint8_t *output, WebSocketOpcode opcode, uint64_t payloadSize) {
+  output[0] = 0x80 | static_cast<uint8_t>(opcode);
+
+  if (payloadSize < 126) {
+    output[1] = static_cast<uint8_t>(payloadSize);
+    return 2;
+  }
+
+  if (payloadSize <= 0xffff) {
+    output[1] = 126;
+    output[2] = static_cast<uint8_t>(payloadSize >> 8);
+    output[3] = static_cast<uint8_t>(payloadSize);
+    return 4;
+  }
+
+  output[1] = 127;
+  for (int index = 0; index < 8; ++index) {
+    output[2 + index] = static_cast<uint8_t>(payloadSize >> ((7 - index) * 8));
+  }
+  return 10;
+}
+
+//===============================================================================================
+// Make frame(header + payload in one buffer)
+//===============================================================================================
+std::shared_ptr<std::vector<uint8_t>> WebSocketUtil::MakeFrame(WebSocketOpcode opcode, const uint8_t *data,
+                                                               size_t dataSize) {
+  auto frame = BufferPool::Alloc(GetFrameHeaderSize(dataSize) + dataSize);
+  auto headerSize = WriteFrameHeader(frame->data(), opcode, dataSize);
+
+  if (dataSize != 0) {
+    std::memcpy(frame->data() + headerSize, data, dataSize);
+  }
+
+  return frame;
+}
+
+//===============================================================================================
+// Parse client frame
+//  - client frame must be masked
+//===============================================================================================
+int WebSocketUtil::ParseFrame(std::span<const uint8_t> data, WebSocketFrame &frame, size_t maxPayloadSize) {
+  if (data.size() < 2) {
+    return 0;
+  }
+
+  if ((data[1] & 0x80) == 0) {
+    return -1; // not masked
+  }
+
+  size_t headerSize = 2;
+  uint64_t payloadSize = data[1] & 0x7f;
+
+  if (payloadSize == 126) {
+    headerSize += 2;
+  } else if (payloadSize == 127) {
+    headerSize += 8;
+  }
+
+  if (data.size() < headerSize + 4) {
+    return 0;
+  }
+
+  if (payloadSize >= 126) {
+    payloadSize = 0;
+    for (size_t index = 2; index < headerSize; ++index) {
+      payloadSize = (payloadSize << 8) | data[index];
+    }
+  }
+
+  if (payloadSize > maxPayloadSize) {
+    return -1;
+  }
+
+  const auto *mask = data.data() + headerSize;
+  headerSize += 4;
+
+  if (data.size() < headerSize + payloadSize) {
+    return 0;
+  }
+
+  frame.isFin = (data[0] & 0x80) != 0;
+  frame.opcode = static_cast<WebSocketOpcode>(data[0] & 0x0f);
+  frame.payload.resize(payloadSize);
+  for (size_t index = 0; index < payloadSize; ++index) {
+    frame.payload[index] = data[headerSize + index] ^ mask[index % 4];
+  }
+
+  return static_cast<int>(headerSize + payloadSize);
+}
+
+//===============================================================================================
+// Make accept key(base64(sha1(key + guid)))
+//===============================================================================================
+std::string WebSocketUtil::MakeAcceptKey(const std::string &key) {
+  if (key.empty() || key.size() > MaxKeySize) {
+    return "";
+  }
+
+  auto text = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  auto digest = Sha1(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+  return Base64Encode(digest.data(), digest.size());
+}
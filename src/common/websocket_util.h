@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class WebSocketOpcode : uint8_t {
+  Continuation = 0x0,
+  Text = 0x1,
+  Binary = 0x2,
+  Close = 0x8,
+  Ping = 0x9,
+  Pong = 0xa,
+};
+
+struct WebSocketFrame {
+  bool isFin = false;
+  WebSocketOpcode opcode = WebSocketOpcode::Continuation;
+  std::vector<uint8_t> payload; // unmasked
+};
+
+//===============================================================================================
+// WebSocketUtil(RFC 6455 server side)
+//  - server frame is not masked, the same frame bytes can be sent to every client
+//===============================================================================================
+class WebSocketUtil {
+public:
+  static constexpr size_t MaxFrameHeaderSize = 10;
+  static constexpr size_t MaxControlPayloadSize = 125;
+  static constexpr size_t MaxKeySize = 24; // base64 of a 16 byte nonce
+
+  static size_t GetFrameHeaderSize(uint64_t payloadSize);
+  static size_t WriteFrameHeader(uint8_t *output, WebSocketOpcode opcode, uint64_t payloadSize); // return written size
+  static std::shared_ptr<std::vector<uint8_t>> MakeFrame(WebSocketOpcode opcode, const uint8_t *data, size_t dataSize);
+
+  // client frame : return processed size(0: need more data, -1: error)
+  static int ParseFrame(std::span<const uint8_t> data, WebSocketFrame &frame, size_t maxPayloadSize);
+
+  // Sec-WebSocket-Key -> Sec-WebSocket-Accept(empty: invalid key)
+  static std::string MakeAcceptKey(const std::string &key);
+};
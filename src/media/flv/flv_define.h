@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+namespace Flv {
+
+// HEADER
+constexpr int HeaderSize = 9;
+constexpr int HeaderVersion = 0x01;
+constexpr int HeaderAudioFlag = 0x04;
+constexpr int HeaderVideoFlag = 0x01;
+
+// TAG
+constexpr int TagHeaderSize = 11;
+constexpr int PreviousTagSize = 4;
+constexpr int MaxMetaDataSize = 64 * 1024; // script tag body(publisher onMetaData)
+
+enum class TagType : uint8_t {
+  Audio = 8,
+  Video = 9,
+  Script = 18,
+};
+
+} // namespace Flv
@@ -0,0 +1,337 @@
+#include "flv_file.h"
+#include "common/common_header.h"
+#include "media/rtmp/rtmp_mux_util.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char IndexMagic[4] = {'F', 'L', 'V', 'I'};
+constexpr uint32_t IndexVersion = 1;
+constexpr size_t IndexHeaderSize = 4 + 4 + 8 + 8 + 4 + 4 + 4; // magic, version, size, mtime, start, end, count
+constexpr size_t IndexEntrySize = 4 + 8;                      // timestamp, offset
+constexpr uint32_t IndexInterval = 1000;                       // ms(audio only file)
+constexpr int HeaderTagScanMax = 16;
+
+//====================================================================================================
+// Destructor
+//====================================================================================================
+FlvFile::~FlvFile() {
+  if (_map != nullptr) {
+    munmap(const_cast<uint8_t *>(_map), _fileSize);
+  }
+
+  if (_fd >= 0) {
+    close(_fd);
+  }
+}
+
+//====================================================================================================
+// Open
+//  - map + header tags + key frame index(sidecar or scan)
+//====================================================================================================
+bool FlvFile::Open(const std::string &filePath) {
+  _filePath = filePath;
+
+  _fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (_fd < 0) {
+    return false;
+  }
+
+  struct stat fileStat {};
+  if (fstat(_fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) ||
+      fileStat.st_size < static_cast<off_t>(Flv::HeaderSize + Flv::PreviousTagSize)) {
+    LOG_WARN("Flv file - not a flv file - file(%s)", filePath.c_str());
+    return false;
+  }
+
+  _fileSize = static_cast<uint64_t>(fileStat.st_size);
+  _modifyTime = static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+
+  auto *map = mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED, _fd, 0);
+  if (map == MAP_FAILED) {
+    LOG_ERROR("Flv file - mmap fail - file(%s) error(%d)", filePath.c_str(), errno);
+    return false;
+  }
+  _map = static_cast<const uint8_t *>(map);
+
+  if (_map[0] != 'F' || _map[1] != 'L' || _map[2] != 'V') {
+    LOG_WARN("Flv file - signature fail - file(%s)", filePath.c_str());
+    return false;
+  }
+
+  _firstTagOffset = RtmpMuxUtil::ReadInt32(_map + 5) + Flv::PreviousTagSize;
+  ReadHeaderTags();
+
+  if (!LoadIndex()) {
+    BuildIndex();
+
+    if (!SaveIndex()) {
+      LOG_WARN("Flv file - index save fail(scan on every open) - file(%s)", filePath.c_str());
+    }
+  }
+
+  LOG_INFO("Flv file open - file(%s) size(%" PRIu64 ") time(%u~%u) key(%zu)", filePath.c_str(), _fileSize,
+           _startTimestamp, _endTimestamp, _keyFrames.size());
+  return true;
+}
+
+//====================================================================================================
+// Is modified
+//====================================================================================================
+bool FlvFile::IsModified() const {
+  struct stat fileStat {};
+  if (stat(_filePath.c_str(), &fileStat) != 0) {
+    return true;
+  }
+
+  return static_cast<uint64_t>(fileStat.st_size) != _fileSize ||
+         static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec != _modifyTime;
+}
+
+//====================================================================================================
+// Read tag
+//  - false : end of file(or truncated tag)
+//====================================================================================================
+bool FlvFile::ReadTag(uint64_t offset, Tag &tag) const {
+  if (offset + Flv::TagHeaderSize > _fileSize) {
+    return false;
+  }
+
+  const auto *header = _map + offset;
+  const auto dataSize = RtmpMuxUtil::ReadInt24(header + 1);
+
+  if (offset + Flv::TagHeaderSize + dataSize > _fileSize) {
+    return false;
+  }
+
+  tag.type = static_cast<Flv::TagType>(header[0] & 0x1f);
+  tag.timestamp = RtmpMuxUtil::ReadInt24(header + 4) | (static_cast<uint32_t>(header[7]) << 24);
+  tag.data = header + Flv::TagHeaderSize;
+  tag.size = dataSize;
+  tag.nextOffset = offset + Flv::TagHeaderSize + dataSize + Flv::PreviousTagSize;
+  return true;
+}
+
+//====================================================================================================
+// Seek
+//  - binary search on the key frame index, before the first key frame : first tag
+//====================================================================================================
+uint64_t FlvFile::Seek(uint32_t timestamp) const {
+  auto it = std::upper_bound(_keyFrames.begin(), _keyFrames.end(), timestamp,
+                             [](uint32_t value, const KeyFrame &keyFrame) { return value < keyFrame.timestamp; });
+
+  if (it == _keyFrames.begin()) {
+    return _keyFrames.empty() ? _firstTagOffset : _keyFrames.front().offset;
+  }
+
+  return std::prev(it)->offset;
+}
+
+//====================================================================================================
+// Prefetch
+//  - page cache read ahead, a page fault on the network thread is a blocking disk read
+//====================================================================================================
+void FlvFile::Prefetch(uint64_t offset, size_t size) const {
+  if (offset >= _fileSize) {
+    return;
+  }
+
+  static const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+  const auto start = offset / pageSize * pageSize;
+  const auto end = std::min<uint64_t>(offset + size, _fileSize);
+
+  madvise(const_cast<uint8_t *>(_map) + start, end - start, MADV_WILLNEED);
+}
+
+//====================================================================================================
+// Sequence header check(avc/hevc, enhanced hvc1/av01, aac)
+//  - enhanced : IsExHeader(1) FrameType(3) PacketType(4), SequenceStart = 0
+//====================================================================================================
+bool FlvFile::IsSequenceHeader(Flv::TagType type, const uint8_t *data, size_t size) {
+  if (size < 2) {
+    return false;
+  }
+
+  if (type == Flv::TagType::Video) {
+    if (data[0] & 0x80) {
+      return (data[0] & 0x0f) == 0;
+    }
+
+    const auto codecId = data[0] & 0x0f;
+    return (codecId == 7 || codecId == 12) && data[1] == 0;
+  }
+
+  return type == Flv::TagType::Audio && (data[0] >> 4) == 10 && data[1] == 0;
+}
+
+//====================================================================================================
+// Key frame check
+//====================================================================================================
+bool FlvFile::IsKeyFrame(Flv::TagType type, const uint8_t *data, size_t size) {
+  return type == Flv::TagType::Video && size > 0 && ((data[0] >> 4) & 0x07) == 1 && !IsSequenceHeader(type, data, size);
+}
+
+//====================================================================================================
+// Read header tags
+//  - sequence headers before the first frame, sent again after a seek
+//====================================================================================================
+void FlvFile::ReadHeaderTags() {
+  Tag tag;
+  auto offset = _firstTagOffset;
+
+  for (int index = 0; index < HeaderTagScanMax && ReadTag(offset, tag); index++) {
+    if (tag.type != Flv::TagType::Script) {
+      if (!IsSequenceHeader(tag.type, tag.data, tag.size)) {
+        break;
+      }
+      _sequenceHeaders.push_back(tag);
+    }
+    offset = tag.nextOffset;
+  }
+}
+
+//====================================================================================================
+// Build index
+//  - one pass over the tag headers
+//====================================================================================================
+void FlvFile::BuildIndex() {
+  Tag tag;
+  bool isVideo = false;
+  bool isStart = false;
+  uint64_t offset = _firstTagOffset;
+
+  _keyFrames.clear();
+
+  for (; ReadTag(offset, tag); offset = tag.nextOffset) {
+    if (tag.type == Flv::TagType::Script || IsSequenceHeader(tag.type, tag.data, tag.size)) {
+      continue;
+    }
+
+    if (!isStart) {
+      isStart = true;
+      _startTimestamp = tag.timestamp;
+    }
+    _endTimestamp = std::max(_endTimestamp, tag.timestamp);
+
+    if (tag.type == Flv::TagType::Video) {
+      if (!isVideo) {
+        isVideo = true;
+        _keyFrames.clear(); // audio entries before the first video
+      }
+
+      if (IsKeyFrame(tag.type, tag.data, tag.size)) {
+        _keyFrames.push_back({tag.timestamp, offset});
+      }
+    } else if (!isVideo && tag.type == Flv::TagType::Audio &&
+               (_keyFrames.empty() || tag.timestamp >= _keyFrames.back().timestamp + IndexInterval)) {
+      _keyFrames.push_back({tag.timestamp, offset});
+    }
+  }
+
+  if (offset < _fileSize) {
+    LOG_WARN("Flv file - truncated tag - file(%s) offset(%" PRIu64 ") size(%" PRIu64 ")", _filePath.c_str(), offset,
+             _fileSize);
+  }
+}
+
+//====================================================================================================
+// Load index(sidecar)
+//====================================================================================================
+bool FlvFile::LoadIndex() {
+  auto fd = open((_filePath + ".idx").c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  std::vector<uint8_t> data;
+  struct stat fileStat {};
+  if (fstat(fd, &fileStat) == 0 && fileStat.st_size >= static_cast<off_t>(IndexHeaderSize)) {
+    data.resize(fileStat.st_size);
+    if (pread(fd, data.data(), data.size(), 0) != static_cast<ssize_t>(data.size())) {
+      data.clear();
+    }
+  }
+  close(fd);
+
+  if (data.empty() || std::memcmp(data.data(), IndexMagic, sizeof(IndexMagic)) != 0) {
+    return false;
+  }
+
+  uint32_t version, count;
+  uint64_t fileSize;
+  int64_t modifyTime;
+  const auto *read = data.data() + sizeof(IndexMagic);
+
+  std::memcpy(&version, read, 4);
+  std::memcpy(&fileSize, read + 4, 8);
+  std::memcpy(&modifyTime, read + 12, 8);
+  std::memcpy(&_startTimestamp, read + 20, 4);
+  std::memcpy(&_endTimestamp, read + 24, 4);
+  std::memcpy(&count, read + 28, 4);
+
+  if (version != IndexVersion || fileSize != _fileSize || modifyTime != _modifyTime ||
+      data.size() != IndexHeaderSize + static_cast<size_t>(count) * IndexEntrySize) {
+    _startTimestamp = _endTimestamp = 0;
+    return false;
+  }
+
+  _keyFrames.resize(count);
+  read = data.data() + IndexHeaderSize;
+  for (auto &keyFrame : _keyFrames) {
+    std::memcpy(&keyFrame.timestamp, read, 4);
+    std::memcpy(&keyFrame.offset, read + 4, 8);
+    read += IndexEntrySize;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Save index(sidecar)
+//  - temp file + rename, a concurrent open never sees a partial index
+//====================================================================================================
+bool FlvFile::SaveIndex() const {
+  std::vector<uint8_t> data(IndexHeaderSize + _keyFrames.size() * IndexEntrySize);
+  auto *output = data.data();
+  const auto count = static_cast<uint32_t>(_keyFrames.size());
+
+  std::memcpy(output, IndexMagic, sizeof(IndexMagic));
+  output += sizeof(IndexMagic);
+  std::memcpy(output, &IndexVersion, 4);
+  std::memcpy(output + 4, &_fileSize, 8);
+  std::memcpy(output + 12, &_modifyTime, 8);
+  std::memcpy(output + 20, &_startTimestamp, 4);
+  std::memcpy(output + 24, &_endTimestamp, 4);
+  std::memcpy(output + 28, &count, 4);
+
+  output = data.data() + IndexHeaderSize;
+  for (const auto &keyFrame : _keyFrames) {
+    std::memcpy(output, &keyFrame.timestamp, 4);
+    std::memcpy(output + 4, &keyFrame.offset, 8);
+    output += IndexEntrySize;
+  }
+
+  static std::atomic<uint32_t> tempIndex{0};
+  const auto indexPath = _filePath + ".idx";
+  const auto tempPath = StringHelper::Format("%s.%d.%u.tmp", indexPath.c_str(), getpid(), tempIndex++);
+
+  auto fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  bool result = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+  close(fd);
+
+  if (!result || rename(tempPath.c_str(), indexPath.c_str()) != 0) {
+    unlink(tempPath.c_str());
+    return false;
+  }
+
+  return true;
+}
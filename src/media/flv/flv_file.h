@@ -0,0 +1,70 @@
+#pragma once
+#include "flv_define.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+//====================================================================================================
+// FlvFile(read only, mmap)
+//  - the whole file is mapped once and shared by every reader, tags are read in place(no read/copy)
+//  - key frame index is loaded from the sidecar({file}.idx) or built by one tag scan and saved
+//  - sidecar is valid only for the same file size/mtime
+//====================================================================================================
+class FlvFile : public std::enable_shared_from_this<FlvFile> {
+public:
+  struct Tag {
+    Flv::TagType type;
+    uint32_t timestamp; // ms
+    const uint8_t *data; // tag body(in the mapping)
+    size_t size;
+    uint64_t nextOffset;
+  };
+
+  struct KeyFrame {
+    uint32_t timestamp; // ms
+    uint64_t offset;    // tag offset in the file
+  };
+
+  FlvFile() = default;
+  ~FlvFile();
+
+  FlvFile(const FlvFile &) = delete;
+  FlvFile &operator=(const FlvFile &) = delete;
+
+  bool Open(const std::string &filePath);
+  bool IsModified() const; // file size/mtime changed after open
+
+  bool ReadTag(uint64_t offset, Tag &tag) const;
+  uint64_t GetFirstTagOffset() const { return _firstTagOffset; }
+  const std::vector<Tag> &GetSequenceHeaders() const { return _sequenceHeaders; }
+  uint64_t Seek(uint32_t timestamp) const; // offset of the last key frame at or before timestamp
+  uint32_t GetStartTimestamp() const { return _startTimestamp; }
+  uint32_t GetEndTimestamp() const { return _endTimestamp; }
+  const std::string &GetFilePath() const { return _filePath; }
+
+  // keeps the mapping alive while the data is queued for send
+  std::shared_ptr<const uint8_t> GetData(const uint8_t *data) { return {shared_from_this(), data}; }
+  void Prefetch(uint64_t offset, size_t size) const; // read ahead(page cache), no wait
+
+  static bool IsSequenceHeader(Flv::TagType type, const uint8_t *data, size_t size);
+  static bool IsKeyFrame(Flv::TagType type, const uint8_t *data, size_t size);
+
+private:
+  void ReadHeaderTags();
+  void BuildIndex();
+  bool LoadIndex();
+  bool SaveIndex() const;
+
+  std::string _filePath;
+  int _fd = -1;
+  const uint8_t *_map = nullptr;
+  uint64_t _fileSize = 0;
+  int64_t _modifyTime = 0; // ns
+
+  uint64_t _firstTagOffset = 0;
+  std::vector<Tag> _sequenceHeaders; // video/audio sequence header tags before the first frame
+  std::vector<KeyFrame> _keyFrames;   // audio only : one entry per IndexInterval
+  uint32_t _startTimestamp = 0;
+  uint32_t _endTimestamp = 0;
+};
@@ -0,0 +1,121 @@
+#include "flv_mux_util.h"
+#include "common/buffer_pool.h"
+#include "common/websocket_util.h"
+#include "media/rtmp/rtmp_define.h"
+#include "media/rtmp/rtmp_mux_util.h"
+#include <cstring>
+
+//====================================================================================================
+// Make flv header
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> FlvMuxUtil::MakeFlvHeader(bool isAudio, bool isVideo) {
+  auto header = std::make_shared<std::vector<uint8_t>>(Flv::HeaderSize + Flv::PreviousTagSize, 0);
+  auto *output = header->data();
+
+  output[0] = 'F';
+  output[1] = 'L';
+  output[2] = 'V';
+  output[3] = Flv::HeaderVersion;
+  output[4] = (isAudio ? Flv::HeaderAudioFlag : 0) | (isVideo ? Flv::HeaderVideoFlag : 0);
+  RtmpMuxUtil::WriteInt32(output + 5, Flv::HeaderSize);
+  // previous tag size 0
+
+  return header;
+}
+
+//====================================================================================================
+// Write flv tag
+//  - Type(1) DataSize(3) Timestamp(3) TimestampExtended(1) StreamID(3) Data PreviousTagSize(4)
+//====================================================================================================
+size_t FlvMuxUtil::WriteFlvTag(uint8_t *output, Flv::TagType type, uint32_t timestamp, const uint8_t *data,
+                               size_t dataSize) {
+  auto *start = output;
+
+  output += RtmpMuxUtil::WriteInt8(output, static_cast<uint8_t>(type));
+  output += RtmpMuxUtil::WriteInt24(output, static_cast<int>(dataSize));
+  output += RtmpMuxUtil::WriteInt24(output, static_cast<int>(timestamp & 0xffffff));
+  output += RtmpMuxUtil::WriteInt8(output, static_cast<uint8_t>(timestamp >> 24));
+  output += RtmpMuxUtil::WriteInt24(output, 0);
+
+  std::memcpy(output, data, dataSize);
+  output += dataSize;
+
+  output += RtmpMuxUtil::WriteInt32(output, static_cast<int>(Flv::TagHeaderSize + dataSize));
+
+  return output - start;
+}
+
+//====================================================================================================
+// Make flv tag
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> FlvMuxUtil::MakeFlvTag(Flv::TagType type, uint32_t timestamp,
+                                                             const uint8_t *data, size_t dataSize) {
+  if (data == nullptr || dataSize == 0 || dataSize > 0xffffff) {
+    return nullptr;
+  }
+
+  auto tag = BufferPool::Alloc(GetFlvTagSize(dataSize));
+  WriteFlvTag(tag->data(), type, timestamp, data, dataSize);
+
+  return tag;
+}
+
+//====================================================================================================
+// Make websocket flv tag
+//  - websocket frame header + flv tag in one buffer
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> FlvMuxUtil::MakeWsFlvTag(Flv::TagType type, uint32_t timestamp,
+                                                               const uint8_t *data, size_t dataSize) {
+  if (data == nullptr || dataSize == 0 || dataSize > 0xffffff) {
+    return nullptr;
+  }
+
+  auto tagSize = GetFlvTagSize(dataSize);
+  auto message = BufferPool::Alloc(WebSocketUtil::GetFrameHeaderSize(tagSize) + tagSize);
+
+  auto headerSize = WebSocketUtil::WriteFrameHeader(message->data(), WebSocketOpcode::Binary, tagSize);
+  WriteFlvTag(message->data() + headerSize, type, timestamp, data, dataSize);
+
+  return message;
+}
+
+//====================================================================================================
+// Make meta data tag
+//  - studio meta data : @setDataFrame, onMetaData, object
+//  - body is sized from the encoded size(publisher data), over Flv::MaxMetaDataSize : nullptr
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> FlvMuxUtil::MakeMetaDataTag(const std::shared_ptr<AmfDoc> &doc) {
+  if (doc == nullptr) {
+    return nullptr;
+  }
+
+  auto isSetDataFrame = [](const std::shared_ptr<AmfProperty> &property) {
+    return property->GetType() == AmfDataType::String && property->GetString() != nullptr &&
+           Rtmp::Cmd::SetDataFrame == property->GetString();
+  };
+
+  size_t bodySize = 0;
+  for (int index = 0; index < doc->GetPropertyCount(); ++index) {
+    auto property = doc->GetProp(index);
+    if (!isSetDataFrame(property)) {
+      bodySize += property->GetEncodeSize();
+    }
+  }
+
+  if (bodySize == 0 || bodySize > Flv::MaxMetaDataSize) {
+    LOG_WARN("Flv meta data size fail - size(%zu:%d)", bodySize, Flv::MaxMetaDataSize);
+    return nullptr;
+  }
+
+  auto body = BufferPool::Alloc(bodySize);
+  auto *output = body->data();
+
+  for (int index = 0; index < doc->GetPropertyCount(); ++index) {
+    auto property = doc->GetProp(index);
+    if (!isSetDataFrame(property)) {
+      output += property->Encode(output);
+    }
+  }
+
+  return MakeFlvTag(Flv::TagType::Script, 0, body->data(), output - body->data());
+}
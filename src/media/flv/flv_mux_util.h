@@ -0,0 +1,26 @@
+#pragma once
+#include "flv_define.h"
+#include "media/rtmp/amf_document.h"
+#include <memory>
+#include <vector>
+
+//====================================================================================================
+// FlvMuxUtil
+//  - rtmp audio/video message body is the flv tag body(no conversion)
+//  - tag = tag header(11) + body + previous tag size(4)
+//====================================================================================================
+class FlvMuxUtil {
+public:
+  // flv header + previous tag size 0
+  static std::shared_ptr<std::vector<uint8_t>> MakeFlvHeader(bool isAudio, bool isVideo);
+  static std::shared_ptr<std::vector<uint8_t>> MakeFlvTag(Flv::TagType type, uint32_t timestamp, const uint8_t *data,
+                                                          size_t dataSize);
+  // websocket binary frame(one tag per message)
+  static std::shared_ptr<std::vector<uint8_t>> MakeWsFlvTag(Flv::TagType type, uint32_t timestamp, const uint8_t *data,
+                                                            size_t dataSize);
+  static size_t GetFlvTagSize(size_t dataSize) { return Flv::TagHeaderSize + dataSize + Flv::PreviousTagSize; }
+  static size_t WriteFlvTag(uint8_t *output, Flv::TagType type, uint32_t timestamp, const uint8_t *data,
+                            size_t dataSize); // return written size
+  // onMetaData script tag(@setDataFrame removed)
+  static std::shared_ptr<std::vector<uint8_t>> MakeMetaDataTag(const std::shared_ptr<AmfDoc> &doc);
+};
@@ -0,0 +1,458 @@
+#include "fmp4_muxer.h"
+#include "media/rtmp/rtmp_mux_util.h"
+#include <algorithm>
+#include <string_view>
+
+static constexpr uint32_t AacSampleRates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                              22050, 16000, 12000, 11025, 8000,  7350};
+static constexpr uint32_t Matrix[] = {0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000};
+
+// trun flags
+static constexpr uint32_t TrunDataOffset = 0x000001;
+static constexpr uint32_t TrunSampleDuration = 0x000100;
+static constexpr uint32_t TrunSampleSize = 0x000200;
+static constexpr uint32_t TrunSampleFlags = 0x000400;
+static constexpr uint32_t TrunCompositionTime = 0x000800;
+
+// sample flags
+static constexpr uint32_t SyncSampleFlags = 0x02000000;    // depends on no other
+static constexpr uint32_t NonSyncSampleFlags = 0x01010000; // depends on others, non sync
+
+//====================================================================================================
+// Box writer
+//====================================================================================================
+static void Write8(std::vector<uint8_t> &output, uint8_t value) { output.push_back(value); }
+
+static void Write16(std::vector<uint8_t> &output, uint16_t value) {
+  output.insert(output.end(), {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)});
+}
+
+static void Write24(std::vector<uint8_t> &output, uint32_t value) {
+  output.insert(output.end(),
+                {static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)});
+}
+
+static void Write32(std::vector<uint8_t> &output, uint32_t value) {
+  output.insert(output.end(), {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                               static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)});
+}
+
+static void Write64(std::vector<uint8_t> &output, uint64_t value) {
+  Write32(output, static_cast<uint32_t>(value >> 32));
+  Write32(output, static_cast<uint32_t>(value));
+}
+
+static void WriteZero(std::vector<uint8_t> &output, size_t size) { output.insert(output.end(), size, 0); }
+
+static void WriteType(std::vector<uint8_t> &output, const char *type) { output.insert(output.end(), type, type + 4); }
+
+static void Patch32(std::vector<uint8_t> &output, size_t position, uint32_t value) {
+  output[position] = static_cast<uint8_t>(value >> 24);
+  output[position + 1] = static_cast<uint8_t>(value >> 16);
+  output[position + 2] = static_cast<uint8_t>(value >> 8);
+  output[position + 3] = static_cast<uint8_t>(value);
+}
+
+// return : box start(size is written on EndBox)
+static size_t BeginBox(std::vector<uint8_t> &output, const char *type) {
+  auto position = output.size();
+  Write32(output, 0);
+  WriteType(output, type);
+  return position;
+}
+
+static size_t BeginFullBox(std::vector<uint8_t> &output, const char *type, uint8_t version, uint32_t flags) {
+  auto position = BeginBox(output, type);
+  Write8(output, version);
+  Write24(output, flags);
+  return position;
+}
+
+static void EndBox(std::vector<uint8_t> &output, size_t position) {
+  Patch32(output, position, static_cast<uint32_t>(output.size() - position));
+}
+
+// esds descriptor(tag + 1 byte size, config is a few byte)
+static void WriteDescriptor(std::vector<uint8_t> &output, uint8_t tag, size_t size) {
+  Write8(output, tag);
+  Write8(output, static_cast<uint8_t>(size));
+}
+
+//====================================================================================================
+// Init
+//  - video : Control(1) Type(1) CompositionTime(3) AVCDecoderConfigurationRecord
+//  - audio : Control(1) Type(1) AudioSpecificConfig(objectType(5) sampleIndex(4) channelConfig(4) ...)
+//====================================================================================================
+bool Fmp4Muxer::Init(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (mediaInfo == nullptr) {
+    return false;
+  }
+
+  _isVideo = false;
+  if (const auto &seqHeader = mediaInfo->videoSeqHeader; seqHeader != nullptr) {
+    const auto &data = *seqHeader;
+    if (data.size() >= 11 && (data[0] & 0x0f) == 7 && data[1] == 0) {
+      _avcConfig.assign(data.begin() + 5, data.end());
+      _width = mediaInfo->video ? mediaInfo->video->width : 0;
+      _height = mediaInfo->video ? mediaInfo->video->height : 0;
+      if ((_width == 0 || _height == 0) && mediaInfo->metaInfo != nullptr) {
+        _width = mediaInfo->metaInfo->videoWidth;
+        _height = mediaInfo->metaInfo->videoHeight;
+      }
+      _isVideo = true;
+    }
+  }
+
+  _isAudio = false;
+  if (const auto &seqHeader = mediaInfo->audioSeqHeader; seqHeader != nullptr) {
+    const auto &data = *seqHeader;
+    if (data.size() >= 4 && (data[0] >> 4) == 10 && data[1] == 0 && data.size() - 2 < 0x80) {
+      _audioConfig.assign(data.begin() + 2, data.end());
+
+      auto sampleIndex = ((data[2] & 0x07) << 1) | (data[3] >> 7);
+      _sampleRate = sampleIndex < static_cast<int>(std::size(AacSampleRates)) ? AacSampleRates[sampleIndex] : 44100;
+      _channels = std::max((data[3] >> 3) & 0x0f, 1);
+      _isAudio = true;
+    }
+  }
+
+  return _isVideo || _isAudio;
+}
+
+//====================================================================================================
+// Make video sample
+//  - Control(1) Type(1) CompositionTime(3) [NalLength(n) Nal]*
+//====================================================================================================
+bool Fmp4Muxer::MakeVideoSample(const std::shared_ptr<std::vector<uint8_t>> &data, uint64_t timestamp,
+                                Fmp4::Sample &sample) {
+  if (data == nullptr || data->size() <= 5 || ((*data)[0] & 0x0f) != 7 || (*data)[1] != 1) {
+    return false;
+  }
+
+  int32_t compositionTime = static_cast<int32_t>(RtmpMuxUtil::ReadInt24(data->data() + 2));
+  if (compositionTime & 0x800000) {
+    compositionTime |= static_cast<int32_t>(0xff000000);
+  }
+
+  sample = {data, 5, static_cast<uint32_t>(data->size() - 5), timestamp, 0, compositionTime, ((*data)[0] >> 4) == 1};
+  return true;
+}
+
+//====================================================================================================
+// Make audio sample
+//  - Control(1) Type(1) Raw AAC
+//====================================================================================================
+bool Fmp4Muxer::MakeAudioSample(const std::shared_ptr<std::vector<uint8_t>> &data, uint64_t timestamp,
+                                Fmp4::Sample &sample) {
+  if (data == nullptr || data->size() <= 2 || ((*data)[0] >> 4) != 10 || (*data)[1] != 1) {
+    return false;
+  }
+
+  sample = {data, 2, static_cast<uint32_t>(data->size() - 2), timestamp, 0, 0, true};
+  return true;
+}
+
+//====================================================================================================
+// Make init segment
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> Fmp4Muxer::MakeInitSegment() const {
+  auto output = std::make_shared<std::vector<uint8_t>>();
+  output->reserve(1024 + _avcConfig.size());
+
+  auto ftyp = BeginBox(*output, "ftyp");
+  WriteType(*output, "iso6");
+  Write32(*output, 0);
+  for (const auto *brand : {"iso6", "cmfc", "mp41"}) {
+    WriteType(*output, brand);
+  }
+  EndBox(*output, ftyp);
+
+  auto moov = BeginBox(*output, "moov");
+
+  auto mvhd = BeginFullBox(*output, "mvhd", 0, 0);
+  Write32(*output, 0); // creation time
+  Write32(*output, 0); // modification time
+  Write32(*output, Fmp4::Timescale);
+  Write32(*output, 0);          // duration
+  Write32(*output, 0x00010000); // rate
+  Write16(*output, 0x0100);     // volume
+  WriteZero(*output, 10);
+  for (auto value : Matrix) {
+    Write32(*output, value);
+  }
+  WriteZero(*output, 24);
+  Write32(*output, Fmp4::AudioTrackId + 1); // next track id
+  EndBox(*output, mvhd);
+
+  if (_isVideo) {
+    WriteVideoTrack(*output);
+  }
+  if (_isAudio) {
+    WriteAudioTrack(*output);
+  }
+
+  auto mvex = BeginBox(*output, "mvex");
+  for (auto trackId : {Fmp4::VideoTrackId, Fmp4::AudioTrackId}) {
+    if ((trackId == Fmp4::VideoTrackId && !_isVideo) || (trackId == Fmp4::AudioTrackId && !_isAudio)) {
+      continue;
+    }
+
+    auto trex = BeginFullBox(*output, "trex", 0, 0);
+    Write32(*output, trackId);
+    Write32(*output, 1); // sample description index
+    Write32(*output, 0); // default duration
+    Write32(*output, 0); // default size
+    Write32(*output, 0); // default flags
+    EndBox(*output, trex);
+  }
+  EndBox(*output, mvex);
+
+  EndBox(*output, moov);
+  return output;
+}
+
+//====================================================================================================
+// Write track(trak)
+//====================================================================================================
+static void WriteTrackHeader(std::vector<uint8_t> &output, uint32_t trackId, bool isAudio, uint32_t width,
+                             uint32_t height) {
+  auto tkhd = BeginFullBox(output, "tkhd", 0, 0x000003); // enabled, in movie
+  Write32(output, 0);                                   // creation time
+  Write32(output, 0);                                   // modification time
+  Write32(output, trackId);
+  Write32(output, 0); // reserved
+  Write32(output, 0); // duration
+  WriteZero(output, 8);
+  Write16(output, 0); // layer
+  Write16(output, 0); // alternate group
+  Write16(output, isAudio ? 0x0100 : 0);
+  Write16(output, 0);
+  for (auto value : Matrix) {
+    Write32(output, value);
+  }
+  Write32(output, width << 16);
+  Write32(output, height << 16);
+  EndBox(output, tkhd);
+}
+
+static void WriteMediaHeader(std::vector<uint8_t> &output, const char *handlerType, const char *handlerName) {
+  auto mdhd = BeginFullBox(output, "mdhd", 0, 0);
+  Write32(output, 0); // creation time
+  Write32(output, 0); // modification time
+  Write32(output, Fmp4::Timescale);
+  Write32(output, 0);      // duration
+  Write16(output, 0x55c4); // language(und)
+  Write16(output, 0);
+  EndBox(output, mdhd);
+
+  auto hdlr = BeginFullBox(output, "hdlr", 0, 0);
+  Write32(output, 0);
+  WriteType(output, handlerType);
+  WriteZero(output, 12);
+  output.insert(output.end(), handlerName, handlerName + std::char_traits<char>::length(handlerName) + 1);
+  EndBox(output, hdlr);
+}
+
+// dinf(self contained)
+static void WriteDataInformation(std::vector<uint8_t> &output) {
+  auto dinf = BeginBox(output, "dinf");
+  auto dref = BeginFullBox(output, "dref", 0, 0);
+  Write32(output, 1);
+  EndBox(output, BeginFullBox(output, "url ", 0, 0x000001));
+  EndBox(output, dref);
+  EndBox(output, dinf);
+}
+
+// stts/stsc/stsz/stco without entry(samples are in the fragments)
+static void WriteEmptySampleTables(std::vector<uint8_t> &output) {
+  for (const auto *type : {"stts", "stsc", "stsz", "stco"}) {
+    auto box = BeginFullBox(output, type, 0, 0);
+    if (type == std::string_view("stsz")) {
+      Write32(output, 0); // sample size
+    }
+    Write32(output, 0); // entry count
+    EndBox(output, box);
+  }
+}
+
+void Fmp4Muxer::WriteVideoTrack(std::vector<uint8_t> &output) const {
+  auto trak = BeginBox(output, "trak");
+  WriteTrackHeader(output, Fmp4::VideoTrackId, false, _width, _height);
+
+  auto mdia = BeginBox(output, "mdia");
+  WriteMediaHeader(output, "vide", "VideoHandler");
+
+  auto minf = BeginBox(output, "minf");
+  auto vmhd = BeginFullBox(output, "vmhd", 0, 0x000001);
+  WriteZero(output, 8); // graphics mode, op color
+  EndBox(output, vmhd);
+  WriteDataInformation(output);
+
+  auto stbl = BeginBox(output, "stbl");
+  auto stsd = BeginFullBox(output, "stsd", 0, 0);
+  Write32(output, 1);
+
+  auto avc1 = BeginBox(output, "avc1");
+  WriteZero(output, 6);
+  Write16(output, 1); // data reference index
+  WriteZero(output, 16);
+  Write16(output, static_cast<uint16_t>(_width));
+  Write16(output, static_cast<uint16_t>(_height));
+  Write32(output, 0x00480000); // 72 dpi
+  Write32(output, 0x00480000);
+  Write32(output, 0);
+  Write16(output, 1);    // frame count
+  WriteZero(output, 32); // compressor name
+  Write16(output, 0x0018);
+  Write16(output, 0xffff);
+
+  auto avcC = BeginBox(output, "avcC");
+  output.insert(output.end(), _avcConfig.begin(), _avcConfig.end());
+  EndBox(output, avcC);
+
+  EndBox(output, avc1);
+  EndBox(output, stsd);
+  WriteEmptySampleTables(output);
+  EndBox(output, stbl);
+
+  EndBox(output, minf);
+  EndBox(output, mdia);
+  EndBox(output, trak);
+}
+
+void Fmp4Muxer::WriteAudioTrack(std::vector<uint8_t> &output) const {
+  auto trak = BeginBox(output, "trak");
+  WriteTrackHeader(output, Fmp4::AudioTrackId, true, 0, 0);
+
+  auto mdia = BeginBox(output, "mdia");
+  WriteMediaHeader(output, "soun", "SoundHandler");
+
+  auto minf = BeginBox(output, "minf");
+  auto smhd = BeginFullBox(output, "smhd", 0, 0);
+  Write32(output, 0); // balance, reserved
+  EndBox(output, smhd);
+  WriteDataInformation(output);
+
+  auto stbl = BeginBox(output, "stbl");
+  auto stsd = BeginFullBox(output, "stsd", 0, 0);
+  Write32(output, 1);
+
+  auto mp4a = BeginBox(output, "mp4a");
+  WriteZero(output, 6);
+  Write16(output, 1); // data reference index
+  WriteZero(output, 8);
+  Write16(output, _channels);
+  Write16(output, 16); // sample size
+  WriteZero(output, 4);
+  Write32(output, std::min<uint32_t>(_sampleRate, 0xffff) << 16);
+
+  // ES_Descriptor(3) [DecoderConfigDescriptor(4) [DecoderSpecificInfo(5)], SLConfigDescriptor(6)]
+  const auto specificSize = _audioConfig.size();
+  const auto decoderSize = 13 + 2 + specificSize;
+  const auto esSize = 3 + 2 + decoderSize + 2 + 1;
+
+  auto esds = BeginFullBox(output, "esds", 0, 0);
+  WriteDescriptor(output, 0x03, esSize);
+  Write16(output, Fmp4::AudioTrackId);
+  Write8(output, 0);
+  WriteDescriptor(output, 0x04, decoderSize);
+  Write8(output, 0x40); // mpeg-4 audio
+  Write8(output, 0x15); // audio stream
+  Write24(output, 0);   // buffer size
+  Write32(output, 0);   // max bitrate
+  Write32(output, 0);   // avg bitrate
+  WriteDescriptor(output, 0x05, specificSize);
+  output.insert(output.end(), _audioConfig.begin(), _audioConfig.end());
+  WriteDescriptor(output, 0x06, 1);
+  Write8(output, 0x02);
+  EndBox(output, esds);
+
+  EndBox(output, mp4a);
+  EndBox(output, stsd);
+  WriteEmptySampleTables(output);
+  EndBox(output, stbl);
+
+  EndBox(output, minf);
+  EndBox(output, mdia);
+  EndBox(output, trak);
+}
+
+//====================================================================================================
+// Make fragment header
+//  - moof [mfhd, traf(video), traf(audio)] + mdat header
+//  - trun data offset is from the moof start(default-base-is-moof)
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> Fmp4Muxer::MakeFragmentHeader(uint32_t sequence,
+                                                                    const std::vector<Fmp4::Sample> &videos,
+                                                                    const std::vector<Fmp4::Sample> &audios) const {
+  auto output = std::make_shared<std::vector<uint8_t>>();
+  output->reserve(128 + (videos.size() + audios.size()) * 16);
+
+  auto moof = BeginBox(*output, "moof");
+
+  auto mfhd = BeginFullBox(*output, "mfhd", 0, 0);
+  Write32(*output, sequence);
+  EndBox(*output, mfhd);
+
+  struct TrackRun {
+    size_t dataOffsetPosition;
+    uint64_t dataSize;
+  };
+  std::vector<TrackRun> runs;
+
+  for (const auto *samples : {&videos, &audios}) {
+    if (samples->empty()) {
+      continue;
+    }
+
+    const bool isVideo = samples == &videos;
+    uint32_t trunFlags = TrunDataOffset | TrunSampleDuration | TrunSampleSize;
+    if (isVideo) {
+      trunFlags |= TrunSampleFlags | TrunCompositionTime;
+    }
+
+    auto traf = BeginBox(*output, "traf");
+
+    auto tfhd = BeginFullBox(*output, "tfhd", 0, 0x020000); // default-base-is-moof
+    Write32(*output, isVideo ? Fmp4::VideoTrackId : Fmp4::AudioTrackId);
+    EndBox(*output, tfhd);
+
+    auto tfdt = BeginFullBox(*output, "tfdt", 1, 0);
+    Write64(*output, samples->front().timestamp);
+    EndBox(*output, tfdt);
+
+    // version 1 : signed composition time
+    auto trun = BeginFullBox(*output, "trun", isVideo ? 1 : 0, trunFlags);
+    Write32(*output, static_cast<uint32_t>(samples->size()));
+
+    TrackRun run{output->size(), 0};
+    Write32(*output, 0);
+
+    for (const auto &sample : *samples) {
+      Write32(*output, sample.duration);
+      Write32(*output, sample.size);
+      if (isVideo) {
+        Write32(*output, sample.isKey ? SyncSampleFlags : NonSyncSampleFlags);
+        Write32(*output, static_cast<uint32_t>(sample.compositionTime));
+      }
+      run.dataSize += sample.size;
+    }
+    EndBox(*output, trun);
+    EndBox(*output, traf);
+
+    runs.push_back(run);
+  }
+
+  EndBox(*output, moof);
+
+  uint64_t dataOffset = output->size() + 8;
+  for (const auto &run : runs) {
+    Patch32(*output, run.dataOffsetPosition, static_cast<uint32_t>(dataOffset));
+    dataOffset += run.dataSize;
+  }
+
+  Write32(*output, static_cast<uint32_t>(dataOffset - output->size()));
+  WriteType(*output, "mdat");
+
+  return output;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "media/rtmp/rtmp_media_parser.h"
+#include <memory>
+#include <vector>
+
+namespace Fmp4 {
+
+constexpr uint32_t Timescale = 1000; // rtmp timestamp(ms) as is
+constexpr uint32_t VideoTrackId = 1;
+constexpr uint32_t AudioTrackId = 2;
+
+// sample payload is a range of the rtmp message body(shared, not copied)
+struct Sample {
+  std::shared_ptr<std::vector<uint8_t>> data;
+  size_t offset;
+  uint32_t size;
+  uint64_t timestamp;          // dts(ms)
+  uint32_t duration;           // ms
+  int32_t compositionTime = 0; // pts - dts(ms)
+  bool isKey = false;
+};
+
+} // namespace Fmp4
+
+//====================================================================================================
+// Fmp4Muxer(H.264/AAC -> fragmented mp4, CMAF)
+//  - init segment : ftyp + moov(avc1/avcC, mp4a/esds, mvex)
+//  - fragment : moof(mfhd, traf(tfhd, tfdt, trun) per track) + mdat header, samples follow as is
+//  - video sample is AVCC(length prefixed nal) so the rtmp body after the 5 byte header is used without remux
+//  - not thread safe(one muxer per packager)
+//====================================================================================================
+class Fmp4Muxer {
+public:
+  Fmp4Muxer() = default;
+  ~Fmp4Muxer() = default;
+
+  bool Init(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  bool IsVideo() const { return _isVideo; }
+  bool IsAudio() const { return _isAudio; }
+
+  std::shared_ptr<std::vector<uint8_t>> MakeInitSegment() const;
+  // moof + mdat header, the mdat payload is the video samples followed by the audio samples
+  std::shared_ptr<std::vector<uint8_t>> MakeFragmentHeader(uint32_t sequence, const std::vector<Fmp4::Sample> &videos,
+                                                           const std::vector<Fmp4::Sample> &audios) const;
+
+  // return false : skip(sequence header, unsupported codec, broken data)
+  static bool MakeVideoSample(const std::shared_ptr<std::vector<uint8_t>> &data, uint64_t timestamp,
+                              Fmp4::Sample &sample);
+  static bool MakeAudioSample(const std::shared_ptr<std::vector<uint8_t>> &data, uint64_t timestamp,
+                              Fmp4::Sample &sample);
+
+private:
+  void WriteVideoTrack(std::vector<uint8_t> &output) const;
+  void WriteAudioTrack(std::vector<uint8_t> &output) const;
+
+private:
+  bool _isVideo = false;
+  bool _isAudio = false;
+
+  // h264
+  std::vector<uint8_t> _avcConfig; // AVCDecoderConfigurationRecord
+  uint32_t _width = 0;
+  uint32_t _height = 0;
+
+  // aac
+  std::vector<uint8_t> _audioConfig; // AudioSpecificConfig
+  uint32_t _sampleRate = 44100;
+  uint16_t _channels = 2;
+};
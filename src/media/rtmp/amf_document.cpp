@@ -86,6 +86,28 @@ int AmfProperty::Encode(uint8_t *data) {
   return output - data;
 }
 
+//====================================================================================================
+// AmfProperty - GetEncodeSize
+//====================================================================================================
+size_t AmfProperty::GetEncodeSize() const {
+  switch (_dataType) {
+  case AmfDataType::Null:
+  case AmfDataType::Undefined:
+    return 1;
+  case AmfDataType::Number:
+    return 1 + sizeof(double);
+  case AmfDataType::Boolean:
+    return 2;
+  case AmfDataType::String:
+    return _string ? 1 + 2 + std::strlen(_string->data()) : 0;
+  case AmfDataType::Array:
+    return _array ? _array->GetEncodeSize() : 0;
+  case AmfDataType::Object:
+    return _object ? _object->GetEncodeSize() : 0;
+  default:
+    return 0;
+  }
+}
 //====================================================================================================
 // AmfProperty - Decode
 // return 0 fail
@@ -202,6 +224,19 @@ int AmfObjectArray::Encode(uint8_t *data) {
   return output - data;
 }
 
+//====================================================================================================
+// AmfObjectArray - GetEncodeSize
+//  - marker(1) [count(4)] (name size(2) + name + property)... end(3)
+//====================================================================================================
+size_t AmfObjectArray::GetEncodeSize() const {
+  if (_propertyPairList.empty())
+    return 0;
+  size_t size = 1 + (_dataType == AmfDataType::Array ? sizeof(uint32_t) : 0) + 3;
+  for (const auto &pair : _propertyPairList) {
+    size += sizeof(uint16_t) + pair->_name.size() + pair->_property->GetEncodeSize();
+  }
+  return size;
+}
 //====================================================================================================
 // AmfObjectArray - Decode
 //====================================================================================================
@@ -453,6 +488,17 @@ int AmfDoc::Encode(uint8_t *data) const {
   return output - data;
 }
 
+//====================================================================================================
+// AmfDoc - GetEncodeSize
+//====================================================================================================
+size_t AmfDoc::GetEncodeSize() const {
+  size_t size = 0;
+  for (const auto &property : _properties) {
+    size += property->GetEncodeSize();
+  }
+  return size;
+}
+
 //====================================================================================================
 // AmfDoc - Decode
 // return 0 fail
@@ -28,6 +28,7 @@ public:
   std::string Dump();
   int Encode(uint8_t *data);               // return == 0 fail, type -> packet
   int Decode(uint8_t *data, int dataSize); // return == 0 fail, packet -> type
+  size_t GetEncodeSize() const;            // Encode output size
   AmfDataType GetType() const { return _dataType; }
   double GetNumber() const { return _number; }
   bool GetBoolean() const { return _boolean; }
@@ -64,6 +65,7 @@ public:
 
   int Encode(uint8_t *data);               // return == 0 fail, type -> packet
   int Decode(uint8_t *data, int dataSize); // return == 0 fail, packet -> type
+  size_t GetEncodeSize() const;            // Encode output size
 
   bool AddProp(const char *name, AmfDataType type);
   bool AddProp(const char *name, double number);
@@ -122,6 +124,7 @@ public:
 
   std::string Dump();
   int Encode(uint8_t *data) const;                               // return == 0 fail
+  size_t GetEncodeSize() const;                                  // Encode output size(buffer size before Encode)
   int Decode(const std::shared_ptr<std::vector<uint8_t>> &data); // return == 0 fail
   bool AddProp(AmfDataType type);
   bool AddProp(double number);
@@ -81,6 +81,8 @@ struct Cmd {
   static inline const std::string DeleteStream = "deleteStream";
   static inline const std::string CloseStream = "closeStream";
   static inline const std::string Play = "play";
+  static inline const std::string Seek = "seek";
+  static inline const std::string Pause = "pause";
   static inline const std::string OnStatus = "onStatus";
   static inline const std::string Publish = "publish";
   static inline const std::string FcPublish = "FCPublish";
@@ -105,6 +107,7 @@ constexpr int H264PFrameType = 0x27;
 constexpr int DefaultAckSize = 2500000;
 constexpr int DefaultPeerBandWidth = 2500000;
 constexpr int DefaultChunkSize = 128;
+constexpr int MaxChunkSize = 0x00ffffff; // every message in one chunk(message length max)
 
 constexpr int VideoDataMinSize = 5; // control(1) + sequence(1) + offset time(3)
 
@@ -121,6 +124,73 @@ constexpr int VideoSequenceHeaderIndex = 1;
 constexpr int VideoCtsIndex = 2;
 constexpr int VideoFrameIndex = 5;
 
+// Enhanced RTMP video(ExVideoTagHeader)
+//  - IsExHeader(1) FrameType(3) PacketType(4) FourCC(4) [CompositionTime(3) : hvc1 CodedFrames]
+//  - sequence start : decoder configuration record(hvcC, av1C) at VideoFrameIndex like the legacy avcC
+constexpr uint8_t VideoExHeaderFlag = 0x80;
+constexpr int VideoFourCcIndex = 1;
+constexpr int VideoKeyFrameType = 1;
+
+enum class VideoPacketType {
+  SequenceStart = 0,
+  CodedFrames = 1,
+  SequenceEnd = 2,
+  CodedFramesX = 3, // composition time none
+  Metadata = 4,
+  Mpeg2TsSequenceStart = 5,
+};
+
+enum class VideoCodecId : uint8_t {
+  Unknown = 0,
+  H264 = 7,
+  Hevc = 12, // legacy flv extension or fourcc hvc1
+  Av1 = 13,  // fourcc av01
+};
+
+constexpr uint32_t MakeFourCc(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  return (static_cast<uint32_t>(a) << 24) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(c) << 8) |
+         static_cast<uint32_t>(d);
+}
+constexpr uint32_t FourCcHevc = MakeFourCc('h', 'v', 'c', '1');
+constexpr uint32_t FourCcAv1 = MakeFourCc('a', 'v', '0', '1');
+
+// video codec(legacy codec id or enhanced fourcc)
+inline VideoCodecId GetVideoCodecId(const uint8_t *data, size_t size) {
+  if (size < 1) {
+    return VideoCodecId::Unknown;
+  }
+
+  if ((data[0] & VideoExHeaderFlag) == 0) {
+    const auto codecId = data[0] & 0x0f;
+    return (codecId == 7 || codecId == 12) ? static_cast<VideoCodecId>(codecId) : VideoCodecId::Unknown;
+  }
+
+  if (size < VideoFrameIndex) {
+    return VideoCodecId::Unknown;
+  }
+
+  const auto fourCc = MakeFourCc(data[1], data[2], data[3], data[4]);
+  return fourCc == FourCcHevc ? VideoCodecId::Hevc : fourCc == FourCcAv1 ? VideoCodecId::Av1 : VideoCodecId::Unknown;
+}
+
+// sequence header(legacy AVCPacketType 0 or enhanced SequenceStart)
+inline bool IsVideoSequenceHeader(const uint8_t *data, size_t size) {
+  if (size < 2) {
+    return false;
+  }
+
+  if ((data[0] & VideoExHeaderFlag) != 0) {
+    return (data[0] & 0x0f) == static_cast<int>(VideoPacketType::SequenceStart);
+  }
+
+  return data[1] == 0;
+}
+
+// key frame(FrameType is at the same bits in both headers)
+inline bool IsVideoKeyFrame(const uint8_t *data, size_t size) {
+  return size > 0 && ((data[0] >> 4) & 0x07) == VideoKeyFrameType;
+}
+
 constexpr int DefaultPort = 1935;
 
 struct Type0 {
@@ -180,6 +250,12 @@ enum class HandshakeState {
 
 constexpr int MaxPacketSize = 20 * 1024 * 1024; // 20M
 
+// AGGREGATE MESSAGE
+//  - body : [type(1) size(3) timestamp(3 + 1) stream id(3)] + data + back pointer(4), repeated(flv tag layout)
+//  - sub message timestamp is moved by (aggregate timestamp - first sub message timestamp)
+constexpr int AggregateSubHeaderSize = 11;
+constexpr int AggregateBackPointerSize = 4;
+
 //===============================================================================================
 // Frame
 //===============================================================================================
@@ -14,58 +14,49 @@ void RtmpExportChunk::Destroy() { _streamMap.clear(); }
 //====================================================================================================
 // GetStream
 //====================================================================================================
-std::shared_ptr<ExportStream> RtmpExportChunk::GetStream(uint32_t chunkStreamId) {
-  if (auto it = _streamMap.find(chunkStreamId); it != _streamMap.end()) {
-    return it->second;
-  }
-
-  auto stream = std::make_shared<ExportStream>();
-  _streamMap[chunkStreamId] = stream;
-  return stream;
-}
+ExportStream &RtmpExportChunk::GetStream(uint32_t chunkStreamId) { return _streamMap[chunkStreamId]; }
 
 //====================================================================================================
 // GetChunkHeader
 //====================================================================================================
-std::pair<std::shared_ptr<Rtmp::ChunkHeader>, bool>
-RtmpExportChunk::GetChunkHeader(const std::shared_ptr<ExportStream> &stream,
-                                const std::shared_ptr<RtmpMuxMsgHeader> &header) {
-  auto chunkHeader = std::make_shared<Rtmp::ChunkHeader>();
+std::pair<Rtmp::ChunkHeader, bool> RtmpExportChunk::GetChunkHeader(const ExportStream &stream,
+                                                                   const RtmpMuxMsgHeader &header) {
+  Rtmp::ChunkHeader chunkHeader;
   bool isExtended = false;
 
-  auto &prevHeader = stream->header;
-  uint32_t timestampDelta = header->timestamp - prevHeader->timestamp;
+  const auto &prevHeader = stream.header;
+  uint32_t timestampDelta = header.timestamp - prevHeader.timestamp;
 
-  if (_compressHeader && stream->header->chunkStreamId == header->chunkStreamId) {
-    if (stream->header->bodySize == header->bodySize && stream->header->streamId == header->streamId &&
-        stream->header->typeId == header->typeId) {
-      chunkHeader->basicHeader.formatType = Rtmp::ChunkFormat::Type_2;
-      chunkHeader->basicHeader.chunkStreamId = header->chunkStreamId;
-      chunkHeader->type_2.timestampDelta = timestampDelta;
+  if (_compressHeader && prevHeader.chunkStreamId == header.chunkStreamId) {
+    if (prevHeader.bodySize == header.bodySize && prevHeader.streamId == header.streamId &&
+        prevHeader.typeId == header.typeId) {
+      chunkHeader.basicHeader.formatType = Rtmp::ChunkFormat::Type_2;
+      chunkHeader.basicHeader.chunkStreamId = header.chunkStreamId;
+      chunkHeader.type_2.timestampDelta = timestampDelta;
 
       if (timestampDelta >= Rtmp::ExtendFormat) {
         isExtended = true;
       }
     } else {
-      chunkHeader->basicHeader.formatType = Rtmp::ChunkFormat::Type_1;
-      chunkHeader->basicHeader.chunkStreamId = header->chunkStreamId;
-      chunkHeader->type_1.timestampDelta = timestampDelta;
-      chunkHeader->type_1.bodySize = header->bodySize;
-      chunkHeader->type_1.typeId = header->typeId;
+      chunkHeader.basicHeader.formatType = Rtmp::ChunkFormat::Type_1;
+      chunkHeader.basicHeader.chunkStreamId = header.chunkStreamId;
+      chunkHeader.type_1.timestampDelta = timestampDelta;
+      chunkHeader.type_1.bodySize = header.bodySize;
+      chunkHeader.type_1.typeId = header.typeId;
 
       if (timestampDelta >= Rtmp::ExtendFormat) {
         isExtended = true;
       }
     }
   } else {
-    chunkHeader->basicHeader.formatType = Rtmp::ChunkFormat::Type_0;
-    chunkHeader->basicHeader.chunkStreamId = header->chunkStreamId;
-    chunkHeader->type_0.timestamp = header->timestamp;
-    chunkHeader->type_0.bodySize = header->bodySize;
-    chunkHeader->type_0.typeId = header->typeId;
-    chunkHeader->type_0.streamId = header->streamId;
-
-    if (chunkHeader->type_0.timestamp >= Rtmp::ExtendFormat) {
+    chunkHeader.basicHeader.formatType = Rtmp::ChunkFormat::Type_0;
+    chunkHeader.basicHeader.chunkStreamId = header.chunkStreamId;
+    chunkHeader.type_0.timestamp = header.timestamp;
+    chunkHeader.type_0.bodySize = header.bodySize;
+    chunkHeader.type_0.typeId = header.typeId;
+    chunkHeader.type_0.streamId = header.streamId;
+
+    if (chunkHeader.type_0.timestamp >= Rtmp::ExtendFormat) {
       isExtended = true;
     }
   }
@@ -73,40 +64,106 @@ RtmpExportChunk::GetChunkHeader(const std::shared_ptr<ExportStream> &stream,
   return {chunkHeader, isExtended};
 }
 
+//====================================================================================================
+// ExportData
+//  - raw header + chunk data written once into one pooled buffer
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> RtmpExportChunk::ExportData(int chunkSize, const Rtmp::ChunkHeader &chunkHeader,
+                                                                  bool isExtended, uint32_t type3Time,
+                                                                  const std::shared_ptr<std::vector<uint8_t>> &data) {
+  if (chunkSize <= 0 || !data || data->empty()) {
+    return nullptr;
+  }
+
+  uint8_t rawHeader[Rtmp::PacketHeaderSizeMax];
+  int rawHeaderSize = WriteChunkRawHeader(rawHeader, chunkHeader, isExtended);
+  int dataSize = static_cast<int>(data->size());
+  auto chunkStreamId = chunkHeader.basicHeader.chunkStreamId;
+
+  auto exportData =
+      BufferPool::Alloc(rawHeaderSize + GetChunkDataRawSize(chunkSize, chunkStreamId, dataSize, isExtended));
+
+  std::memcpy(exportData->data(), rawHeader, rawHeaderSize);
+  WriteChunkRawData(exportData->data() + rawHeaderSize, chunkSize, chunkStreamId, data->data(), dataSize, isExtended,
+                    type3Time);
+
+  return exportData;
+}
+
 //====================================================================================================
 // ExportStreamData
 //====================================================================================================
 std::shared_ptr<std::vector<uint8_t>>
-RtmpExportChunk::ExportStreamData(const std::shared_ptr<RtmpMuxMsgHeader> &header,
-                                  const std::shared_ptr<std::vector<uint8_t>> &data) {
-  if (!header || header->chunkStreamId < 2) {
+RtmpExportChunk::ExportStreamData(const RtmpMuxMsgHeader &header, const std::shared_ptr<std::vector<uint8_t>> &data) {
+  if (header.chunkStreamId < 2) {
     return nullptr;
   }
 
-  auto stream = GetStream(header->chunkStreamId);
+  auto &stream = GetStream(header.chunkStreamId);
   auto [chunkHeader, isExtended] = GetChunkHeader(stream, header);
 
   uint32_t type3Time = 0;
-  switch (chunkHeader->basicHeader.formatType) {
+  switch (chunkHeader.basicHeader.formatType) {
   case Rtmp::ChunkFormat::Type_0:
-    type3Time = chunkHeader->type_0.timestamp;
+    type3Time = chunkHeader.type_0.timestamp;
     break;
   case Rtmp::ChunkFormat::Type_1:
-    type3Time = chunkHeader->type_1.timestampDelta;
+    type3Time = chunkHeader.type_1.timestampDelta;
     break;
   case Rtmp::ChunkFormat::Type_2:
-    type3Time = chunkHeader->type_2.timestampDelta;
+    type3Time = chunkHeader.type_2.timestampDelta;
     break;
   default:
     break;
   }
 
-  auto chunkRawHeader = MakeChunkRawHeader(chunkHeader, isExtended);
-  auto chunkRawData = MakeChunkRawData(_chunkSize, header->chunkStreamId, data, isExtended, type3Time);
+  stream.timestampDelta = header.timestamp - stream.header.timestamp;
+  stream.header = header;
 
-  stream->timestampDelta = header->timestamp - stream->header->timestamp;
-  stream->header = header;
+  return ExportData(_chunkSize, chunkHeader, isExtended, type3Time, data);
+}
 
-  chunkRawHeader->insert(chunkRawHeader->end(), chunkRawData->begin(), chunkRawData->end());
-  return chunkRawHeader;
-}
\ No newline at end of file
+//====================================================================================================
+// ExportMsgData
+//  - Type_0 header + Type_3 chunks, no previous stream state
+//  - same header/data always makes the same raw data, so the result can be shared
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>>
+RtmpExportChunk::ExportMsgData(int chunkSize, const RtmpMuxMsgHeader &header,
+                               const std::shared_ptr<std::vector<uint8_t>> &data) {
+  if (header.chunkStreamId < 2) {
+    return nullptr;
+  }
+
+  Rtmp::ChunkHeader chunkHeader;
+  chunkHeader.basicHeader.formatType = Rtmp::ChunkFormat::Type_0;
+  chunkHeader.basicHeader.chunkStreamId = header.chunkStreamId;
+  chunkHeader.type_0.timestamp = header.timestamp;
+  chunkHeader.type_0.bodySize = header.bodySize;
+  chunkHeader.type_0.typeId = header.typeId;
+  chunkHeader.type_0.streamId = header.streamId;
+
+  return ExportData(chunkSize, chunkHeader, header.timestamp >= Rtmp::ExtendFormat, header.timestamp, data);
+}
+
+//====================================================================================================
+// ExportMsgHeader
+//  - header and body go out as separate buffers, the body is not copied
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> RtmpExportChunk::ExportMsgHeader(const RtmpMuxMsgHeader &header) {
+  if (header.chunkStreamId < 2) {
+    return nullptr;
+  }
+
+  Rtmp::ChunkHeader chunkHeader;
+  chunkHeader.basicHeader.formatType = Rtmp::ChunkFormat::Type_0;
+  chunkHeader.basicHeader.chunkStreamId = header.chunkStreamId;
+  chunkHeader.type_0.timestamp = header.timestamp;
+  chunkHeader.type_0.bodySize = header.bodySize;
+  chunkHeader.type_0.typeId = header.typeId;
+  chunkHeader.type_0.streamId = header.streamId;
+
+  auto rawHeader = BufferPool::Alloc(Rtmp::PacketHeaderSizeMax);
+  rawHeader->resize(WriteChunkRawHeader(rawHeader->data(), chunkHeader, header.timestamp >= Rtmp::ExtendFormat));
+  return rawHeader;
+}
@@ -8,10 +8,8 @@
 // ExportStream
 //====================================================================================================
 struct ExportStream {
-  ExportStream() : header(std::make_shared<RtmpMuxMsgHeader>()), timestampDelta(0) {}
-
-  std::shared_ptr<RtmpMuxMsgHeader> header;
-  uint32_t timestampDelta;
+  RtmpMuxMsgHeader header;
+  uint32_t timestampDelta = 0;
 };
 
 //====================================================================================================
@@ -22,18 +20,25 @@ public:
   RtmpExportChunk(bool compressHeader, int chunkSize);
   ~RtmpExportChunk() override = default;
 
-  std::shared_ptr<std::vector<uint8_t>> ExportStreamData(const std::shared_ptr<RtmpMuxMsgHeader> &header,
+  std::shared_ptr<std::vector<uint8_t>> ExportStreamData(const RtmpMuxMsgHeader &header,
                                                          const std::shared_ptr<std::vector<uint8_t>> &data);
+  static std::shared_ptr<std::vector<uint8_t>> ExportMsgData(int chunkSize, const RtmpMuxMsgHeader &header,
+                                                             const std::shared_ptr<std::vector<uint8_t>> &data);
+  // Type_0 header only, data must fit in one chunk(bodySize <= chunkSize)
+  static std::shared_ptr<std::vector<uint8_t>> ExportMsgHeader(const RtmpMuxMsgHeader &header);
   int GetChunkSize() { return _chunkSize; }
+  void SetChunkSize(int chunkSize) { _chunkSize = chunkSize; }
 
 private:
   void Destroy();
-  std::shared_ptr<ExportStream> GetStream(uint32_t chunkStreamId);
-  std::pair<std::shared_ptr<Rtmp::ChunkHeader>, bool> GetChunkHeader(const std::shared_ptr<ExportStream> &stream,
-                                                                     const std::shared_ptr<RtmpMuxMsgHeader> &header);
+  ExportStream &GetStream(uint32_t chunkStreamId);
+  std::pair<Rtmp::ChunkHeader, bool> GetChunkHeader(const ExportStream &stream, const RtmpMuxMsgHeader &header);
+  static std::shared_ptr<std::vector<uint8_t>> ExportData(int chunkSize, const Rtmp::ChunkHeader &chunkHeader,
+                                                          bool isExtended, uint32_t type3Time,
+                                                          const std::shared_ptr<std::vector<uint8_t>> &data);
 
 private:
-  std::map<uint32_t, std::shared_ptr<ExportStream>> _streamMap;
+  std::map<uint32_t, ExportStream> _streamMap;
   bool _compressHeader;
   int _chunkSize;
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "rtmp_export_frame.h"
+#include "common/buffer_pool.h"
+#include "media/flv/flv_mux_util.h"
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+RtmpExportFrame::RtmpExportFrame(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo)
+    : _frame(frame), _isVideo(isVideo) {}
+
+//====================================================================================================
+// GetChunkData
+//  - players normally share one chunk size/stream id, so the list holds one or two entries
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> RtmpExportFrame::GetChunkData(int chunkSize, uint32_t streamId) {
+  std::lock_guard<std::mutex> lock(_dataLock);
+
+  for (const auto &chunkData : _chunkDatas) {
+    if (chunkData.chunkSize == chunkSize && chunkData.streamId == streamId) {
+      return chunkData.data;
+    }
+  }
+
+  RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream), static_cast<uint32_t>(_frame->timestamp),
+                          static_cast<int>(_isVideo ? Rtmp::MsgType::VideoMsg : Rtmp::MsgType::AudioMsg), streamId,
+                          _frame->data->size());
+
+  auto data = RtmpExportChunk::ExportMsgData(chunkSize, header, _frame->data);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  _chunkDatas.push_back({chunkSize, streamId, data});
+  return data;
+}
+
+//====================================================================================================
+// GetFlvTag
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> RtmpExportFrame::GetFlvTag() {
+  std::lock_guard<std::mutex> lock(_dataLock);
+
+  if (_flvTag == nullptr) {
+    _flvTag = FlvMuxUtil::MakeFlvTag(_isVideo ? Flv::TagType::Video : Flv::TagType::Audio,
+                                     static_cast<uint32_t>(_frame->timestamp), _frame->data->data(),
+                                     _frame->data->size());
+  }
+
+  return _flvTag;
+}
+
+//====================================================================================================
+// GetWsFlvTag
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> RtmpExportFrame::GetWsFlvTag() {
+  std::lock_guard<std::mutex> lock(_dataLock);
+
+  if (_wsFlvTag == nullptr) {
+    _wsFlvTag = FlvMuxUtil::MakeWsFlvTag(_isVideo ? Flv::TagType::Video : Flv::TagType::Audio,
+                                         static_cast<uint32_t>(_frame->timestamp), _frame->data->data(),
+                                         _frame->data->size());
+  }
+
+  return _wsFlvTag;
+}
+
+//====================================================================================================
+// GetAggregateChunkData
+//  - sub messages : flv tag + back pointer(aggregate timestamp = first sub message timestamp)
+//  - made once per window(frame list)/chunk size/stream id, players of the same window share it
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>>
+RtmpExportFrame::GetAggregateChunkData(const std::vector<std::shared_ptr<RtmpExportFrame>> &frames, int chunkSize,
+                                       uint32_t streamId) {
+  if (frames.empty() || frames.back().get() != this) {
+    return nullptr;
+  }
+
+  std::vector<const RtmpExportFrame *> window;
+  window.reserve(frames.size());
+  size_t bodySize = 0;
+  for (const auto &frame : frames) {
+    window.push_back(frame.get());
+    bodySize += FlvMuxUtil::GetFlvTagSize(frame->GetSize());
+  }
+
+  std::lock_guard<std::mutex> lock(_dataLock);
+
+  for (const auto &aggregateData : _aggregateDatas) {
+    if (aggregateData.chunkSize == chunkSize && aggregateData.streamId == streamId && aggregateData.frames == window) {
+      return aggregateData.data;
+    }
+  }
+
+  auto body = BufferPool::Alloc(bodySize);
+  auto *output = body->data();
+
+  for (const auto &frame : frames) {
+    const auto &data = frame->GetFrame()->data;
+    output += FlvMuxUtil::WriteFlvTag(output, frame->IsVideo() ? Flv::TagType::Video : Flv::TagType::Audio,
+                                      static_cast<uint32_t>(frame->GetTimestamp()), data->data(), data->size());
+  }
+
+  RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream),
+                          static_cast<uint32_t>(frames.front()->GetTimestamp()),
+                          static_cast<int>(Rtmp::MsgType::AggregateMsg), streamId, body->size());
+  auto data = RtmpExportChunk::ExportMsgData(chunkSize, header, body);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  if (_aggregateDatas.size() < MaxAggregateCount) {
+    _aggregateDatas.push_back({std::move(window), chunkSize, streamId, data});
+  }
+  return data;
+}
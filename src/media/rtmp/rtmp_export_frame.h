@@ -0,0 +1,53 @@
+#pragma once
+#include "rtmp_export_chunk.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//====================================================================================================
+// RtmpExportFrame
+//  - one published frame shared by every player of the stream
+//  - chunk raw data(Type_0 + Type_3) is made once per chunk size/stream id and reused
+//  - flv tag(http-flv) and websocket flv message(ws-flv) are made once on first request and reused
+//  - aggregate message(frames up to this one) is kept on the last frame, players with the same window reuse it
+//====================================================================================================
+class RtmpExportFrame {
+public:
+  RtmpExportFrame(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo);
+  ~RtmpExportFrame() = default;
+
+  std::shared_ptr<std::vector<uint8_t>> GetChunkData(int chunkSize, uint32_t streamId);
+  std::shared_ptr<std::vector<uint8_t>> GetFlvTag();
+  std::shared_ptr<std::vector<uint8_t>> GetWsFlvTag();
+  // frames : window ending with this frame
+  std::shared_ptr<std::vector<uint8_t>>
+  GetAggregateChunkData(const std::vector<std::shared_ptr<RtmpExportFrame>> &frames, int chunkSize, uint32_t streamId);
+  const std::shared_ptr<Rtmp::Frame> &GetFrame() const { return _frame; }
+  uint64_t GetTimestamp() const { return _frame->timestamp; }
+  size_t GetSize() const { return _frame->data->size(); }
+  bool IsVideo() const { return _isVideo; }
+  bool IsKeyFrame() const { return _isVideo && Rtmp::IsVideoKeyFrame(_frame->data->data(), _frame->data->size()); }
+
+private:
+  struct ChunkData {
+    int chunkSize;
+    uint32_t streamId;
+    std::shared_ptr<std::vector<uint8_t>> data;
+  };
+  struct AggregateData {
+    std::vector<const RtmpExportFrame *> frames; // identity only(older frames of the stream, no address reuse)
+    int chunkSize;
+    uint32_t streamId;
+    std::shared_ptr<std::vector<uint8_t>> data;
+  };
+  static constexpr size_t MaxAggregateCount = 4; // windows cut differently(join, drop), over : not kept
+
+  std::shared_ptr<Rtmp::Frame> _frame;
+  bool _isVideo;
+
+  std::vector<ChunkData> _chunkDatas;
+  std::vector<AggregateData> _aggregateDatas;
+  std::shared_ptr<std::vector<uint8_t>> _flvTag = nullptr;
+  std::shared_ptr<std::vector<uint8_t>> _wsFlvTag = nullptr;
+  std::mutex _dataLock;
+};
@@ -16,52 +16,42 @@ void RtmpImportChunk::Destroy() {
 //====================================================================================================
 // GetStream
 //====================================================================================================
-std::shared_ptr<ImportStream> RtmpImportChunk::GetStream(uint32_t chunkStreamId) {
-  if (auto it = _streamMap.find(chunkStreamId); it != _streamMap.end()) {
-    return it->second;
-  }
-
-  auto stream = std::make_shared<ImportStream>();
-  _streamMap[chunkStreamId] = stream;
-  return stream;
-}
+ImportStream &RtmpImportChunk::GetStream(uint32_t chunkStreamId) { return _streamMap[chunkStreamId]; }
 
 //====================================================================================================
 // GetMessageHeader
 //====================================================================================================
-std::shared_ptr<RtmpMuxMsgHeader>
-RtmpImportChunk::GetMessageHeader(const std::shared_ptr<ImportStream> &stream,
-                                  const std::shared_ptr<Rtmp::ChunkHeader> &chunkHeader) {
-  auto header = std::make_shared<RtmpMuxMsgHeader>();
+RtmpMuxMsgHeader RtmpImportChunk::GetMessageHeader(const ImportStream &stream, const Rtmp::ChunkHeader &chunkHeader) {
+  RtmpMuxMsgHeader header;
 
-  switch (chunkHeader->basicHeader.formatType) {
+  switch (chunkHeader.basicHeader.formatType) {
   case Rtmp::ChunkFormat::Type_0:
-    header->chunkStreamId = chunkHeader->basicHeader.chunkStreamId;
-    header->timestamp = chunkHeader->type_0.timestamp;
-    header->bodySize = chunkHeader->type_0.bodySize;
-    header->typeId = chunkHeader->type_0.typeId;
-    header->streamId = chunkHeader->type_0.streamId;
+    header.chunkStreamId = chunkHeader.basicHeader.chunkStreamId;
+    header.timestamp = chunkHeader.type_0.timestamp;
+    header.bodySize = chunkHeader.type_0.bodySize;
+    header.typeId = chunkHeader.type_0.typeId;
+    header.streamId = chunkHeader.type_0.streamId;
     break;
   case Rtmp::ChunkFormat::Type_1:
-    header->chunkStreamId = chunkHeader->basicHeader.chunkStreamId;
-    header->timestamp = stream->header->timestamp + chunkHeader->type_1.timestampDelta;
-    header->bodySize = chunkHeader->type_1.bodySize;
-    header->typeId = chunkHeader->type_1.typeId;
-    header->streamId = stream->header->streamId;
+    header.chunkStreamId = chunkHeader.basicHeader.chunkStreamId;
+    header.timestamp = stream.header.timestamp + chunkHeader.type_1.timestampDelta;
+    header.bodySize = chunkHeader.type_1.bodySize;
+    header.typeId = chunkHeader.type_1.typeId;
+    header.streamId = stream.header.streamId;
     break;
   case Rtmp::ChunkFormat::Type_2:
-    header->chunkStreamId = chunkHeader->basicHeader.chunkStreamId;
-    header->timestamp = stream->header->timestamp + chunkHeader->type_2.timestampDelta;
-    header->bodySize = stream->header->bodySize;
-    header->typeId = stream->header->typeId;
-    header->streamId = stream->header->streamId;
+    header.chunkStreamId = chunkHeader.basicHeader.chunkStreamId;
+    header.timestamp = stream.header.timestamp + chunkHeader.type_2.timestampDelta;
+    header.bodySize = stream.header.bodySize;
+    header.typeId = stream.header.typeId;
+    header.streamId = stream.header.streamId;
     break;
   case Rtmp::ChunkFormat::Type_3:
-    header->chunkStreamId = chunkHeader->basicHeader.chunkStreamId;
-    header->timestamp = stream->header->timestamp + stream->timestampDelta;
-    header->bodySize = stream->header->bodySize;
-    header->typeId = stream->header->typeId;
-    header->streamId = stream->header->streamId;
+    header.chunkStreamId = chunkHeader.basicHeader.chunkStreamId;
+    header.timestamp = stream.header.timestamp + stream.timestampDelta;
+    header.bodySize = stream.header.bodySize;
+    header.typeId = stream.header.typeId;
+    header.streamId = stream.header.streamId;
     break;
   default:
     break;
@@ -72,36 +62,24 @@ RtmpImportChunk::GetMessageHeader(const std::shared_ptr<ImportStream> &stream,
 
 //====================================================================================================
 // AppendChunk
+//  - chunk payload is written once into the message body
 //====================================================================================================
-bool RtmpImportChunk::AppendChunk(const std::shared_ptr<ImportStream> &stream, const uint8_t *chunk, int headerSize,
-                                  int dataSize) {
-  int appendSize = (stream->writeChunkDataSize == 0) ? (headerSize + dataSize) : dataSize;
-
-  if (appendSize > Rtmp::MaxPacketSize) {
-    LOG_INFO("Rtmp Append Data Size ( %d)", appendSize);
+bool RtmpImportChunk::AppendChunk(ImportStream &stream, const uint8_t *chunkData, int dataSize) {
+  if (stream.writeChunkDataSize + dataSize > static_cast<int>(stream.body->size())) {
+    LOG_ERROR("Rtmp append data size fail - write(%d) data(%d) body(%d)", stream.writeChunkDataSize, dataSize,
+              static_cast<int>(stream.body->size()));
     return false;
   }
 
-  if ((static_cast<int>(stream->buffer->size()) - stream->writeBufferSize) < appendSize) {
-    stream->buffer->resize((stream->buffer->size() * 2) > (stream->buffer->size() + appendSize)
-                               ? (stream->buffer->size() * 2)
-                               : (stream->buffer->size() + appendSize));
-  }
-
-  if (stream->writeBufferSize == 0) {
-    std::memcpy(stream->buffer->data() + stream->writeBufferSize, chunk, static_cast<size_t>(appendSize));
-  } else {
-    std::memcpy(stream->buffer->data() + stream->writeBufferSize, chunk + headerSize, static_cast<size_t>(appendSize));
-  }
-
-  stream->writeBufferSize += appendSize;
-  stream->writeChunkDataSize += dataSize;
+  std::memcpy(stream.body->data() + stream.writeChunkDataSize, chunkData, static_cast<size_t>(dataSize));
+  stream.writeChunkDataSize += dataSize;
 
   return true;
 }
 
 //====================================================================================================
 // ImportStreamData
+//  - no heap allocation per chunk(message body/ImportMsg only)
 //====================================================================================================
 std::pair<int, bool> RtmpImportChunk::ImportStreamData(const uint8_t *data, int dataSize) {
   if (dataSize <= 0 || data == nullptr) {
@@ -114,10 +92,10 @@ std::pair<int, bool> RtmpImportChunk::ImportStreamData(const uint8_t *data, int
     return {chunkHeaderSize, false};
   }
 
-  auto stream = GetStream(chunkHeader->basicHeader.chunkStreamId);
+  auto &stream = GetStream(chunkHeader.basicHeader.chunkStreamId);
 
-  if (chunkHeader->basicHeader.formatType == Rtmp::ChunkFormat::Type_3) {
-    isEextend = stream->isEextend;
+  if (chunkHeader.basicHeader.formatType == Rtmp::ChunkFormat::Type_3) {
+    isEextend = stream.isEextend;
 
     if (isEextend) {
       chunkHeaderSize += Rtmp::ExtendTimestampSize;
@@ -129,78 +107,60 @@ std::pair<int, bool> RtmpImportChunk::ImportStreamData(const uint8_t *data, int
     }
   }
 
-  stream->isEextend = isEextend;
-
-  auto header = GetMessageHeader(stream, chunkHeader);
+  // message header is fixed at the first chunk(continuation chunks only carry payload)
+  auto header = (stream.writeChunkDataSize == 0) ? GetMessageHeader(stream, chunkHeader) : stream.msgHeader;
 
-  auto restChunkSize = static_cast<int>(header->bodySize) - stream->writeChunkDataSize;
+  auto restChunkSize = static_cast<int>(header.bodySize) - stream.writeChunkDataSize;
 
   if (restChunkSize <= 0) {
     LOG_ERROR("Rest Chunk Size Fail - Header(%d) Data(%d) Chunk(%d)", chunkHeaderSize, restChunkSize, _chunkSize);
     return {-1, false};
   }
 
-  if (_chunkSize < restChunkSize) {
-    if (dataSize < chunkHeaderSize + _chunkSize) {
-      return {0, false};
-    }
+  auto appendSize = std::min(_chunkSize, restChunkSize);
 
-    if (!AppendChunk(stream, data, chunkHeaderSize, _chunkSize)) {
-      LOG_ERROR("AppendChunk Fail - Header(%d) Data(%d) Chunk(%d)", chunkHeaderSize, restChunkSize, _chunkSize);
-      return {-1, false};
-    }
+  if (dataSize < chunkHeaderSize + appendSize) {
+    return {0, false};
+  }
 
-    header->timestamp = stream->header->timestamp;
-    stream->header = header;
+  stream.isEextend = isEextend;
 
-    return {chunkHeaderSize + _chunkSize, false};
-  }
+  if (stream.writeChunkDataSize == 0) {
+    if (header.bodySize > Rtmp::MaxPacketSize) {
+      LOG_ERROR("Rtmp body size fail - size(%u:%d)", header.bodySize, Rtmp::MaxPacketSize);
+      return {-1, false};
+    }
 
-  if (dataSize < chunkHeaderSize + restChunkSize) {
-    return {0, false};
+    stream.msgHeader = header;
+    stream.body = BufferPool::Alloc(header.bodySize);
   }
 
-  if (!AppendChunk(stream, data, chunkHeaderSize, restChunkSize)) {
+  if (!AppendChunk(stream, data + chunkHeaderSize, appendSize)) {
     LOG_ERROR("AppendChunk Fail - Header(%d) Data(%d) Chunk(%d)", chunkHeaderSize, restChunkSize, _chunkSize);
     return {-1, false};
   }
 
-  if (!CompletedChunkMessage(stream)) {
-    LOG_ERROR("CompletedChunkMessage Fail");
-    return {-1, false};
+  if (appendSize < restChunkSize) {
+    return {chunkHeaderSize + appendSize, false};
   }
 
-  return {chunkHeaderSize + restChunkSize, true};
+  CompletedChunkMessage(stream);
+
+  return {chunkHeaderSize + appendSize, true};
 }
 
 //====================================================================================================
 // CompletedChunkMessage
+//  - body ownership moves to the message(no copy)
 //====================================================================================================
-bool RtmpImportChunk::CompletedChunkMessage(const std::shared_ptr<ImportStream> &stream) {
-  auto [chunkHeader, chunkHeaderSize, isEextend] = GetChunkHeader(stream->buffer->data(), stream->writeBufferSize);
-  auto chunkDataSize = stream->writeChunkDataSize;
+void RtmpImportChunk::CompletedChunkMessage(ImportStream &stream) {
+  _importMessageQueue.push_back(
+      std::make_shared<ImportMsg>(std::make_shared<RtmpMuxMsgHeader>(stream.msgHeader), std::move(stream.body)));
 
-  if (stream->writeBufferSize < chunkHeaderSize + chunkDataSize) {
-    LOG_ERROR("Buffer(%d) RawData(%d)", stream->writeBufferSize, chunkHeaderSize + chunkDataSize);
-    return false;
-  }
-
-  auto header = GetMessageHeader(stream, chunkHeader);
-
-  if (header->bodySize != 0) {
-    auto chunkData = std::make_shared<std::vector<uint8_t>>(stream->buffer->begin() + chunkHeaderSize,
-                                                            stream->buffer->begin() + chunkHeaderSize + chunkDataSize);
-    auto msg = std::make_shared<ImportMsg>(header, chunkData);
-
-    _importMessageQueue.push_back(msg);
-  }
-
-  stream->writeBufferSize = 0;
-  stream->writeChunkDataSize = 0;
-  stream->timestampDelta = header->timestamp - stream->header->timestamp;
-  stream->header = header;
-
-  return true;
+  stream.body = nullptr;
+  stream.writeChunkDataSize = 0;
+  stream.timestampDelta = stream.msgHeader.timestamp - stream.header.timestamp;
+  stream.header = stream.msgHeader;
 }
 
 //====================================================================================================
@@ -215,4 +175,45 @@ std::shared_ptr<ImportMsg> RtmpImportChunk::GetMessage() {
   _importMessageQueue.pop_front();
 
   return msg;
-}
\ No newline at end of file
+}
+//====================================================================================================
+// SplitAggregateMsg
+//  - sub message body is copied(the frame keeps its own buffer), header takes the aggregate chunk stream
+//====================================================================================================
+bool RtmpImportChunk::SplitAggregateMsg(const std::shared_ptr<ImportMsg> &msg,
+                                        std::vector<std::shared_ptr<ImportMsg>> &msgs) {
+  const auto *data = msg->body->data();
+  const size_t dataSize = msg->body->size();
+  size_t offset = 0;
+  bool isFirst = true;
+  uint32_t timestampDelta = 0;
+
+  while (offset + Rtmp::AggregateSubHeaderSize <= dataSize) {
+    const auto *subHeader = data + offset;
+    const auto typeId = ReadInt8(subHeader);
+    const auto bodySize = ReadInt24(subHeader + 1);
+    const auto timestamp = ReadInt24(subHeader + 4) | (static_cast<uint32_t>(ReadInt8(subHeader + 7)) << 24);
+
+    offset += Rtmp::AggregateSubHeaderSize;
+    if (offset + bodySize > dataSize) {
+      LOG_ERROR("Rtmp aggregate size fail - type(%d) size(%u) rest(%zu)", typeId, bodySize, dataSize - offset);
+      return false;
+    }
+
+    if (isFirst) {
+      timestampDelta = msg->header->timestamp - timestamp;
+      isFirst = false;
+    }
+
+    if (bodySize > 0) {
+      auto header = std::make_shared<RtmpMuxMsgHeader>(msg->header->chunkStreamId, timestamp + timestampDelta, typeId,
+                                                       msg->header->streamId, bodySize);
+      msgs.push_back(std::make_shared<ImportMsg>(header, BufferPool::Alloc(data + offset, bodySize)));
+    }
+
+    // back pointer(previous size) is not checked, some encoders write 0
+    offset += bodySize + Rtmp::AggregateBackPointerSize;
+  }
+
+  return true;
+}
@@ -7,19 +7,17 @@
 
 //====================================================================================================
 // ImportStream
+//  - header : last completed message header
+//  - msgHeader/body : message being reassembled(pooled body sized from bodySize at the first chunk)
 //====================================================================================================
 struct ImportStream {
 public:
-  ImportStream()
-      : header(std::make_shared<RtmpMuxMsgHeader>()), timestampDelta(0), isEextend(false), writeChunkDataSize(0),
-        writeBufferSize(0), buffer(std::make_shared<std::vector<uint8_t>>(1024 * 1024)) {}
-
-  std::shared_ptr<RtmpMuxMsgHeader> header;
-  uint32_t timestampDelta;
-  bool isEextend;
-  int writeChunkDataSize;
-  int writeBufferSize;
-  std::shared_ptr<std::vector<uint8_t>> buffer;
+  RtmpMuxMsgHeader header;
+  uint32_t timestampDelta = 0;
+  bool isEextend = false;
+  int writeChunkDataSize = 0;
+  RtmpMuxMsgHeader msgHeader;
+  std::shared_ptr<std::vector<uint8_t>> body = nullptr;
 };
 
 //====================================================================================================
@@ -47,15 +45,17 @@ public:
   std::shared_ptr<ImportMsg> GetMessage();
   void SetChunkSize(int chunkSize) { _chunkSize = chunkSize; }
 
+  // aggregate message -> sub messages(false : broken body)
+  static bool SplitAggregateMsg(const std::shared_ptr<ImportMsg> &msg, std::vector<std::shared_ptr<ImportMsg>> &msgs);
+
 private:
-  std::shared_ptr<ImportStream> GetStream(uint32_t chunkStreamId);
-  std::shared_ptr<RtmpMuxMsgHeader> GetMessageHeader(const std::shared_ptr<ImportStream> &stream,
-                                                     const std::shared_ptr<Rtmp::ChunkHeader> &chunkHeader);
-  bool AppendChunk(const std::shared_ptr<ImportStream> &stream, const uint8_t *chunk, int headerSize, int dataSize);
-  bool CompletedChunkMessage(const std::shared_ptr<ImportStream> &stream);
+  ImportStream &GetStream(uint32_t chunkStreamId);
+  RtmpMuxMsgHeader GetMessageHeader(const ImportStream &stream, const Rtmp::ChunkHeader &chunkHeader);
+  bool AppendChunk(ImportStream &stream, const uint8_t *chunkData, int dataSize);
+  void CompletedChunkMessage(ImportStream &stream);
 
 private:
-  std::map<uint32_t, std::shared_ptr<ImportStream>> _streamMap;
+  std::map<uint32_t, ImportStream> _streamMap;
   std::deque<std::shared_ptr<ImportMsg>> _importMessageQueue;
   int _chunkSize;
 };
\ No newline at end of file
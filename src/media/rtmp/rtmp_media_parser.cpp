@@ -1,4 +1,5 @@
 ﻿#include "rtmp_media_parser.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <unordered_map>
@@ -12,6 +13,7 @@ std::shared_ptr<H264Config> MediaParser::H264SeqParse(const std::shared_ptr<std:
   bitop.Skip(40);
 
   auto info = std::make_shared<H264Config>();
+  info->codecId = static_cast<uint8_t>(VideoCodecId::H264);
 
   // Save avcConfiguration data
   info->avcConf = std::make_shared<std::vector<uint8_t>>(avcSeqHeader->begin() + 5, avcSeqHeader->end());
@@ -68,6 +70,261 @@ std::shared_ptr<H264Config> MediaParser::H264SeqParse(const std::shared_ptr<std:
   return info;
 }
 
+//====================================================================================================
+// Video sequence header parse(legacy avc/hevc, enhanced hvc1/av01)
+//  - nullptr : unsupported codec or broken configuration record
+//====================================================================================================
+std::shared_ptr<H264Config> MediaParser::VideoSeqParse(const std::shared_ptr<std::vector<uint8_t>> &videoSeqHeader) {
+  if (videoSeqHeader->size() <= VideoFrameIndex ||
+      !IsVideoSequenceHeader(videoSeqHeader->data(), videoSeqHeader->size())) {
+    return nullptr;
+  }
+
+  try {
+    switch (GetVideoCodecId(videoSeqHeader->data(), videoSeqHeader->size())) {
+    case VideoCodecId::H264:
+      return H264SeqParse(videoSeqHeader);
+    case VideoCodecId::Hevc:
+      return HevcSeqParse(videoSeqHeader);
+    case VideoCodecId::Av1:
+      return Av1SeqParse(videoSeqHeader);
+    default:
+      return nullptr;
+    }
+  } catch (const std::exception &e) {
+    LOG_ERROR("Video sequence header parse fail - error(%s)", e.what());
+    return nullptr;
+  }
+}
+
+//====================================================================================================
+// HEVC sequence header parse
+//  - header(5) HEVCDecoderConfigurationRecord
+//  - version(8) profile space(2) tier(1) profile(5) compatibility(32) constraint(48) level(8) ... (23 byte)
+//  - numOfArrays(8) [type(8) numNalus(16) [size(16) nal]*]*
+//====================================================================================================
+std::shared_ptr<H264Config> MediaParser::HevcSeqParse(const std::shared_ptr<std::vector<uint8_t>> &hevcSeqHeader) {
+  Bitop bitop(hevcSeqHeader, VideoFrameIndex * 8);
+
+  auto info = std::make_shared<H264Config>();
+  info->codecId = static_cast<uint8_t>(VideoCodecId::Hevc);
+  info->avcConf =
+      std::make_shared<std::vector<uint8_t>>(hevcSeqHeader->begin() + VideoFrameIndex, hevcSeqHeader->end());
+
+  info->confVersion = bitop.Read(8);
+  bitop.Skip(3); // profile space, tier
+  info->profile = bitop.Read(5);
+  info->compatibility = bitop.Read(8); // first 8 of 32 compatibility flags
+  bitop.Skip(24 + 48);
+  info->level = bitop.Read(8) / 30.0f;
+  bitop.Skip(16 + 8 + 8 + 8 + 8 + 16 + 8); // ... lengthSizeMinusOne
+
+  const uint32_t numOfArrays = bitop.Read(8);
+  for (uint32_t i = 0; i < numOfArrays; ++i) {
+    const uint32_t nalType = bitop.Read(8) & 0x3f;
+    const uint32_t numNalus = bitop.Read(16);
+
+    for (uint32_t j = 0; j < numNalus; ++j) {
+      const uint32_t nalSize = bitop.Read(16);
+      const auto offset = bitop.GetBitOffset() / 8;
+      bitop.Skip(nalSize * 8);
+
+      if (nalType == 33 && info->width == 0) { // SPS
+        ParseHevcSPS(info, GetRbsp(hevcSeqHeader->data() + offset, nalSize));
+      }
+    }
+  }
+
+  return info;
+}
+
+//====================================================================================================
+// HEVC SPS parse(width/height)
+//====================================================================================================
+void MediaParser::ParseHevcSPS(const std::shared_ptr<H264Config> &info,
+                               const std::shared_ptr<std::vector<uint8_t>> &spsData) {
+  Bitop bitop(spsData);
+
+  bitop.Skip(16); // NAL header
+  bitop.Skip(4);  // sps_video_parameter_set_id
+  const uint32_t maxSubLayersMinus1 = bitop.Read(3);
+  bitop.Skip(1); // sps_temporal_id_nesting_flag
+
+  // profile_tier_level
+  bitop.Skip(88); // general profile
+  bitop.Skip(8);  // general_level_idc
+
+  std::vector<std::pair<uint32_t, uint32_t>> subLayers(maxSubLayersMinus1);
+  for (auto &[profilePresent, levelPresent] : subLayers) {
+    profilePresent = bitop.Read(1);
+    levelPresent = bitop.Read(1);
+  }
+  if (maxSubLayersMinus1 > 0) {
+    bitop.Skip((8 - maxSubLayersMinus1) * 2);
+  }
+  for (const auto &[profilePresent, levelPresent] : subLayers) {
+    bitop.Skip((profilePresent ? 88 : 0) + (levelPresent ? 8 : 0));
+  }
+
+  ReadGolomb(bitop); // sps_seq_parameter_set_id
+  const uint32_t chromaFormatIdc = ReadGolomb(bitop);
+  if (chromaFormatIdc == 3) {
+    bitop.Skip(1); // separate_colour_plane_flag
+  }
+
+  uint32_t width = ReadGolomb(bitop);
+  uint32_t height = ReadGolomb(bitop);
+
+  if (bitop.Read(1)) { // conformance_window_flag
+    const uint32_t subWidth = (chromaFormatIdc == 1 || chromaFormatIdc == 2) ? 2 : 1;
+    const uint32_t subHeight = (chromaFormatIdc == 1) ? 2 : 1;
+    const uint32_t left = ReadGolomb(bitop);
+    const uint32_t right = ReadGolomb(bitop);
+    const uint32_t top = ReadGolomb(bitop);
+    const uint32_t bottom = ReadGolomb(bitop);
+    width -= subWidth * (left + right);
+    height -= subHeight * (top + bottom);
+  }
+
+  info->width = width;
+  info->height = height;
+}
+
+//====================================================================================================
+// AV1 sequence header parse
+//  - header(5) AV1CodecConfigurationRecord
+//  - marker(1) version(7) seq_profile(3) seq_level_idx_0(5) tier/bitdepth/chroma(8) delay(8) configOBUs
+//  - width/height from the sequence header OBU(optional in configOBUs)
+//====================================================================================================
+std::shared_ptr<H264Config> MediaParser::Av1SeqParse(const std::shared_ptr<std::vector<uint8_t>> &av1SeqHeader) {
+  Bitop bitop(av1SeqHeader, VideoFrameIndex * 8);
+
+  auto info = std::make_shared<H264Config>();
+  info->codecId = static_cast<uint8_t>(VideoCodecId::Av1);
+  info->avcConf =
+      std::make_shared<std::vector<uint8_t>>(av1SeqHeader->begin() + VideoFrameIndex, av1SeqHeader->end());
+
+  info->confVersion = bitop.Read(8) & 0x7f;
+  info->profile = bitop.Read(3);
+  const uint32_t levelIndex = bitop.Read(5);
+  info->level = 2 + (levelIndex >> 2) + (levelIndex & 0x03) / 10.0f;
+  info->compatibility = bitop.Read(8);
+  bitop.Skip(8);
+
+  // configOBUs : header(8) [extension(8)] [size(leb128)] payload
+  size_t offset = bitop.GetBitOffset() / 8;
+  const auto &data = *av1SeqHeader;
+
+  while (offset < data.size()) {
+    const uint8_t header = data[offset++];
+    const uint8_t obuType = (header >> 3) & 0x0f;
+    if (header & 0x04) {
+      offset++; // extension
+    }
+
+    size_t obuSize = data.size() - std::min(offset, data.size());
+    if (header & 0x02) {
+      obuSize = 0;
+      for (int i = 0; i < 8 && offset < data.size(); ++i) {
+        const uint8_t byte = data[offset++];
+        obuSize |= static_cast<size_t>(byte & 0x7f) << (i * 7);
+        if ((byte & 0x80) == 0) {
+          break;
+        }
+      }
+    }
+
+    if (offset + obuSize > data.size()) {
+      break;
+    }
+
+    if (obuType == 1) { // OBU_SEQUENCE_HEADER
+      ParseAv1SequenceHeader(info, std::make_shared<std::vector<uint8_t>>(data.begin() + offset,
+                                                                          data.begin() + offset + obuSize));
+      break;
+    }
+
+    offset += obuSize;
+  }
+
+  return info;
+}
+
+//====================================================================================================
+// AV1 sequence header OBU parse(width/height)
+//====================================================================================================
+void MediaParser::ParseAv1SequenceHeader(const std::shared_ptr<H264Config> &info,
+                                         const std::shared_ptr<std::vector<uint8_t>> &obuData) {
+  Bitop bitop(obuData);
+
+  bitop.Skip(3); // seq_profile
+  bitop.Skip(1); // still_picture
+  const uint32_t reducedStillPictureHeader = bitop.Read(1);
+
+  if (reducedStillPictureHeader) {
+    bitop.Skip(5); // seq_level_idx[0]
+  } else {
+    uint32_t bufferDelayLength = 0;
+    uint32_t decoderModelInfoPresent = 0;
+
+    if (bitop.Read(1)) { // timing_info_present_flag
+      bitop.Skip(32 + 32); // num_units_in_display_tick, time_scale
+      if (bitop.Read(1)) { // equal_picture_interval
+        ReadGolomb(bitop); // num_ticks_per_picture_minus_1(uvlc)
+      }
+
+      decoderModelInfoPresent = bitop.Read(1);
+      if (decoderModelInfoPresent) {
+        bufferDelayLength = bitop.Read(5) + 1;
+        bitop.Skip(32 + 5 + 5); // num_units_in_decoding_tick, removal/presentation time length
+      }
+    }
+
+    const uint32_t initialDisplayDelayPresent = bitop.Read(1);
+    const uint32_t operatingPoints = bitop.Read(5) + 1;
+
+    for (uint32_t i = 0; i < operatingPoints; ++i) {
+      bitop.Skip(12); // operating_point_idc
+      if (bitop.Read(5) > 7) {
+        bitop.Skip(1); // seq_tier
+      }
+      if (decoderModelInfoPresent && bitop.Read(1)) {
+        bitop.Skip(bufferDelayLength * 2 + 1); // decoder/encoder buffer delay, low_delay_mode_flag
+      }
+      if (initialDisplayDelayPresent && bitop.Read(1)) {
+        bitop.Skip(4); // initial_display_delay_minus_1
+      }
+    }
+  }
+
+  const uint32_t widthBits = bitop.Read(4) + 1;
+  const uint32_t heightBits = bitop.Read(4) + 1;
+
+  info->width = bitop.Read(widthBits) + 1;
+  info->height = bitop.Read(heightBits) + 1;
+}
+
+//====================================================================================================
+// RBSP(emulation prevention byte 0x000003 -> 0x0000)
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> MediaParser::GetRbsp(const uint8_t *data, size_t size) {
+  auto rbsp = std::make_shared<std::vector<uint8_t>>();
+  rbsp->reserve(size);
+
+  uint32_t zeroCount = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (zeroCount >= 2 && data[i] == 0x03) {
+      zeroCount = 0;
+      continue;
+    }
+
+    zeroCount = (data[i] == 0) ? zeroCount + 1 : 0;
+    rbsp->push_back(data[i]);
+  }
+
+  return rbsp;
+}
+
 uint32_t MediaParser::ReadGolomb(Bitop &bitop) {
   uint32_t zeros = 0;
   while (bitop.Read(1) == 0) {
@@ -1,6 +1,7 @@
 #pragma once
 #include "amf_document.h"
 #include "common/common_header.h"
+#include "rtmp_define.h"
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -20,6 +21,8 @@ struct MetaInfo {
   std::string encoder;
 };
 
+// video config(h264, hevc, av1)
+//  - codecId : Rtmp::VideoCodecId, avcConf : decoder configuration record(avcC, hvcC, av1C)
 struct H264Config {
   uint8_t profile;
   uint8_t compatibility;
@@ -108,10 +111,17 @@ private:
 class MediaParser {
 public:
   std::shared_ptr<H264Config> H264SeqParse(const std::shared_ptr<std::vector<uint8_t>> &avcSeqHeader);
+  std::shared_ptr<H264Config> HevcSeqParse(const std::shared_ptr<std::vector<uint8_t>> &hevcSeqHeader);
+  std::shared_ptr<H264Config> Av1SeqParse(const std::shared_ptr<std::vector<uint8_t>> &av1SeqHeader);
+  std::shared_ptr<H264Config> VideoSeqParse(const std::shared_ptr<std::vector<uint8_t>> &videoSeqHeader); // by codec
   std::shared_ptr<AacConfig> AacSeqParse(const std::shared_ptr<std::vector<uint8_t>> &payload);
 
 private:
   void ParseSPS(const std::shared_ptr<H264Config> &info, const std::shared_ptr<std::vector<uint8_t>> &spsData);
+  void ParseHevcSPS(const std::shared_ptr<H264Config> &info, const std::shared_ptr<std::vector<uint8_t>> &spsData);
+  void ParseAv1SequenceHeader(const std::shared_ptr<H264Config> &info,
+                              const std::shared_ptr<std::vector<uint8_t>> &obuData);
+  std::shared_ptr<std::vector<uint8_t>> GetRbsp(const uint8_t *data, size_t size); // emulation prevention remove
   std::shared_ptr<AacConfig> ReadAACSpecificConfig(const std::shared_ptr<std::vector<uint8_t>> &aacSequenceHeader);
   std::string GetAACProfileName(const std::shared_ptr<AacConfig> &info);
 
@@ -168,17 +168,17 @@ int RtmpMuxUtil::GetChunkHeaderSize(const uint8_t *rawData, int rawDataSize) {
 //====================================================================================================
 // GetChunkHeader
 //====================================================================================================
-std::tuple<std::shared_ptr<Rtmp::ChunkHeader>, int, bool> RtmpMuxUtil::GetChunkHeader(const uint8_t *rawData,
-                                                                                      int rawDataSize) {
+std::tuple<Rtmp::ChunkHeader, int, bool> RtmpMuxUtil::GetChunkHeader(const uint8_t *rawData, int rawDataSize) {
+  Rtmp::ChunkHeader chunkHeader;
+
   if (!rawData || rawDataSize == 0)
-    return {nullptr, 0, false};
+    return {chunkHeader, 0, false};
 
   int basicHeaderSize = GetBasicHeaderSizeByRawData(rawData[0]);
   int chunkHeaderSize = GetChunkHeaderSize(rawData, rawDataSize);
   if (chunkHeaderSize <= 0)
-    return {nullptr, chunkHeaderSize, false};
+    return {chunkHeader, chunkHeaderSize, false};
 
-  auto chunkHeader = std::make_shared<Rtmp::ChunkHeader>();
   bool isEextend = false;
 
   auto format = static_cast<Rtmp::ChunkFormat>(rawData[0] & Rtmp::ChunkBasicFormatTypeMask);
@@ -189,35 +189,35 @@ std::tuple<std::shared_ptr<Rtmp::ChunkHeader>, int, bool> RtmpMuxUtil::GetChunkH
   else if (chunkStreamId == 1)
     chunkStreamId = 64 + rawData[1] + rawData[2] * 256;
 
-  chunkHeader->basicHeader.formatType = format;
-  chunkHeader->basicHeader.chunkStreamId = chunkStreamId;
+  chunkHeader.basicHeader.formatType = format;
+  chunkHeader.basicHeader.chunkStreamId = chunkStreamId;
 
   const uint8_t *dataPos = rawData + basicHeaderSize;
 
   switch (format) {
   case Rtmp::ChunkFormat::Type_0:
-    chunkHeader->type_0.timestamp = ReadInt24(dataPos);
-    chunkHeader->type_0.bodySize = ReadInt24(dataPos + 3);
-    chunkHeader->type_0.typeId = dataPos[6];
-    chunkHeader->type_0.streamId = ReadInt32LE(dataPos + 7);
-    if (chunkHeader->type_0.timestamp == Rtmp::ExtendFormat) {
-      chunkHeader->type_0.timestamp = ReadInt32(dataPos + 11);
+    chunkHeader.type_0.timestamp = ReadInt24(dataPos);
+    chunkHeader.type_0.bodySize = ReadInt24(dataPos + 3);
+    chunkHeader.type_0.typeId = dataPos[6];
+    chunkHeader.type_0.streamId = ReadInt32LE(dataPos + 7);
+    if (chunkHeader.type_0.timestamp == Rtmp::ExtendFormat) {
+      chunkHeader.type_0.timestamp = ReadInt32(dataPos + 11);
       isEextend = true;
     }
     break;
   case Rtmp::ChunkFormat::Type_1:
-    chunkHeader->type_1.timestampDelta = ReadInt24(dataPos);
-    chunkHeader->type_1.bodySize = ReadInt24(dataPos + 3);
-    chunkHeader->type_1.typeId = dataPos[6];
-    if (chunkHeader->type_1.timestampDelta == Rtmp::ExtendFormat) {
-      chunkHeader->type_1.timestampDelta = ReadInt32(dataPos + 7);
+    chunkHeader.type_1.timestampDelta = ReadInt24(dataPos);
+    chunkHeader.type_1.bodySize = ReadInt24(dataPos + 3);
+    chunkHeader.type_1.typeId = dataPos[6];
+    if (chunkHeader.type_1.timestampDelta == Rtmp::ExtendFormat) {
+      chunkHeader.type_1.timestampDelta = ReadInt32(dataPos + 7);
       isEextend = true;
     }
     break;
   case Rtmp::ChunkFormat::Type_2:
-    chunkHeader->type_2.timestampDelta = ReadInt24(dataPos);
-    if (chunkHeader->type_2.timestampDelta == Rtmp::ExtendFormat) {
-      chunkHeader->type_2.timestampDelta = ReadInt32(dataPos + 3);
+    chunkHeader.type_2.timestampDelta = ReadInt24(dataPos);
+    if (chunkHeader.type_2.timestampDelta == Rtmp::ExtendFormat) {
+      chunkHeader.type_2.timestampDelta = ReadInt32(dataPos + 3);
       isEextend = true;
     }
     break;
@@ -231,76 +231,64 @@ std::tuple<std::shared_ptr<Rtmp::ChunkHeader>, int, bool> RtmpMuxUtil::GetChunkH
 }
 
 //====================================================================================================
-// MakeChunkBasicHeader
+// WriteChunkBasicHeader
 //====================================================================================================
-std::shared_ptr<std::vector<uint8_t>> RtmpMuxUtil::MakeChunkBasicHeader(Rtmp::ChunkFormat chunk_format,
-                                                                        uint32_t chunkStreamId) {
-  auto basicHeader = std::make_shared<std::vector<uint8_t>>();
+int RtmpMuxUtil::WriteChunkBasicHeader(uint8_t *output, Rtmp::ChunkFormat chunk_format, uint32_t chunkStreamId) {
+  int size = 0;
+
   if (chunkStreamId >= (64 + 256)) {
-    basicHeader->push_back(1);
+    output[size++] = 1;
     chunkStreamId -= 64;
-    basicHeader->push_back(static_cast<uint8_t>(chunkStreamId & 0xff));
+    output[size++] = static_cast<uint8_t>(chunkStreamId & 0xff);
     chunkStreamId >>= 8;
-    basicHeader->push_back(static_cast<uint8_t>(chunkStreamId & 0xff));
+    output[size++] = static_cast<uint8_t>(chunkStreamId & 0xff);
   } else if (chunkStreamId >= 64) {
-    basicHeader->push_back(0);
+    output[size++] = 0;
     chunkStreamId -= 64;
-    basicHeader->push_back(static_cast<uint8_t>(chunkStreamId & 0xff));
+    output[size++] = static_cast<uint8_t>(chunkStreamId & 0xff);
   } else {
-    basicHeader->push_back(static_cast<uint8_t>(chunkStreamId & 0x3f));
+    output[size++] = static_cast<uint8_t>(chunkStreamId & 0x3f);
   }
 
-  (*basicHeader)[0] |= static_cast<uint8_t>(chunk_format) & 0xc0;
+  output[0] |= static_cast<uint8_t>(chunk_format) & 0xc0;
 
-  return basicHeader;
+  return size;
 }
 
 //====================================================================================================
-// MakeChunkRawHeader
+// WriteChunkRawHeader
 //====================================================================================================
-std::shared_ptr<std::vector<uint8_t>> RtmpMuxUtil::MakeChunkRawHeader(const std::shared_ptr<Rtmp::ChunkHeader> &header,
-                                                                      bool isEextend) {
-  if (!header)
-    return nullptr;
+int RtmpMuxUtil::WriteChunkRawHeader(uint8_t *output, const Rtmp::ChunkHeader &header, bool isEextend) {
+  uint8_t *writePos = output;
 
-  auto basicHeader = MakeChunkBasicHeader(header->basicHeader.formatType, header->basicHeader.chunkStreamId);
-  auto rawHeader = std::make_shared<std::vector<uint8_t>>(basicHeader->begin(), basicHeader->end());
+  writePos += WriteChunkBasicHeader(writePos, header.basicHeader.formatType, header.basicHeader.chunkStreamId);
 
-  switch (header->basicHeader.formatType) {
+  switch (header.basicHeader.formatType) {
   case Rtmp::ChunkFormat::Type_0:
-    if (!isEextend)
-      WriteInt24(rawHeader, header->type_0.timestamp);
-    else
-      WriteInt24(rawHeader, Rtmp::ExtendFormat);
-    WriteInt24(rawHeader, header->type_0.bodySize);
-    rawHeader->push_back(header->type_0.typeId);
-    WriteInt32LE(rawHeader, header->type_0.streamId);
+    writePos += WriteInt24(writePos, isEextend ? Rtmp::ExtendFormat : header.type_0.timestamp);
+    writePos += WriteInt24(writePos, header.type_0.bodySize);
+    writePos += WriteInt8(writePos, header.type_0.typeId);
+    writePos += WriteInt32LE(writePos, header.type_0.streamId);
     if (isEextend)
-      WriteInt32(rawHeader, header->type_0.timestamp);
+      writePos += WriteInt32(writePos, header.type_0.timestamp);
     break;
   case Rtmp::ChunkFormat::Type_1:
-    if (!isEextend)
-      WriteInt24(rawHeader, header->type_1.timestampDelta);
-    else
-      WriteInt24(rawHeader, Rtmp::ExtendFormat);
-    WriteInt24(rawHeader, header->type_1.bodySize);
-    rawHeader->push_back(header->type_1.typeId);
+    writePos += WriteInt24(writePos, isEextend ? Rtmp::ExtendFormat : header.type_1.timestampDelta);
+    writePos += WriteInt24(writePos, header.type_1.bodySize);
+    writePos += WriteInt8(writePos, header.type_1.typeId);
     if (isEextend)
-      WriteInt32(rawHeader, header->type_1.timestampDelta);
+      writePos += WriteInt32(writePos, header.type_1.timestampDelta);
     break;
   case Rtmp::ChunkFormat::Type_2:
-    if (!isEextend)
-      WriteInt24(rawHeader, header->type_2.timestampDelta);
-    else {
-      WriteInt24(rawHeader, Rtmp::ExtendFormat);
-      WriteInt32(rawHeader, header->type_2.timestampDelta);
-    }
+    writePos += WriteInt24(writePos, isEextend ? Rtmp::ExtendFormat : header.type_2.timestampDelta);
+    if (isEextend)
+      writePos += WriteInt32(writePos, header.type_2.timestampDelta);
     break;
   default:
     break;
   }
 
-  return rawHeader;
+  return static_cast<int>(writePos - output);
 }
 
 //====================================================================================================
@@ -319,30 +307,33 @@ int RtmpMuxUtil::GetChunkDataRawSize(int chunkSize, uint32_t chunkStreamId, int
 }
 
 //====================================================================================================
-// MakeChunkRawData
+// WriteChunkRawData
+//  - output size : GetChunkDataRawSize
 //====================================================================================================
-std::shared_ptr<std::vector<uint8_t>>
-RtmpMuxUtil::MakeChunkRawData(int chunkSize, uint32_t chunkStreamId,
-                              const std::shared_ptr<std::vector<uint8_t>> &chunkData, bool isEextend, uint32_t time) {
-  if (chunkSize == 0 || chunkData->empty())
-    return nullptr;
+int RtmpMuxUtil::WriteChunkRawData(uint8_t *output, int chunkSize, uint32_t chunkStreamId, const uint8_t *chunkData,
+                                   int chunkDataSize, bool isEextend, uint32_t time) {
+  if (chunkSize == 0 || chunkDataSize == 0)
+    return 0;
+
+  uint8_t basicHeader[Rtmp::ChunkBasicHeaderSizeMax];
+  int basicHeaderSize = WriteChunkBasicHeader(basicHeader, Rtmp::ChunkFormat::Type_3, chunkStreamId);
 
   int readSize = 0;
-  int blockCount = static_cast<int>((chunkData->size() - 1) / chunkSize) + 1;
-  auto basicHeader = MakeChunkBasicHeader(Rtmp::ChunkFormat::Type_3, chunkStreamId);
-  auto chunkRawData = std::make_shared<std::vector<uint8_t>>();
+  uint8_t *writePos = output;
 
-  for (int index = 0; index < blockCount; ++index) {
-    if (index > 0) {
-      chunkRawData->insert(chunkRawData->end(), basicHeader->begin(), basicHeader->end());
+  while (readSize < chunkDataSize) {
+    if (readSize > 0) {
+      std::memcpy(writePos, basicHeader, basicHeaderSize);
+      writePos += basicHeaderSize;
       if (isEextend)
-        WriteInt32(chunkRawData, time);
+        writePos += WriteInt32(writePos, time);
     }
 
-    int size = std::min(static_cast<int>(chunkData->size()) - readSize, chunkSize);
-    chunkRawData->insert(chunkRawData->end(), chunkData->data() + readSize, chunkData->data() + readSize + size);
+    int size = std::min(chunkDataSize - readSize, chunkSize);
+    std::memcpy(writePos, chunkData + readSize, size);
+    writePos += size;
     readSize += size;
   }
 
-  return chunkRawData;
-}
\ No newline at end of file
+  return static_cast<int>(writePos - output);
+}
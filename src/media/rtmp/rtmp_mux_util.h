@@ -53,9 +53,11 @@ public:
     static int GetBasicHeaderSizeByRawData(uint8_t nData);
     static int GetBasicHeaderSizeByChunkStreamID(uint32_t chunkStreamId);
     static int GetChunkHeaderSize(const uint8_t* rawData, int rawDataSize);
-    static std::tuple<std::shared_ptr<Rtmp::ChunkHeader>, int, bool> GetChunkHeader(const uint8_t* rawData, int rawDataSize);
-    static std::shared_ptr<std::vector<uint8_t>> MakeChunkBasicHeader(Rtmp::ChunkFormat chunk_format, uint32_t chunkStreamId);
-    static std::shared_ptr<std::vector<uint8_t>> MakeChunkRawHeader(const std::shared_ptr<Rtmp::ChunkHeader>& chunkHeader, bool isEextend);
+    static std::tuple<Rtmp::ChunkHeader, int, bool> GetChunkHeader(const uint8_t* rawData, int rawDataSize);
     static int GetChunkDataRawSize(int chunkSize, uint32_t chunkStreamId, int chunkDataSize, bool isEextend);
-    static std::shared_ptr<std::vector<uint8_t>> MakeChunkRawData(int chunkSize, uint32_t chunkStreamId, const std::shared_ptr<std::vector<uint8_t>>& chunkData, bool isEextend, uint32_t time);
+
+    // write into caller buffer, return written size
+    static int WriteChunkBasicHeader(uint8_t* output, Rtmp::ChunkFormat chunk_format, uint32_t chunkStreamId); // max ChunkBasicHeaderSizeMax
+    static int WriteChunkRawHeader(uint8_t* output, const Rtmp::ChunkHeader& chunkHeader, bool isEextend);     // max PacketHeaderSizeMax
+    static int WriteChunkRawData(uint8_t* output, int chunkSize, uint32_t chunkStreamId, const uint8_t* chunkData, int chunkDataSize, bool isEextend, uint32_t time); // GetChunkDataRawSize
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+namespace Ts {
+
+// PACKET
+constexpr int PacketSize = 188;
+constexpr int PacketHeaderSize = 4;
+constexpr int PacketPayloadSize = PacketSize - PacketHeaderSize;
+constexpr uint8_t SyncByte = 0x47;
+
+// PID
+constexpr uint16_t PatPid = 0x0000;
+constexpr uint16_t PmtPid = 0x1000;
+constexpr uint16_t VideoPid = 0x0100;
+constexpr uint16_t AudioPid = 0x0101;
+
+// PMT
+constexpr uint16_t ProgramNumber = 0x0001;
+constexpr uint8_t StreamTypeH264 = 0x1b;
+constexpr uint8_t StreamTypeAac = 0x0f;
+
+// PES
+constexpr uint8_t VideoStreamId = 0xe0;
+constexpr uint8_t AudioStreamId = 0xc0;
+
+constexpr uint64_t ClockRate = 90; // 90kHz, per ms
+
+} // namespace Ts
@@ -0,0 +1,359 @@
+#include "ts_muxer.h"
+#include "media/rtmp/rtmp_mux_util.h"
+#include <cstring>
+
+static constexpr uint8_t StartCode[] = {0x00, 0x00, 0x00, 0x01};
+static constexpr uint8_t AccessUnitDelimiter[] = {0x00, 0x00, 0x00, 0x01, 0x09, 0xf0};
+
+//====================================================================================================
+// Init
+//====================================================================================================
+bool TsMuxer::Init(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (mediaInfo == nullptr) {
+    return false;
+  }
+
+  _isVideo = mediaInfo->videoSeqHeader != nullptr && InitVideo(mediaInfo->videoSeqHeader);
+  _isAudio = mediaInfo->audioSeqHeader != nullptr && InitAudio(mediaInfo->audioSeqHeader);
+  _pesBuffer.reserve(512 * 1024);
+
+  return _isVideo || _isAudio;
+}
+
+//====================================================================================================
+// Init video
+//  - Control(1) Type(1) CompositionTime(3) AVCDecoderConfigurationRecord
+//  - version(1) profile(1) compatibility(1) level(1) lengthSizeMinusOne(1) numSps(1) [size(2) sps]* numPps(1) [...]*
+//====================================================================================================
+bool TsMuxer::InitVideo(const std::shared_ptr<std::vector<uint8_t>> &seqHeader) {
+  const auto &data = *seqHeader;
+  if (data.size() < 11 || (data[0] & 0x0f) != 7 || data[1] != 0) {
+    return false;
+  }
+
+  _nalLengthSize = (data[9] & 0x03) + 1;
+  _parameterSets.clear();
+
+  size_t offset = 10;
+  for (int setType = 0; setType < 2; ++setType) {
+    if (offset >= data.size()) {
+      return false;
+    }
+
+    int count = setType == 0 ? (data[offset] & 0x1f) : data[offset];
+    offset++;
+
+    for (int index = 0; index < count; ++index) {
+      if (offset + 2 > data.size()) {
+        return false;
+      }
+
+      size_t size = RtmpMuxUtil::ReadInt16(data.data() + offset);
+      offset += 2;
+      if (offset + size > data.size()) {
+        return false;
+      }
+
+      _parameterSets.insert(_parameterSets.end(), std::begin(StartCode), std::end(StartCode));
+      _parameterSets.insert(_parameterSets.end(), data.begin() + offset, data.begin() + offset + size);
+      offset += size;
+    }
+  }
+
+  return !_parameterSets.empty();
+}
+
+//====================================================================================================
+// Init audio
+//  - Control(1) Type(1) AudioSpecificConfig(objectType(5) sampleIndex(4) channelConfig(4))
+//====================================================================================================
+bool TsMuxer::InitAudio(const std::shared_ptr<std::vector<uint8_t>> &seqHeader) {
+  const auto &data = *seqHeader;
+  if (data.size() < 4 || (data[0] >> 4) != 10 || data[1] != 0) {
+    return false;
+  }
+
+  _aacObjectType = data[2] >> 3;
+  _aacSampleIndex = ((data[2] & 0x07) << 1) | (data[3] >> 7);
+  _aacChannelConfig = (data[3] >> 3) & 0x0f;
+
+  // ADTS profile is 2 bits(object type 1 ~ 4)
+  return _aacObjectType >= 1 && _aacObjectType <= 4;
+}
+
+//====================================================================================================
+// Write PAT/PMT
+//====================================================================================================
+void TsMuxer::WriteTable(std::vector<uint8_t> &output) {
+  // PAT
+  std::vector<uint8_t> pat = {0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1, 0x00, 0x00};
+  pat.push_back(Ts::ProgramNumber >> 8);
+  pat.push_back(Ts::ProgramNumber & 0xff);
+  pat.push_back(0xe0 | (Ts::PmtPid >> 8));
+  pat.push_back(Ts::PmtPid & 0xff);
+  WriteSection(output, Ts::PatPid, _patCounter, pat);
+
+  // PMT
+  const uint16_t pcrPid = _isVideo ? Ts::VideoPid : Ts::AudioPid;
+  const int streamCount = (_isVideo ? 1 : 0) + (_isAudio ? 1 : 0);
+  const uint8_t sectionLength = 9 + 5 * streamCount + 4;
+
+  std::vector<uint8_t> pmt = {0x02, 0xb0, sectionLength, Ts::ProgramNumber >> 8, Ts::ProgramNumber & 0xff, 0xc1, 0x00,
+                              0x00};
+  pmt.push_back(0xe0 | (pcrPid >> 8));
+  pmt.push_back(pcrPid & 0xff);
+  pmt.push_back(0xf0);
+  pmt.push_back(0x00);
+
+  if (_isVideo) {
+    pmt.insert(pmt.end(), {Ts::StreamTypeH264, 0xe0 | (Ts::VideoPid >> 8), Ts::VideoPid & 0xff, 0xf0, 0x00});
+  }
+  if (_isAudio) {
+    pmt.insert(pmt.end(), {Ts::StreamTypeAac, 0xe0 | (Ts::AudioPid >> 8), Ts::AudioPid & 0xff, 0xf0, 0x00});
+  }
+  WriteSection(output, Ts::PmtPid, _pmtCounter, pmt);
+}
+
+//====================================================================================================
+// Write video
+//  - Control(1) Type(1) CompositionTime(3) [NalLength(n) Nal]*
+//====================================================================================================
+bool TsMuxer::WriteVideo(std::vector<uint8_t> &output, uint64_t timestamp, const std::vector<uint8_t> &data) {
+  if (!_isVideo || data.size() <= 5 || (data[0] & 0x0f) != 7 || data[1] != 1) {
+    return false;
+  }
+
+  int32_t compositionTime = static_cast<int32_t>(RtmpMuxUtil::ReadInt24(data.data() + 2));
+  if (compositionTime & 0x800000) {
+    compositionTime |= static_cast<int32_t>(0xff000000);
+  }
+
+  const bool isKey = IsKeyFrame(data);
+
+  _pesBuffer.resize(MaxPesHeaderSize);
+  _pesBuffer.insert(_pesBuffer.end(), std::begin(AccessUnitDelimiter), std::end(AccessUnitDelimiter));
+  if (isKey) {
+    _pesBuffer.insert(_pesBuffer.end(), _parameterSets.begin(), _parameterSets.end());
+  }
+
+  const auto esStart = _pesBuffer.size();
+  size_t offset = 5;
+
+  while (offset + _nalLengthSize <= data.size()) {
+    size_t nalSize = 0;
+    for (int index = 0; index < _nalLengthSize; ++index) {
+      nalSize = (nalSize << 8) | data[offset + index];
+    }
+    offset += _nalLengthSize;
+
+    if (nalSize == 0 || offset + nalSize > data.size()) {
+      break;
+    }
+
+    // AUD is written above
+    if ((data[offset] & 0x1f) != 9) {
+      _pesBuffer.insert(_pesBuffer.end(), std::begin(StartCode), std::end(StartCode));
+      _pesBuffer.insert(_pesBuffer.end(), data.begin() + offset, data.begin() + offset + nalSize);
+    }
+    offset += nalSize;
+  }
+
+  if (_pesBuffer.size() == esStart) {
+    return false;
+  }
+
+  const uint64_t dts = timestamp * Ts::ClockRate;
+  const uint64_t pts = (static_cast<int64_t>(timestamp) + compositionTime < 0)
+                           ? dts
+                           : (timestamp + compositionTime) * Ts::ClockRate;
+
+  WritePes(output, Ts::VideoPid, Ts::VideoStreamId, _videoCounter, true, isKey, pts, dts);
+  return true;
+}
+
+//====================================================================================================
+// Write audio
+//  - Control(1) Type(1) Raw AAC -> ADTS(7) + Raw AAC
+//====================================================================================================
+bool TsMuxer::WriteAudio(std::vector<uint8_t> &output, uint64_t timestamp, const std::vector<uint8_t> &data) {
+  if (!_isAudio || data.size() <= 2 || (data[0] >> 4) != 10 || data[1] != 1) {
+    return false;
+  }
+
+  const size_t frameSize = 7 + data.size() - 2;
+  if (frameSize > 0x1fff) {
+    return false;
+  }
+
+  _pesBuffer.resize(MaxPesHeaderSize + 7);
+  auto *adts = _pesBuffer.data() + MaxPesHeaderSize;
+  adts[0] = 0xff;
+  adts[1] = 0xf1; // MPEG-4, no crc
+  adts[2] = static_cast<uint8_t>(((_aacObjectType - 1) << 6) | ((_aacSampleIndex & 0x0f) << 2) |
+                                 ((_aacChannelConfig >> 2) & 0x01));
+  adts[3] = static_cast<uint8_t>(((_aacChannelConfig & 0x03) << 6) | ((frameSize >> 11) & 0x03));
+  adts[4] = static_cast<uint8_t>((frameSize >> 3) & 0xff);
+  adts[5] = static_cast<uint8_t>(((frameSize & 0x07) << 5) | 0x1f);
+  adts[6] = 0xfc;
+  _pesBuffer.insert(_pesBuffer.end(), data.begin() + 2, data.end());
+
+  const uint64_t pts = timestamp * Ts::ClockRate;
+  WritePes(output, Ts::AudioPid, Ts::AudioStreamId, _audioCounter, !_isVideo, !_isVideo, pts, pts);
+  return true;
+}
+
+//====================================================================================================
+// Write section(PAT/PMT, one packet)
+//====================================================================================================
+void TsMuxer::WriteSection(std::vector<uint8_t> &output, uint16_t pid, uint8_t &counter,
+                           const std::vector<uint8_t> &section) {
+  auto packetStart = output.size();
+  output.resize(packetStart + Ts::PacketSize, 0xff);
+  auto *packet = output.data() + packetStart;
+
+  packet[0] = Ts::SyncByte;
+  packet[1] = 0x40 | ((pid >> 8) & 0x1f);
+  packet[2] = pid & 0xff;
+  packet[3] = 0x10 | (counter & 0x0f);
+  packet[4] = 0x00; // pointer field
+  counter = (counter + 1) & 0x0f;
+
+  std::memcpy(packet + 5, section.data(), section.size());
+  RtmpMuxUtil::WriteInt32(packet + 5 + section.size(), static_cast<int>(Crc32(section.data(), section.size())));
+}
+
+//====================================================================================================
+// Write pes
+//  - pes header is written in front of the es(_pesBuffer reserved area)
+//====================================================================================================
+void TsMuxer::WritePes(std::vector<uint8_t> &output, uint16_t pid, uint8_t streamId, uint8_t &counter, bool isPcr,
+                       bool isKey, uint64_t pts, uint64_t dts) {
+  const bool isDts = pts != dts;
+  const size_t headerSize = isDts ? MaxPesHeaderSize : MaxPesHeaderSize - 5;
+  const size_t esSize = _pesBuffer.size() - MaxPesHeaderSize;
+  const size_t packetLength = headerSize - 6 + esSize;
+
+  auto *header = _pesBuffer.data() + (MaxPesHeaderSize - headerSize);
+  header[0] = 0x00;
+  header[1] = 0x00;
+  header[2] = 0x01;
+  header[3] = streamId;
+  // video : 0(unbounded)
+  const bool isUnbounded = streamId == Ts::VideoStreamId || packetLength > 0xffff;
+  RtmpMuxUtil::WriteInt16(header + 4, static_cast<int16_t>(isUnbounded ? 0 : packetLength));
+  header[6] = 0x80;
+  header[7] = isDts ? 0xc0 : 0x80;
+  header[8] = static_cast<uint8_t>(headerSize - 9);
+
+  WriteTimestamp(header + 9, isDts ? 0x03 : 0x02, pts);
+  if (isDts) {
+    WriteTimestamp(header + 14, 0x01, dts);
+  }
+
+  WritePackets(output, pid, counter, header, headerSize + esSize, isPcr, isKey, dts);
+}
+
+//====================================================================================================
+// Write ts packets
+//  - first packet : adaptation field(random access/pcr)
+//  - last packet : adaptation field stuffing
+//====================================================================================================
+void TsMuxer::WritePackets(std::vector<uint8_t> &output, uint16_t pid, uint8_t &counter, const uint8_t *data,
+                           size_t size, bool isPcr, bool isKey, uint64_t pcr) {
+  output.reserve(output.size() + (size / Ts::PacketPayloadSize + 2) * Ts::PacketSize);
+
+  size_t offset = 0;
+  bool isFirst = true;
+
+  while (offset < size) {
+    auto packetStart = output.size();
+    output.resize(packetStart + Ts::PacketSize);
+    auto *packet = output.data() + packetStart;
+
+    packet[0] = Ts::SyncByte;
+    packet[1] = (isFirst ? 0x40 : 0x00) | ((pid >> 8) & 0x1f);
+    packet[2] = pid & 0xff;
+    packet[3] = 0x10 | (counter & 0x0f);
+    counter = (counter + 1) & 0x0f;
+
+    uint8_t adaptationFlags = 0;
+    if (isFirst && isKey) {
+      adaptationFlags |= 0x40; // random access
+    }
+    if (isFirst && isPcr) {
+      adaptationFlags |= 0x10;
+    }
+
+    // length(1) + flags(1) + pcr(6)
+    size_t adaptationSize = adaptationFlags == 0 ? 0 : ((adaptationFlags & 0x10) ? 8 : 2);
+    const size_t remainSize = size - offset;
+    if (adaptationSize + remainSize < Ts::PacketPayloadSize) {
+      adaptationSize = Ts::PacketPayloadSize - remainSize;
+    }
+
+    if (adaptationSize > 0) {
+      packet[3] |= 0x20;
+      packet[4] = static_cast<uint8_t>(adaptationSize - 1);
+
+      if (adaptationSize > 1) {
+        auto *field = packet + 5;
+        *field++ = adaptationFlags;
+
+        if (adaptationFlags & 0x10) {
+          const uint64_t base = pcr & 0x1ffffffffULL;
+          *field++ = static_cast<uint8_t>(base >> 25);
+          *field++ = static_cast<uint8_t>(base >> 17);
+          *field++ = static_cast<uint8_t>(base >> 9);
+          *field++ = static_cast<uint8_t>(base >> 1);
+          *field++ = static_cast<uint8_t>(((base & 0x01) << 7) | 0x7e);
+          *field++ = 0x00;
+        }
+
+        std::memset(field, 0xff, packet + Ts::PacketHeaderSize + adaptationSize - field);
+      }
+    }
+
+    const size_t payloadSize = Ts::PacketPayloadSize - adaptationSize;
+    std::memcpy(packet + Ts::PacketHeaderSize + adaptationSize, data + offset, payloadSize);
+
+    offset += payloadSize;
+    isFirst = false;
+  }
+}
+
+//====================================================================================================
+// Write pes timestamp(33bit)
+//====================================================================================================
+int TsMuxer::WriteTimestamp(uint8_t *output, uint8_t prefix, uint64_t timestamp) {
+  timestamp &= 0x1ffffffffULL;
+
+  output[0] = static_cast<uint8_t>((prefix << 4) | ((timestamp >> 29) & 0x0e) | 0x01);
+  output[1] = static_cast<uint8_t>(timestamp >> 22);
+  output[2] = static_cast<uint8_t>(((timestamp >> 14) & 0xfe) | 0x01);
+  output[3] = static_cast<uint8_t>(timestamp >> 7);
+  output[4] = static_cast<uint8_t>(((timestamp << 1) & 0xfe) | 0x01);
+  return 5;
+}
+
+//====================================================================================================
+// CRC32(MPEG-2)
+//====================================================================================================
+uint32_t TsMuxer::Crc32(const uint8_t *data, size_t size) {
+  static const auto table = []() {
+    std::vector<uint32_t> values(256);
+    for (uint32_t index = 0; index < 256; ++index) {
+      uint32_t crc = index << 24;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : (crc << 1);
+      }
+      values[index] = crc;
+    }
+    return values;
+  }();
+
+  uint32_t crc = 0xffffffff;
+  for (size_t index = 0; index < size; ++index) {
+    crc = (crc << 8) ^ table[((crc >> 24) ^ data[index]) & 0xff];
+  }
+  return crc;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "media/rtmp/rtmp_media_parser.h"
+#include "ts_define.h"
+#include <memory>
+#include <vector>
+
+//====================================================================================================
+// TsMuxer(H.264/AAC -> MPEG-TS)
+//  - input is the rtmp message body(flv tag body), AVCC -> Annex-B(AUD + SPS/PPS on key frame), raw AAC -> ADTS
+//  - one pes per frame, pcr on the video pid(audio pid for audio only)
+//  - not thread safe(one muxer per segmenter)
+//====================================================================================================
+class TsMuxer {
+public:
+  TsMuxer() = default;
+  ~TsMuxer() = default;
+
+  bool Init(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  bool IsVideo() const { return _isVideo; }
+  bool IsAudio() const { return _isAudio; }
+
+  // segment start(PAT/PMT)
+  void WriteTable(std::vector<uint8_t> &output);
+  // return false : skip(sequence header, unsupported codec, broken data)
+  bool WriteVideo(std::vector<uint8_t> &output, uint64_t timestamp, const std::vector<uint8_t> &data);
+  bool WriteAudio(std::vector<uint8_t> &output, uint64_t timestamp, const std::vector<uint8_t> &data);
+
+  static bool IsKeyFrame(const std::vector<uint8_t> &data) { return !data.empty() && (data[0] >> 4) == 1; }
+
+private:
+  static constexpr size_t MaxPesHeaderSize = 19; // start code(3) + stream id(1) + length(2) + flag(3) + pts/dts(10)
+
+  bool InitVideo(const std::shared_ptr<std::vector<uint8_t>> &seqHeader);
+  bool InitAudio(const std::shared_ptr<std::vector<uint8_t>> &seqHeader);
+  void WriteSection(std::vector<uint8_t> &output, uint16_t pid, uint8_t &counter, const std::vector<uint8_t> &section);
+  void WritePes(std::vector<uint8_t> &output, uint16_t pid, uint8_t streamId, uint8_t &counter, bool isPcr, bool isKey,
+                uint64_t pts, uint64_t dts);
+  void WritePackets(std::vector<uint8_t> &output, uint16_t pid, uint8_t &counter, const uint8_t *data, size_t size,
+                    bool isPcr, bool isKey, uint64_t pcr);
+  static int WriteTimestamp(uint8_t *output, uint8_t prefix, uint64_t timestamp);
+  static uint32_t Crc32(const uint8_t *data, size_t size);
+
+private:
+  bool _isVideo = false;
+  bool _isAudio = false;
+
+  // h264
+  int _nalLengthSize = 4;
+  std::vector<uint8_t> _parameterSets; // annex-b sps/pps
+
+  // aac(AudioSpecificConfig)
+  uint8_t _aacObjectType = 2;
+  uint8_t _aacSampleIndex = 4;
+  uint8_t _aacChannelConfig = 2;
+
+  uint8_t _patCounter = 0;
+  uint8_t _pmtCounter = 0;
+  uint8_t _videoCounter = 0;
+  uint8_t _audioCounter = 0;
+
+  std::vector<uint8_t> _pesBuffer; // [MaxPesHeaderSize reserved][es], reused per frame
+};
@@ -24,10 +24,14 @@ void ContextPool::Run() {
   }
 
   for (uint32_t index = 0; index < poolCount; ++index) {
-    auto context = std::make_shared<Context>();
+    auto context = std::make_shared<Context>(cpuSet.empty() ? -1 : cpuSet[index % cpuSet.size()], busyPollTime);
     contextList.push_back(context);
   }
 
+  if (!cpuSet.empty() || busyPollTime != 0) {
+    LOG_INFO("Network pool cpu(%zu) busy poll(%uus)", cpuSet.size(), busyPollTime);
+  }
+
   isRun = true;
 }
 
@@ -48,17 +52,144 @@ void ContextPool::Stop() {
 
 //====================================================================================================
 // GetContext
+//  - private contexts(private accepter) are skipped, equal load goes round robin
 //====================================================================================================
 std::shared_ptr<boost::asio::io_context> ContextPool::GetContext() {
   if (!isRun) {
     return nullptr;
   }
 
-  if (ioContextIndex >= poolCount) {
-    ioContextIndex = privateIoContextIndex;
+  std::lock_guard<std::mutex> lock(loadLock);
+  return contextList[GetIdleIndex()]->ioContext;
+}
+
+//====================================================================================================
+// GetStreamContext
+//  - the stream keeps its context while (load <= idlest * 2 + StreamAffinityLoadGap), then moves to the idlest
+//====================================================================================================
+std::shared_ptr<boost::asio::io_context> ContextPool::GetStreamContext(const std::string &streamPath) {
+  if (!isRun) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(loadLock);
+
+  auto idleIndex = GetIdleIndex();
+  auto &index = streamContextMap.try_emplace(streamPath, idleIndex).first->second;
+
+  if (GetLoadScore(index) > GetLoadScore(idleIndex) * 2 + StreamAffinityLoadGap) {
+    LOG_INFO("Network stream context move - stream(%s) context(%u -> %u)", streamPath.c_str(), index, idleIndex);
+    index = idleIndex;
+  }
+
+  return contextList[index]->ioContext;
+}
+
+//====================================================================================================
+// ReleaseStreamContext
+//====================================================================================================
+void ContextPool::ReleaseStreamContext(const std::string &streamPath) {
+  std::lock_guard<std::mutex> lock(loadLock);
+  streamContextMap.erase(streamPath);
+}
+
+//====================================================================================================
+// GetContextLoad
+//====================================================================================================
+std::shared_ptr<ContextLoad> ContextPool::GetContextLoad(const boost::asio::io_context &ioContext) {
+  for (const auto &context : contextList) {
+    if (context->ioContext.get() == &ioContext) {
+      return context->load;
+    }
+  }
+
+  return nullptr;
+}
+
+//====================================================================================================
+// GetTimingWheel
+//====================================================================================================
+std::shared_ptr<TimingWheel> ContextPool::GetTimingWheel(const boost::asio::io_context &ioContext) {
+  for (const auto &context : contextList) {
+    if (context->ioContext.get() == &ioContext) {
+      return context->timingWheel;
+    }
   }
 
-  return contextList[ioContextIndex++ % poolCount]->ioContext;
+  return nullptr;
+}
+
+//====================================================================================================
+// GetLoadString
+//  - index:connection/rate(kbps)/unsent(byte)
+//====================================================================================================
+std::string ContextPool::GetLoadString() {
+  std::lock_guard<std::mutex> lock(loadLock);
+  UpdateLoad();
+
+  std::string loadString;
+  for (uint32_t index = 0; index < contextList.size(); ++index) {
+    const auto &load = contextList[index]->load;
+    loadString += (index == 0 ? "" : " ") + std::to_string(index) + ":" + std::to_string(load->connectionCount) +
+                  "/" + std::to_string(load->sendRate * 8 / 1000) + "/" + std::to_string(load->sendBufferSize);
+  }
+
+  return loadString + " stream(" + std::to_string(streamContextMap.size()) + ")";
+}
+
+//====================================================================================================
+// UpdateLoad
+//  - egress rate per second(callers only)
+//====================================================================================================
+void ContextPool::UpdateLoad() {
+  auto currentTime = GetCurrentMs();
+  if (currentTime - loadCheckTime < 1000) {
+    return;
+  }
+
+  for (auto &context : contextList) {
+    auto &load = *context->load;
+    auto sendTraffic = load.sendTraffic.load();
+
+    load.sendRate =
+        loadCheckTime == 0 ? 0 : (sendTraffic - load.lastSendTraffic) * 1000 / (currentTime - loadCheckTime);
+    load.lastSendTraffic = sendTraffic;
+  }
+
+  loadCheckTime = currentTime;
+}
+
+//====================================================================================================
+// GetLoadScore
+//====================================================================================================
+uint64_t ContextPool::GetLoadScore(uint32_t index) const {
+  const auto &load = *contextList[index]->load;
+  return std::max<int32_t>(load.connectionCount, 0) * ConnectionLoadSize + load.sendRate +
+         std::max<int64_t>(load.sendBufferSize, 0);
+}
+
+//====================================================================================================
+// GetIdleIndex
+//====================================================================================================
+uint32_t ContextPool::GetIdleIndex() {
+  UpdateLoad();
+
+  auto startIndex = privateIoContextIndex < poolCount ? privateIoContextIndex : 0;
+  auto count = poolCount - startIndex;
+  auto offset = ioContextIndex++;
+
+  auto idleIndex = startIndex + offset % count;
+  auto idleScore = GetLoadScore(idleIndex);
+
+  for (uint32_t step = 1; step < count; ++step) {
+    auto index = startIndex + (offset + step) % count;
+    if (auto score = GetLoadScore(index); score < idleScore) {
+      idleIndex = index;
+      idleScore = score;
+    }
+  }
+
+  return idleIndex;
 }
 
 //====================================================================================================
@@ -74,4 +205,24 @@ std::shared_ptr<boost::asio::io_context> ContextPool::GetPrivateContext() {
   return contextList[index]->ioContext;
 }
 
+//====================================================================================================
+// GetSharedContexts
+//  - every context not taken by GetPrivateContext(reuse port acceptor per context)
+//====================================================================================================
+std::vector<std::shared_ptr<boost::asio::io_context>> ContextPool::GetSharedContexts() {
+  std::vector<std::shared_ptr<boost::asio::io_context>> contexts;
+
+  if (!isRun) {
+    return contexts;
+  }
+
+  auto startIndex = privateIoContextIndex < poolCount ? privateIoContextIndex : 0;
+
+  for (auto index = startIndex; index < poolCount; ++index) {
+    contexts.push_back(contextList[index]->ioContext);
+  }
+
+  return contexts;
+}
+
 } // namespace Network
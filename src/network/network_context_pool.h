@@ -1,19 +1,66 @@
 ﻿#pragma once
 #include "common/common_header.h"
 #include "network_header.h"
+#include "network_timing_wheel.h"
 #include <atomic>
 #include <boost/asio.hpp>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
 namespace Network {
 
+//====================================================================================================
+// Context load
+//  - updated by the tcp objects of the context(atomic), rate is calculated by the pool
+//====================================================================================================
+struct ContextLoad {
+  std::atomic<int32_t> connectionCount{0};
+  std::atomic<int64_t> sendBufferSize{0}; // byte, unsent(queue depth)
+  std::atomic<uint64_t> sendTraffic{0};   // byte, accumulated
+  uint64_t sendRate = 0;                  // byte/sec, pool loadLock
+  uint64_t lastSendTraffic = 0;           // pool loadLock
+};
+
+//====================================================================================================
+// Context
+//  - cpu : pinned cpu(-1: inherit the creator thread)
+//  - busyPollTime : us, poll() spin before the blocking run_one()(0: run())
+//  - timingWheel : connection timeouts of the context, one tick timer
+//====================================================================================================
 struct Context {
-  Context() {
+  Context(int cpu = -1, uint32_t busyPollTime = 0) {
     ioContext = std::make_shared<boost::asio::io_context>();
     work = std::make_shared<boost::asio::io_context::work>(*ioContext);
-    thread = std::make_shared<std::thread>([this]() { ioContext->run(); });
+    timingWheel->Start(*ioContext);
+    thread = std::make_shared<std::thread>([this, cpu, busyPollTime]() {
+      if (cpu >= 0 && !SetCurrentThreadCpuSet({cpu})) {
+        LOG_WARN("Network context cpu set fail - cpu(%d)", cpu);
+      }
+
+      if (busyPollTime == 0) {
+        ioContext->run();
+      } else {
+        RunBusyPoll(busyPollTime);
+      }
+    });
+  }
+
+  void RunBusyPoll(uint32_t busyPollTime) {
+    const auto spinTime = std::chrono::microseconds(busyPollTime);
+    auto idleStart = std::chrono::steady_clock::now();
+
+    while (!ioContext->stopped()) {
+      if (ioContext->poll() != 0) {
+        idleStart = std::chrono::steady_clock::now();
+      } else if (std::chrono::steady_clock::now() - idleStart >= spinTime) {
+        ioContext->run_one();
+        idleStart = std::chrono::steady_clock::now();
+      }
+    }
   }
 
   void Stop() {
@@ -21,15 +68,20 @@ struct Context {
     if (thread && thread->joinable()) {
       thread->join();
     }
+    timingWheel->Stop();
   }
 
   std::shared_ptr<boost::asio::io_context> ioContext;
   std::shared_ptr<boost::asio::io_context::work> work;
   std::shared_ptr<std::thread> thread;
+  std::shared_ptr<ContextLoad> load = std::make_shared<ContextLoad>();
+  std::shared_ptr<TimingWheel> timingWheel = std::make_shared<TimingWheel>();
 };
 
 //====================================================================================================
 // Network::ContextPool
+//  - GetContext : least loaded shared context(connections + egress rate + unsent data)
+//  - GetStreamContext : players of a stream gather on one context until it is much busier than the idlest
 //====================================================================================================
 class ContextPool {
 public:
@@ -40,14 +92,39 @@ public:
   void Stop();
   std::shared_ptr<boost::asio::io_context> GetContext();
   std::shared_ptr<boost::asio::io_context> GetPrivateContext();
+  std::vector<std::shared_ptr<boost::asio::io_context>> GetSharedContexts();
+  std::shared_ptr<boost::asio::io_context> GetStreamContext(const std::string &streamPath);
+  void ReleaseStreamContext(const std::string &streamPath);
+  std::shared_ptr<ContextLoad> GetContextLoad(const boost::asio::io_context &ioContext);
+  std::shared_ptr<TimingWheel> GetTimingWheel(const boost::asio::io_context &ioContext);
+  std::string GetLoadString();
   bool IsRun() const { return isRun; }
 
+  // before Run
+  void SetCpuSet(const std::vector<int> &cpuSet) { this->cpuSet = cpuSet; } // context index % size
+  void SetBusyPollTime(uint32_t busyPollTime) { this->busyPollTime = busyPollTime; }
+  uint32_t GetBusyPollTime() const { return busyPollTime; }
+
+  static constexpr uint64_t ConnectionLoadSize = 128 * 1024;          // byte/sec, expected traffic of a connection
+  static constexpr uint64_t StreamAffinityLoadGap = 8 * 1024 * 1024; // byte/sec
+
+private:
+  void UpdateLoad(); // loadLock
+  uint64_t GetLoadScore(uint32_t index) const;
+  uint32_t GetIdleIndex(); // loadLock
+
 private:
   std::vector<std::shared_ptr<Context>> contextList;
   uint32_t poolCount;
   uint32_t privateIoContextIndex = 0;
   std::atomic<uint32_t> ioContextIndex{0};
   bool isRun = false;
+  std::vector<int> cpuSet;
+  uint32_t busyPollTime = 0; // us(SO_BUSY_POLL + poll spin)
+
+  std::map<std::string, uint32_t> streamContextMap; // stream path, context index
+  uint64_t loadCheckTime = 0;                        // ms
+  std::mutex loadLock;
 };
 
 } // namespace Network
@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include "common/buffer_pool.h"
 #include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/asio/steady_timer.hpp>
@@ -16,6 +17,8 @@ constexpr int DefaultTrafficCheckTimeInterval = 30;    // milliseconds
 constexpr int DefaultPostCloseTimerInterval = 1;       // milliseconds
 constexpr int DefaultCloseTimerInterval = 50;          // milliseconds
 constexpr int DefaultTimeoutCheckTimerInterval = 1000; // milliseconds
+constexpr size_t MaxSendGatherCount = 64;              // buffers per write(asio max iov per syscall)
+constexpr size_t MaxSendGatherSize = 256 * 1024;       // bytes per write
 
 enum class Timer {
   KeepaliveSend,
@@ -28,10 +31,23 @@ enum class Timer {
 //====================================================================================================
 struct SendData {
   time_t sendTime = 0;
+  uint64_t queueTime = 0; // ms(PostSend)
   std::shared_ptr<std::vector<uint8_t>> data = nullptr;
+  size_t offset = 0; // send range [offset, offset + size) of data
+  size_t size = 0;
+  std::shared_ptr<const uint8_t> memory = nullptr; // mapped file range(data not used)
 
   SendData(bool isDataCopy, const std::shared_ptr<std::vector<uint8_t>> &data_)
-      : data(isDataCopy ? std::make_shared<std::vector<uint8_t>>(data_->begin(), data_->end()) : data_) {}
+      : data(isDataCopy ? BufferPool::Alloc(data_->data(), data_->size()) : data_), size(data_->size()) {}
+
+  // part of a shared buffer(no copy)
+  SendData(const std::shared_ptr<std::vector<uint8_t>> &data_, size_t offset_, size_t size_)
+      : data(data_), offset(offset_), size(size_) {}
+
+  // memory kept by its owner until sent(no copy)
+  SendData(const std::shared_ptr<const uint8_t> &memory_, size_t size_) : size(size_), memory(memory_) {}
+
+  const uint8_t *GetData() const { return memory ? memory.get() + offset : data->data() + offset; }
 };
 
 enum class ConnectedResult {
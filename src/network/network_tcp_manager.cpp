@@ -1,12 +1,13 @@
 ﻿#include "network_tcp_manager.h"
 #include "common/common_header.h"
+#include <sys/socket.h>
 
 namespace Network {
 
 TcpManager::TcpManager(int objectKey, const std::string &objectName, const std::shared_ptr<NetEvent> &event)
     : Manager(objectKey, objectName, event) {}
 
-TcpManager::~TcpManager() { _acceptSocket = nullptr; }
+TcpManager::~TcpManager() { _accepters.clear(); }
 
 void TcpManager::PostRelease() {
   _isClosing = true;
@@ -16,13 +17,16 @@ void TcpManager::PostRelease() {
 void TcpManager::Release() {
   RemoveAll();
 
-  if (_acceptor != nullptr) {
-    _acceptor->close();
-    _acceptor = nullptr;
-  }
+  for (auto &accepter : _accepters) {
+    boost::system::error_code error;
+
+    if (accepter.acceptor != nullptr) {
+      accepter.acceptor->close(error);
+    }
 
-  if (_acceptSocket != nullptr) {
-    _acceptSocket->close();
+    if (accepter.socket != nullptr) {
+      accepter.socket->close(error);
+    }
   }
 }
 
@@ -40,6 +44,10 @@ bool TcpManager::Create(std::shared_ptr<ContextPool> servicePool, int listenPort
   return true;
 }
 
+//====================================================================================================
+// Insert
+//  - shard round robin, free slot(FIFO) or a new slot at the end of the shard
+//====================================================================================================
 int TcpManager::Insert(std::shared_ptr<TcpObject> object, bool recvTimeout, uint32_t timeout) {
   int indexKey = -1;
 
@@ -48,61 +56,65 @@ int TcpManager::Insert(std::shared_ptr<TcpObject> object, bool recvTimeout, uint
     return -1;
   }
 
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
+  auto shardIndex = _insertShard++ % SlotShardCount;
 
-  if (_indexKey >= INT_MAX) {
-    _indexKey = 0;
-  }
-
-  if (_netObjects.count(_indexKey) != 0) {
-    bool findIndex = false;
+  // --- Lock Block ---
+  {
+    auto &shard = _slotShards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.lock);
 
-    for (int index = _indexKey; index < INT_MAX; index++) {
-      if (_netObjects.count(index) == 0) {
-        _indexKey = index;
-        findIndex = true;
-        break;
-      }
-    }
+    uint32_t position = 0;
 
-    if (!findIndex) {
+    if (!shard.freeList.empty()) {
+      position = shard.freeList.front();
+      shard.freeList.pop_front();
+    } else if (shard.slots.size() * SlotShardCount + shardIndex <= SlotIndexMask) {
+      position = static_cast<uint32_t>(shard.slots.size());
+      shard.slots.emplace_back();
+    } else {
       LOG_ERROR("Insert - indexKey over - manager(%s)", _objectName.c_str());
+      return -1;
     }
-  }
 
-  if (_netObjects.count(_indexKey) != 0) {
-    LOG_ERROR("Insert - exist indexKey - manager(%s)", _objectName.c_str());
-    return -1;
+    auto &slot = shard.slots[position];
+    slot.object = object;
+    indexKey = MakeIndexKey(position * SlotShardCount + shardIndex, slot.generation);
   }
 
-  _netObjects.emplace(_indexKey, object);
-  indexKey = _indexKey;
-  object->SetIndexKey(_indexKey);
+  _indexKey = indexKey;
+  object->SetIndexKey(indexKey);
+
+  auto count = ++_objectCount;
+  auto maxCount = _maxCreatingCount.load();
+  while (count > maxCount && !_maxCreatingCount.compare_exchange_weak(maxCount, count)) {
+  }
 
-  if (_netObjects.size() > _maxCreatingCount) {
-    _maxCreatingCount = static_cast<uint32_t>(_netObjects.size());
+  if (_servicePool != nullptr) {
+    object->SetContextPool(_servicePool);
   }
 
+  bool result = true;
+
   if (!object->Start()) {
     LOG_ERROR("Insert - object start fail - manager(%s)", _objectName.c_str());
-    indexKey = -1;
+    result = false;
   }
 
-  if (recvTimeout && timeout != 0 && indexKey != -1) {
+  if (recvTimeout && timeout != 0 && result) {
     object->SetRecvTimeout(timeout);
   }
 
   if (!object->IsOpened()) {
     LOG_ERROR("Insert - object socket close - manager(%s)", _objectName.c_str());
-    indexKey = -1;
+    result = false;
   }
 
-  if (indexKey == -1) {
+  if (!result) {
     object->PostClose();
-    _netObjects.erase(_indexKey);
+    Find(indexKey, true);
+    return -1;
   }
 
-  _indexKey++;
   return indexKey;
 }
 
@@ -116,6 +128,30 @@ bool TcpManager::PostConnect(const std::string &ip, int port, std::shared_ptr<Tc
   return true;
 }
 
+bool TcpManager::ResolveConnect(const std::string &host, int port,
+                                std::shared_ptr<TcpConnectedParam> connectedParam) {
+  boost::system::error_code error;
+  boost::asio::ip::make_address(host, error);
+  if (!error) {
+    return PostConnect(host, port, connectedParam);
+  }
+
+  auto resolver = std::make_shared<boost::asio::ip::tcp::resolver>(*(_servicePool->GetContext()));
+  resolver->async_resolve(
+      boost::asio::ip::tcp::v4(), host, std::to_string(port),
+      [this, resolver, connectedParam, host, port](const boost::system::error_code &error,
+                                                   const boost::asio::ip::tcp::resolver::results_type &results) {
+        if (error || results.empty()) {
+          OnConnected(error ? error : boost::asio::error::host_not_found, nullptr, connectedParam, host, port);
+          return;
+        }
+
+        PostConnect(results.begin()->endpoint().address().to_string(), port, connectedParam);
+      });
+
+  return true;
+}
+
 void TcpManager::OnConnected(const boost::system::error_code &error,
                              std::shared_ptr<boost::asio::ip::tcp::socket> socket,
                              std::shared_ptr<TcpConnectedParam> connectedParam, const std::string &ip, int port) {
@@ -145,52 +181,104 @@ void TcpManager::OnConnected(const boost::system::error_code &error,
   }
 }
 
+//====================================================================================================
+// PostAccept
+//  - reuse port : the kernel spreads connections over the acceptors, no single accept loop
+//====================================================================================================
 bool TcpManager::PostAccept() {
-  if (_acceptor == nullptr) {
+  std::vector<std::shared_ptr<boost::asio::io_context>> contexts;
+
+  if (_isReusePort && !_isPrivateAccepter) {
+    contexts = _servicePool->GetSharedContexts();
+  } else {
+    contexts.push_back(_isPrivateAccepter ? _servicePool->GetPrivateContext() : _servicePool->GetContext());
+  }
+
+  for (const auto &context : contexts) {
     try {
       boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), _listenPort);
 
-      _acceptor = std::make_shared<boost::asio::ip::tcp::acceptor>(
-          _isPrivateAccepter ? *(_servicePool->GetPrivateContext()) : *(_servicePool->GetContext()));
+      auto acceptor = std::make_shared<boost::asio::ip::tcp::acceptor>(*context);
 
-      _acceptor->open(endpoint.protocol());
-      _acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(false));
-      _acceptor->bind(endpoint);
-      _acceptor->listen();
+      acceptor->open(endpoint.protocol());
+      acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(false));
+      if (_isReusePort) {
+        int on = 1;
+        if (setsockopt(acceptor->native_handle(), SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+          LOG_ERROR("PostAccept - reuse port fail - manager(%s) error(%d)", _objectName.c_str(), errno);
+          return false;
+        }
+      }
+      acceptor->bind(endpoint);
+      acceptor->listen();
+
+      _accepters.push_back({acceptor, nullptr});
     } catch (const std::exception &e) {
       LOG_ERROR("PostAccept - accept ready(Listen) fail - manager(%s) error(%s)", _objectName.c_str(), e.what());
       return false;
     }
   }
 
-  if (_acceptSocket != nullptr) {
+  for (size_t index = 0; index < _accepters.size(); ++index) {
+    if (!AsyncAccept(index)) {
+      return false;
+    }
+  }
+
+  if (_isReusePort) {
+    LOG_INFO("PostAccept - reuse port - manager(%s) port(%d) acceptor(%zu)", _objectName.c_str(), _listenPort,
+             _accepters.size());
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// AsyncAccept
+//  - reuse port : socket is made on the acceptor context(accepted on its serving thread)
+//====================================================================================================
+bool TcpManager::AsyncAccept(size_t index) {
+  auto &accepter = _accepters[index];
+
+  if (accepter.acceptor == nullptr) {
+    return false;
+  }
+
+  if (accepter.socket != nullptr) {
     LOG_WARN("PostAccept - _acceptSocket not null - manager(%s)", _objectName.c_str());
-    _acceptSocket->close();
-    _acceptSocket = nullptr;
+    accepter.socket->close();
+    accepter.socket = nullptr;
   }
 
-  _acceptSocket = std::make_shared<boost::asio::ip::tcp::socket>(*_servicePool->GetContext());
+  if (_isReusePort && !_isPrivateAccepter) {
+    accepter.socket = std::make_shared<boost::asio::ip::tcp::socket>(
+        static_cast<boost::asio::io_context &>(accepter.acceptor->get_executor().context()));
+  } else {
+    accepter.socket = std::make_shared<boost::asio::ip::tcp::socket>(*_servicePool->GetContext());
+  }
 
-  _acceptor->async_accept(*_acceptSocket, [this](const boost::system::error_code &error) { OnAccept(error); });
+  accepter.acceptor->async_accept(*accepter.socket,
+                                  [this, index](const boost::system::error_code &error) { OnAccept(error, index); });
 
   return true;
 }
 
-void TcpManager::OnAccept(const boost::system::error_code &error) {
+void TcpManager::OnAccept(const boost::system::error_code &error, size_t index) {
   std::string ip;
   int port = 0;
+  auto &acceptSocket = _accepters[index].socket;
 
   if (error) {
     LOG_ERROR("OnAccept - manager(%s) error(%d) message(%s)", _objectName.c_str(), error.value(),
               error.message().c_str());
 
-    if (_acceptSocket != nullptr) {
-      _acceptSocket->close();
-      _acceptSocket = nullptr;
+    if (acceptSocket != nullptr) {
+      acceptSocket->close();
+      acceptSocket = nullptr;
     }
 
     if (!_isClosing) {
-      PostAccept();
+      AsyncAccept(index);
     }
 
     return;
@@ -202,43 +290,48 @@ void TcpManager::OnAccept(const boost::system::error_code &error) {
 
   if (auto netEvent = _netEvent.lock()) {
     try {
-      ip = _acceptSocket->remote_endpoint().address().to_v4().to_string();
-      port = _acceptSocket->remote_endpoint().port();
+      ip = acceptSocket->remote_endpoint().address().to_v4().to_string();
+      port = acceptSocket->remote_endpoint().port();
     } catch (const std::exception &e) {
       LOG_ERROR("OnAccept - socket exception - manager(%s) error(%s)", _objectName.c_str(), e.what());
 
-      if (_acceptSocket != nullptr) {
-        _acceptSocket->close();
-        _acceptSocket = nullptr;
+      if (acceptSocket != nullptr) {
+        acceptSocket->close();
+        acceptSocket = nullptr;
       }
 
       if (!_isClosing) {
-        PostAccept();
+        AsyncAccept(index);
       }
       return;
     }
 
-    if (!netEvent->OnAccepted(_objectKey, _acceptSocket, ip, port)) {
+    if (!netEvent->OnAccepted(_objectKey, acceptSocket, ip, port)) {
       LOG_ERROR("OnAccept - accepted callback fail - manager(%s)", _objectName.c_str());
 
-      if (_acceptSocket != nullptr) {
+      if (acceptSocket != nullptr) {
         LOG_ERROR("OnAccept - socket not null - manager(%s)", _objectName.c_str());
-        _acceptSocket->close();
-        _acceptSocket = nullptr;
+        acceptSocket->close();
+        acceptSocket = nullptr;
       }
     }
   }
 
-  _acceptSocket = nullptr;
-  PostAccept();
+  acceptSocket = nullptr;
+  AsyncAccept(index);
 }
 
 int TcpManager::FindIndexKey(const std::string &ip, int port) {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
+  for (uint32_t shardIndex = 0; shardIndex < SlotShardCount; ++shardIndex) {
+    auto &shard = _slotShards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    for (uint32_t position = 0; position < shard.slots.size(); ++position) {
+      const auto &slot = shard.slots[position];
 
-  for (const auto &[indexKey, object] : _netObjects) {
-    if (object->GetRemoteIp() == ip && object->GetRemotePort() == port) {
-      return indexKey;
+      if (slot.object != nullptr && slot.object->GetRemoteIp() == ip && slot.object->GetRemotePort() == port) {
+        return MakeIndexKey(position * SlotShardCount + shardIndex, slot.generation);
+      }
     }
   }
 
@@ -247,20 +340,67 @@ int TcpManager::FindIndexKey(const std::string &ip, int port) {
 
 bool TcpManager::IsConnected(const std::string &ip, int port) { return FindIndexKey(ip, port) != -1; }
 
+//====================================================================================================
+// Find
+//  - O(1), only the shard of the slot is locked
+//  - stale indexKey(generation mismatch) : nullptr
+//====================================================================================================
 std::shared_ptr<TcpObject> TcpManager::Find(int indexKey, bool erase) {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
+  if (indexKey < 0) {
+    return nullptr;
+  }
 
-  if (_netObjects.count(indexKey) != 0) {
-    auto object = _netObjects[indexKey];
+  auto slotIndex = static_cast<uint32_t>(indexKey) & SlotIndexMask;
+  auto generation = static_cast<uint32_t>(indexKey) >> SlotIndexBits;
+  auto position = slotIndex / SlotShardCount;
+  auto &shard = _slotShards[slotIndex % SlotShardCount];
 
-    if (erase) {
-      _netObjects.erase(indexKey);
-    }
+  std::lock_guard<std::mutex> lock(shard.lock);
+
+  if (position >= shard.slots.size()) {
+    return nullptr;
+  }
+
+  auto &slot = shard.slots[position];
 
-    return object;
+  if (slot.object == nullptr || slot.generation != generation) {
+    return nullptr;
   }
 
-  return nullptr;
+  return erase ? ReleaseSlot(shard, position) : slot.object;
+}
+
+//====================================================================================================
+// ReleaseSlot(shard lock)
+//  - generation up : keys of the closed object are stale from now
+//====================================================================================================
+std::shared_ptr<TcpObject> TcpManager::ReleaseSlot(SlotShard &shard, uint32_t position) {
+  auto &slot = shard.slots[position];
+  auto object = std::move(slot.object);
+
+  slot.object = nullptr;
+  slot.generation = (slot.generation + 1) & SlotGenerationMask;
+  shard.freeList.push_back(position);
+  --_objectCount;
+
+  return object;
+}
+
+std::vector<std::shared_ptr<TcpObject>> TcpManager::GetObjects() const {
+  std::vector<std::shared_ptr<TcpObject>> objects;
+  objects.reserve(_objectCount);
+
+  for (const auto &shard : _slotShards) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    for (const auto &slot : shard.slots) {
+      if (slot.object != nullptr) {
+        objects.push_back(slot.object);
+      }
+    }
+  }
+
+  return objects;
 }
 
 bool TcpManager::Remove(int indexKey) {
@@ -281,27 +421,24 @@ void TcpManager::Remove(const std::vector<int> &indexKeys) {
 }
 
 void TcpManager::RemoveAll() {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
+  for (auto &shard : _slotShards) {
+    std::lock_guard<std::mutex> lock(shard.lock);
 
-  for (auto &[indexKey, object] : _netObjects) {
-    object->Close();
+    for (uint32_t position = 0; position < shard.slots.size(); ++position) {
+      if (shard.slots[position].object != nullptr) {
+        ReleaseSlot(shard, position)->Close();
+      }
+    }
   }
-
-  _netObjects.clear();
 }
 
-uint32_t TcpManager::GetCount() const {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
-  return static_cast<uint32_t>(_netObjects.size());
-}
+uint32_t TcpManager::GetCount() const { return _objectCount; }
 
 std::pair<uint64_t, uint64_t> TcpManager::GetTotalTrafficRate(bool init) {
   uint64_t totalSendBitrate = 0;
   uint64_t totalRecvBitrate = 0;
 
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
-
-  for (const auto &[key, object] : _netObjects) {
+  for (const auto &object : GetObjects()) {
     auto [sendBitrate, recvBitrate] = object->GetTrafficRate(init);
     totalSendBitrate += sendBitrate;
     totalRecvBitrate += recvBitrate;
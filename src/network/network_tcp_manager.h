@@ -1,6 +1,9 @@
 ﻿#pragma once
 #include "network_manager.h"
 #include "network_tcp_object.h"
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -9,6 +12,11 @@
 
 namespace Network {
 
+//====================================================================================================
+// TcpManager
+//  - indexKey : generation(11bit) << 20 | slot index(20bit), a closed key never finds the next object
+//  - slot index % SlotShardCount : shard(lock), free slots are reused in FIFO order
+//====================================================================================================
 class TcpManager : public Manager {
 public:
   TcpManager(int objectKey, const std::string &objectName, const std::shared_ptr<NetEvent> &event);
@@ -16,7 +24,11 @@ public:
 
 public:
   virtual bool Create(std::shared_ptr<ContextPool> servicePool, int listenPort = 0, bool privateAccepter = false);
+  // before Create : one SO_REUSEPORT acceptor per shared context, accepted socket stays on that context
+  void SetReusePort(bool isReusePort) { _isReusePort = isReusePort; }
   virtual bool PostConnect(const std::string &ip, int port, std::shared_ptr<TcpConnectedParam> connectedParam);
+  // host name is resolved on every connect, a resolve failure comes back through OnConnected
+  bool ResolveConnect(const std::string &host, int port, std::shared_ptr<TcpConnectedParam> connectedParam);
 
   void Close(int indexKey) { Remove(indexKey); }
   int FindIndexKey(const std::string &ip, int port);
@@ -30,7 +42,7 @@ public:
 
   bool IsServerModule() const { return (_listenPort != 0); }
   bool IsClientModule() const { return (_listenPort == 0); }
-  int GetCurrentIndexKey() const { return _indexKey; }
+  int GetCurrentIndexKey() const { return _indexKey; } // last inserted
 
   std::pair<uint64_t, uint64_t> GetTotalTrafficRate(bool init);
   std::pair<uint64_t, uint64_t> GetTrafficRate(int indexKey, bool init);
@@ -45,22 +57,51 @@ protected:
   virtual void Release();
   virtual int Insert(std::shared_ptr<TcpObject> object, bool recvTimeout = false, uint32_t timeout = 0);
   std::shared_ptr<TcpObject> Find(int indexKey, bool erase = false);
-  virtual bool PostAccept();
-  virtual void OnAccept(const boost::system::error_code &error);
+  std::vector<std::shared_ptr<TcpObject>> GetObjects() const; // snapshot, no lock while using objects
+  virtual bool PostAccept(); // listen + accept on every accepter
+  bool AsyncAccept(size_t index);
+  virtual void OnAccept(const boost::system::error_code &error, size_t index);
   virtual void OnConnected(const boost::system::error_code &error, std::shared_ptr<boost::asio::ip::tcp::socket> socket,
                            std::shared_ptr<TcpConnectedParam> connectedParam, const std::string &ip, int port);
 
 protected:
   bool _isPrivateAccepter = false;
 
-  int _indexKey = 0;
-  uint32_t _maxCreatingCount = 0;
-  std::map<int, std::shared_ptr<TcpObject>> _netObjects;
-  mutable std::mutex _netObjectsLock;
+  static constexpr int SlotIndexBits = 20;
+  static constexpr uint32_t SlotIndexMask = (1u << SlotIndexBits) - 1;
+  static constexpr uint32_t SlotGenerationMask = (1u << (31 - SlotIndexBits)) - 1; // indexKey stays positive
+  static constexpr uint32_t SlotShardCount = 16;
+
+  struct Slot {
+    uint32_t generation = 0;
+    std::shared_ptr<TcpObject> object;
+  };
+
+  struct SlotShard {
+    mutable std::mutex lock;
+    std::vector<Slot> slots;       // slot index = position * SlotShardCount + shard
+    std::deque<uint32_t> freeList; // position
+  };
+
+  static int MakeIndexKey(uint32_t slotIndex, uint32_t generation) {
+    return static_cast<int>(((generation & SlotGenerationMask) << SlotIndexBits) | slotIndex);
+  }
+  std::shared_ptr<TcpObject> ReleaseSlot(SlotShard &shard, uint32_t position); // shard lock
+
+  std::atomic<int> _indexKey{-1};
+  std::atomic<uint32_t> _insertShard{0};
+  std::atomic<uint32_t> _objectCount{0};
+  std::atomic<uint32_t> _maxCreatingCount{0};
+  std::array<SlotShard, SlotShardCount> _slotShards;
+
+  struct Accepter {
+    std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket;
+  };
 
   int _listenPort = 0;
-  std::shared_ptr<boost::asio::ip::tcp::acceptor> _acceptor = nullptr;
-  std::shared_ptr<boost::asio::ip::tcp::socket> _acceptSocket = nullptr;
+  bool _isReusePort = false;
+  std::vector<Accepter> _accepters; // one(socket context from the pool) or one per shared context(reuse port)
   bool _isClosing = false;
 };
 
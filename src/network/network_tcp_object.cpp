@@ -1,13 +1,25 @@
 ﻿#include "network_tcp_object.h"
 #include "network_manager.h"
+#include <cstring>
 #include <iostream>
 #include <stdarg.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace Network {
 
-TcpObject::TcpObject() {}
+TcpObject::TcpObject() { _timeoutEntry.callback = [this]() { OnTimeoutEntry(); }; }
 
 TcpObject::~TcpObject() {
+  if (_timingWheel) {
+    _timingWheel->Cancel(&_timeoutEntry);
+  }
+
+  if (_contextLoad) {
+    _contextLoad->connectionCount--;
+    _contextLoad->sendBufferSize -= static_cast<int64_t>(_sendBufferSize);
+  }
+
   SendQueueRelease();
   _socket = nullptr;
 }
@@ -34,26 +46,205 @@ boost::asio::io_context &TcpObject::GetIoContext() {
   return static_cast<boost::asio::io_context &>(_socket->get_executor().context());
 }
 
+//====================================================================================================
+// SetContextPool
+//====================================================================================================
+void TcpObject::SetContextPool(const std::shared_ptr<ContextPool> &contextPool) {
+  _contextPool = contextPool;
+
+  std::lock_guard<std::mutex> send_data_lock(_sendQueueLock);
+  if (_contextLoad) {
+    return;
+  }
+
+  _contextLoad = contextPool->GetContextLoad(GetIoContext());
+  _timingWheel = contextPool->GetTimingWheel(GetIoContext());
+  if (_contextLoad) {
+    _contextLoad->connectionCount++;
+    _contextLoad->sendBufferSize += static_cast<int64_t>(_sendBufferSize);
+  }
+
+  // low latency : socket busy poll(over net.core.busy_read needs CAP_NET_ADMIN)
+  if (int busyPollTime = static_cast<int>(contextPool->GetBusyPollTime()); busyPollTime != 0 && _socket->is_open()) {
+    static std::atomic<bool> isBusyPollWarned{false};
+
+    if (setsockopt(_socket->native_handle(), SOL_SOCKET, SO_BUSY_POLL, &busyPollTime, sizeof(busyPollTime)) != 0 &&
+        !isBusyPollWarned.exchange(true)) {
+      LOG_WARN("[%s] TcpObject::SetContextPool - busy poll fail(logged once) - ip(%s) error(%d)", _objectName.c_str(),
+               _ip.c_str(), errno);
+    }
+  }
+}
+
+//====================================================================================================
+// PostMigrate
+//  - no read is pending inside RecvHandler, the socket moves after the handler returns and sends complete
+//====================================================================================================
+bool TcpObject::PostMigrate(const std::shared_ptr<boost::asio::io_context> &ioContext, std::function<void()> callback) {
+  if (ioContext == nullptr || ioContext.get() == &GetIoContext() || !_isRecvHandling || _isClosing ||
+      _migrateContext != nullptr) {
+    return false;
+  }
+
+  _migrateContext = ioContext;
+  _migrateCallback = std::move(callback);
+  return true;
+}
+
+//====================================================================================================
+// Migrate
+//  - native socket release(old reactor) -> assign(new reactor), timers are made again on the new context
+//====================================================================================================
+void TcpObject::Migrate() {
+  if (_isClosing || _migrateContext == nullptr) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> send_data_lock(_sendQueueLock);
+
+  if (!_sendQueue.empty()) {
+    _isMigrateWait = true; // OnSend
+    return;
+  }
+
+  boost::system::error_code error;
+  auto protocol = _socket->local_endpoint(error).protocol();
+  auto handle = error ? -1 : _socket->release(error);
+
+  if (error) {
+    LOG_ERROR("[%s] TcpObject::Migrate - release fail - key(%d) ip(%s) error(%s)", _objectName.c_str(), _indexKey,
+              _ip.c_str(), error.message().c_str());
+    _migrateContext = nullptr;
+    send_data_lock.unlock();
+
+    // stay on the current context
+    auto callback = std::move(_migrateCallback);
+    _migrateCallback = nullptr;
+    AsyncRecv();
+    if (callback) {
+      callback();
+    }
+    return;
+  }
+
+  auto socket = std::make_shared<boost::asio::ip::tcp::socket>(*_migrateContext);
+  socket->assign(protocol, handle, error);
+  if (error) {
+    LOG_ERROR("[%s] TcpObject::Migrate - assign fail - key(%d) ip(%s) error(%s)", _objectName.c_str(), _indexKey,
+              _ip.c_str(), error.message().c_str());
+    ::close(handle);
+    _migrateContext = nullptr;
+    _migrateCallback = nullptr;
+    send_data_lock.unlock();
+
+    _networkError = true;
+    _isClosing = true;
+    if (auto netEvent = _netEvent.lock()) {
+      netEvent->OnClosed(_objectKey, _indexKey, _ip, _port);
+    }
+    return;
+  }
+
+  _socket = socket;
+
+  if (auto contextPool = _contextPool.lock()) {
+    if (auto contextLoad = contextPool->GetContextLoad(*_migrateContext)) {
+      if (_contextLoad) {
+        _contextLoad->connectionCount--;
+      }
+      _contextLoad = contextLoad;
+      _contextLoad->connectionCount++;
+    }
+
+    if (_timingWheel) {
+      _timingWheel->Cancel(&_timeoutEntry);
+    }
+    _timingWheel = contextPool->GetTimingWheel(*_migrateContext);
+  }
+
+  _migrateContext = nullptr;
+  send_data_lock.unlock();
+
+  if (_timeout != 0) {
+    SetRecvTimeout(_timeout);
+  }
+
+  auto callback = std::move(_migrateCallback);
+  _migrateCallback = nullptr;
+
+  boost::asio::post(GetIoContext(), [self = shared_from_this(), callback = std::move(callback)]() {
+    self->AsyncRecv();
+    if (callback) {
+      callback();
+    }
+  });
+}
+
+//====================================================================================================
+// SetRecvBufferSize
+//====================================================================================================
+void TcpObject::SetRecvBufferSize(int bufferSize) {
+  if (static_cast<size_t>(bufferSize) > _recvWritePos) {
+    _recvBuffer.resize(bufferSize, 0);
+  }
+}
+
+//====================================================================================================
+// AsyncRecv
+//  - free space < DefaultSocketBufferSize : compaction(unread data to front, one copy), grow if still short
+//====================================================================================================
 void TcpObject::AsyncRecv() {
   if (_isClosing || !IsOpened()) {
     return;
   }
 
+  if (_recvBuffer.size() - _recvWritePos < DefaultSocketBufferSize) {
+    if (_recvReadPos > 0) {
+      std::memmove(_recvBuffer.data(), _recvBuffer.data() + _recvReadPos, _recvWritePos - _recvReadPos);
+      _recvWritePos -= _recvReadPos;
+      _recvReadPos = 0;
+    }
+
+    if (_recvBuffer.size() - _recvWritePos < DefaultSocketBufferSize) {
+      _recvBuffer.resize(std::max(_recvBuffer.size() * 2, _recvWritePos + DefaultSocketBufferSize));
+    }
+  }
+
   _socket->async_read_some(
-      boost::asio::buffer(*_recvBuffer),
+      boost::asio::buffer(_recvBuffer.data() + _recvWritePos, _recvBuffer.size() - _recvWritePos),
       [self = shared_from_this()](const boost::system::error_code &error, std::size_t readSize) {
         self->OnReceive(error, readSize);
       });
 }
 
-void TcpObject::AsyncSend(const std::shared_ptr<SendData> &sendData) {
+//====================================================================================================
+// AsyncSend
+//  - gather queued data(up to MaxSendGatherCount/MaxSendGatherSize) into one vectored write
+//  - queued data stays in _sendQueue until OnSend retires it
+//====================================================================================================
+void TcpObject::AsyncSend() {
   if (_isClosing || !IsOpened()) {
     return;
   }
 
-  sendData->sendTime = time(nullptr);
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(std::min(_sendQueue.size(), MaxSendGatherCount));
 
-  boost::asio::async_write(*_socket, boost::asio::buffer(*(sendData->data)),
+  size_t gatherSize = 0;
+  auto sendTime = time(nullptr);
+
+  for (const auto &sendData : _sendQueue) {
+    if (buffers.size() >= MaxSendGatherCount ||
+        (!buffers.empty() && gatherSize + sendData->size > MaxSendGatherSize)) {
+      break;
+    }
+
+    sendData->sendTime = sendTime;
+    buffers.emplace_back(sendData->GetData(), sendData->size);
+    gatherSize += sendData->size;
+  }
+
+  boost::asio::async_write(*_socket, buffers,
                            [self = shared_from_this()](const boost::system::error_code &error,
                                                        std::size_t writeSize) { self->OnSend(error, writeSize); });
 }
@@ -103,14 +294,51 @@ bool TcpObject::PostSend(std::shared_ptr<std::vector<uint8_t>> data, bool isData
     return false;
   }
 
-  auto sendData = std::make_shared<SendData>(isDataCopy, data);
+  return PushSendData(std::make_shared<SendData>(isDataCopy, data));
+}
+
+bool TcpObject::PostSend(const std::shared_ptr<std::vector<uint8_t>> &data, size_t offset, size_t size) {
+  if (!data || size == 0 || offset + size > data->size()) {
+    LOG_ERROR("[%s] TcpObject::PostSend - Range Fail - key(%d) ip(%s)", _objectName.c_str(), _indexKey, _ip.c_str());
+    return false;
+  }
+
+  if (_isClosing) {
+    LOG_INFO("[%s] TcpObject::PostSend - Closing Return - key(%d) ip(%s)", _objectName.c_str(), _indexKey, _ip.c_str());
+    return false;
+  }
+
+  return PushSendData(std::make_shared<SendData>(data, offset, size));
+}
+
+bool TcpObject::PostSend(const std::shared_ptr<const uint8_t> &memory, size_t size) {
+  if (!memory || size == 0) {
+    LOG_ERROR("[%s] TcpObject::PostSend - Memory Fail - key(%d) ip(%s)", _objectName.c_str(), _indexKey, _ip.c_str());
+    return false;
+  }
+
+  if (_isClosing) {
+    LOG_INFO("[%s] TcpObject::PostSend - Closing Return - key(%d) ip(%s)", _objectName.c_str(), _indexKey, _ip.c_str());
+    return false;
+  }
+
+  return PushSendData(std::make_shared<SendData>(memory, size));
+}
+
+bool TcpObject::PushSendData(const std::shared_ptr<SendData> &sendData) {
+  sendData->queueTime = GetCurrentMs();
 
   std::lock_guard<std::mutex> send_data_lock(_sendQueueLock);
   _sendQueue.emplace_back(sendData);
-  _sendBufferSize += data->size();
+  _sendBufferSize += sendData->size;
 
+  if (_contextLoad) {
+    _contextLoad->sendBufferSize += static_cast<int64_t>(sendData->size);
+  }
+
+  // queue not empty = write in progress
   if (_sendQueue.size() == 1) {
-    AsyncSend(_sendQueue.front());
+    AsyncSend();
   }
 
   return true;
@@ -137,18 +365,14 @@ void TcpObject::OnReceive(const boost::system::error_code &error, size_t dataSiz
   }
 
   _lastRecvTime = time(nullptr);
+  _recvWritePos += dataSize;
 
-  if (_restData && !_restData->empty()) {
-    _recvData = _restData;
-    _restData = nullptr;
-    _recvData->insert(_recvData->end(), _recvBuffer->begin(), _recvBuffer->begin() + dataSize);
-  } else {
-    _recvData = std::make_shared<std::vector<uint8_t>>(_recvBuffer->begin(), _recvBuffer->begin() + dataSize);
-  }
+  const auto unreadSize = _recvWritePos - _recvReadPos;
+  _isRecvHandling = true;
+  int procSize = RecvHandler(std::span<const uint8_t>(_recvBuffer.data() + _recvReadPos, unreadSize));
+  _isRecvHandling = false;
 
-  int procSize = RecvHandler(_recvData);
-
-  if (procSize < 0 || static_cast<size_t>(procSize) > _recvData->size()) {
+  if (procSize < 0 || static_cast<size_t>(procSize) > unreadSize) {
     LOG_ERROR("[%s] TcpObject::OnReceive - RecvHandler - key(%d) ip(%s) Result(%d)", _objectName.c_str(), _indexKey,
               _ip.c_str(), procSize);
 
@@ -161,13 +385,20 @@ void TcpObject::OnReceive(const boost::system::error_code &error, size_t dataSiz
     return;
   }
 
-  if (int restDataSize = static_cast<int>(_recvData->size()) - procSize; restDataSize > 0) {
-    _restData = std::make_shared<std::vector<uint8_t>>(_recvData->data() + procSize,
-                                                       _recvData->data() + procSize + restDataSize);
+  _recvReadPos += procSize;
+  if (_recvReadPos == _recvWritePos) {
+    _recvReadPos = 0;
+    _recvWritePos = 0;
   }
 
-  AsyncRecv();
   _recvTraffic += procSize;
+
+  if (_migrateContext != nullptr) {
+    Migrate(); // AsyncRecv on the new context
+    return;
+  }
+
+  AsyncRecv();
 }
 
 void TcpObject::OnSend(const boost::system::error_code &error, size_t dataSize) {
@@ -191,10 +422,24 @@ void TcpObject::OnSend(const boost::system::error_code &error, size_t dataSize)
   if (!_sendQueue.empty()) {
     _sendCompleteTime = time(nullptr);
     _sendBufferSize -= dataSize;
-    _sendQueue.pop_front();
+
+    if (_contextLoad) {
+      _contextLoad->sendBufferSize -= static_cast<int64_t>(dataSize);
+      _contextLoad->sendTraffic += dataSize;
+    }
+
+    // retire fully written data
+    size_t retireSize = dataSize;
+    while (!_sendQueue.empty() && _sendQueue.front()->size <= retireSize) {
+      retireSize -= _sendQueue.front()->size;
+      _sendQueue.pop_front();
+    }
 
     if (!_sendQueue.empty()) {
-      AsyncSend(_sendQueue.front());
+      AsyncSend();
+    } else if (_isMigrateWait) {
+      _isMigrateWait = false;
+      boost::asio::post(GetIoContext(), [self = shared_from_this()]() { self->Migrate(); });
     }
   }
 
@@ -208,17 +453,42 @@ void TcpObject::OnSend(const boost::system::error_code &error, size_t dataSize)
   _sendTraffic += dataSize;
 }
 
+//====================================================================================================
+// SetRecvTimeout
+//  - timing wheel of the context(deadline : last recv + timeout), no wheel : check timer(timeout / 2)
+//====================================================================================================
 void TcpObject::SetRecvTimeout(uint32_t timeout) {
   if (_timeoutTimer) {
     _timeoutTimer->cancel();
     _timeoutTimer = nullptr;
   }
 
+  if (_timingWheel) {
+    _timeout = timeout;
+    if (!_isClosing) {
+      _timingWheel->Add(&_timeoutEntry, static_cast<uint64_t>(_timeout) * 1000, weak_from_this());
+    }
+    return;
+  }
+
   _timeoutTimer = std::make_shared<boost::asio::steady_timer>(GetIoContext());
   _timeout = timeout;
   SetNetworkTimer(_timeoutTimer, Timer::TimeoutCheck, _timeout * 1000 / 2);
 }
 
+void TcpObject::CancelRecvTimeout() {
+  _timeout = 0;
+
+  if (_timeoutTimer) {
+    _timeoutTimer->cancel();
+    _timeoutTimer = nullptr;
+  }
+
+  if (_timingWheel) {
+    _timingWheel->Cancel(&_timeoutEntry);
+  }
+}
+
 void TcpObject::SetNetworkTimer(std::shared_ptr<boost::asio::steady_timer> networkTimer, Timer id, int interval) {
   if (_isClosing) {
     return;
@@ -256,14 +526,7 @@ void TcpObject::OnNetworkTimer(const boost::system::error_code &error,
     SetNetworkTimer(networkTimer, id, interval);
     break;
   case Timer::TimeoutCheck:
-    if ((time(nullptr) - _lastRecvTime) > _timeout) {
-      LOG_INFO("Network timeout - object(%s) key(%d) ip(%s) gap(%ld)", _objectName.c_str(), _indexKey, _ip.c_str(),
-               time(nullptr) - _lastRecvTime);
-      if (!_isClosing) {
-        if (auto netEvent = _netEvent.lock()) {
-          netEvent->OnClosed(_objectKey, _indexKey, _ip, _port);
-        }
-      }
+    if (!CheckRecvTimeout()) {
       return;
     }
     SetNetworkTimer(networkTimer, id, interval);
@@ -274,6 +537,33 @@ void TcpObject::OnNetworkTimer(const boost::system::error_code &error,
   }
 }
 
+bool TcpObject::CheckRecvTimeout() {
+  if (auto gap = time(nullptr) - _lastRecvTime; gap > _timeout) {
+    LOG_INFO("Network timeout - object(%s) key(%d) ip(%s) gap(%ld)", _objectName.c_str(), _indexKey, _ip.c_str(), gap);
+    if (!_isClosing) {
+      if (auto netEvent = _netEvent.lock()) {
+        netEvent->OnClosed(_objectKey, _indexKey, _ip, _port);
+      }
+    }
+    return false;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// OnTimeoutEntry
+//  - recv in the meantime : next deadline from the last recv(no re-arm per recv)
+//====================================================================================================
+void TcpObject::OnTimeoutEntry() {
+  if (_isClosing || _timeout == 0 || _timingWheel == nullptr || !CheckRecvTimeout()) {
+    return;
+  }
+
+  auto remain = static_cast<int64_t>(_timeout) - (time(nullptr) - _lastRecvTime) + 1;
+  _timingWheel->Add(&_timeoutEntry, static_cast<uint64_t>(std::max<int64_t>(remain, 1)) * 1000, weak_from_this());
+}
+
 bool TcpObject::PostCloseTimerProc() {
   if (_keepaliveSendTimer) {
     _keepaliveSendTimer->cancel();
@@ -284,6 +574,9 @@ bool TcpObject::PostCloseTimerProc() {
   if (_postCloseTimer) {
     _postCloseTimer->cancel();
   }
+  if (_timingWheel) {
+    _timingWheel->Cancel(&_timeoutEntry);
+  }
 
   if (_socket->is_open()) {
     boost::system::error_code ec;
@@ -313,6 +606,20 @@ std::pair<uint64_t, uint64_t> TcpObject::GetTrafficRate(bool init) {
   return {0, 0};
 }
 
+//====================================================================================================
+// GetSendQueueDelay
+//  - wait time(ms) of the oldest unsent data
+//====================================================================================================
+uint64_t TcpObject::GetSendQueueDelay() {
+  std::lock_guard<std::mutex> send_data_lock(_sendQueueLock);
+  if (_sendQueue.empty()) {
+    return 0;
+  }
+
+  auto curTime = GetCurrentMs();
+  return curTime > _sendQueue.front()->queueTime ? curTime - _sendQueue.front()->queueTime : 0;
+}
+
 uint64_t TcpObject::GetQosSendWaitTime(uint32_t checkBufferSize, uint32_t maxWaitTime, uint32_t megaPerWait) {
   if (_sendBufferSize < checkBufferSize) {
     return 0;
@@ -2,7 +2,9 @@
 #include "network_context_pool.h"
 #include "network_header.h"
 #include <deque>
+#include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,7 +34,8 @@ public:
   virtual bool Create(const std::shared_ptr<NetTcpParam> &param);
   virtual bool Start();
   virtual void SetRecvTimeout(uint32_t maxWaitTime);
-  void SetRecvBufferSize(int bufferSize) { _recvBuffer->resize(bufferSize, 0); }
+  void CancelRecvTimeout();
+  void SetRecvBufferSize(int bufferSize);
   void SetIndexKey(int indexKey) { _indexKey = indexKey; }
   int GetIndexKey() const { return _indexKey; }
   std::string GetRemoteIp() const { return _ip; }
@@ -40,6 +43,10 @@ public:
   virtual time_t GetCreateTime() const { return _createTime; }
   void SetLogLock(bool lock) { _logLock = lock; }
   virtual bool PostSend(std::shared_ptr<std::vector<uint8_t>> data, bool isDataCopy = false);
+  // [offset, offset + size) of a shared buffer, data must not change until sent
+  bool PostSend(const std::shared_ptr<std::vector<uint8_t>> &data, size_t offset, size_t size);
+  // memory owned outside the send buffers(mapped file), kept alive by the shared_ptr until sent
+  bool PostSend(const std::shared_ptr<const uint8_t> &memory, size_t size);
   virtual void PostClose();
   virtual void Close();
   time_t GetSendCompleteTime() const { return _sendCompleteTime; }
@@ -47,23 +54,35 @@ public:
   uint64_t GetRecvTraffic() const { return _recvTraffic; }
   uint64_t GetSendTraffic() const { return _sendTraffic; }
   uint64_t GetSendBufferSize() const { return _sendBufferSize; }
+  uint64_t GetSendQueueDelay();
   uint64_t GetQosSendWaitTime(uint32_t checkBufferSize, uint32_t maxWaitTime, uint32_t megaPerWait);
   virtual bool IsOpened() const;
 
+  // context load accounting(set by the manager at insert)
+  void SetContextPool(const std::shared_ptr<ContextPool> &contextPool);
+  // move the socket to another io_context(RecvHandler only), callback runs on the new context(current on fail)
+  //  - false : not moved(closing, same context, outside RecvHandler), caller continues on the current context
+  bool PostMigrate(const std::shared_ptr<boost::asio::io_context> &ioContext, std::function<void()> callback);
+
 protected:
   virtual void OnReceive(const boost::system::error_code &error, size_t dataSize);
   void OnSend(const boost::system::error_code &error, size_t dataSize);
   void SendQueueRelease();
+  void Migrate();
+  bool PushSendData(const std::shared_ptr<SendData> &sendData);
   void SetNetworkTimer(std::shared_ptr<boost::asio::steady_timer> networkTimer, Timer id, int interval);
   void OnNetworkTimer(const boost::system::error_code &error, std::shared_ptr<boost::asio::steady_timer> networkTimer,
                       Timer id, int interval);
   bool PostCloseTimerProc();
+  bool CheckRecvTimeout(); // false : timeout(closed event)
+  void OnTimeoutEntry();   // timing wheel
 
-  virtual int RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) = 0;
+  // data: unread region of the recv buffer(valid during the call), return: processed size(-1: error)
+  virtual int RecvHandler(std::span<const uint8_t> data) = 0;
 
   virtual boost::asio::io_context &GetIoContext();
   virtual void AsyncRecv();
-  virtual void AsyncSend(const std::shared_ptr<SendData> &sendData);
+  virtual void AsyncSend(); // _sendQueueLock
 
 protected:
   int _objectKey = -1;
@@ -78,9 +97,10 @@ protected:
   uint64_t _sendBufferSize = 0;
   std::mutex _sendQueueLock;
 
-  std::shared_ptr<std::vector<uint8_t>> _recvBuffer = std::make_shared<std::vector<uint8_t>>(8192, 0);
-  std::shared_ptr<std::vector<uint8_t>> _recvData = nullptr;
-  std::shared_ptr<std::vector<uint8_t>> _restData = nullptr;
+  // recv buffer(async_read_some writes directly, [_recvReadPos, _recvWritePos) unread)
+  std::vector<uint8_t> _recvBuffer = std::vector<uint8_t>(DefaultSocketBufferSize, 0);
+  size_t _recvReadPos = 0;
+  size_t _recvWritePos = 0;
 
   bool _isClosing = false;
   TcpKeepaliveSendCallback _keepaliveSendCallback = nullptr;
@@ -90,6 +110,8 @@ protected:
   std::shared_ptr<boost::asio::steady_timer> _keepaliveSendTimer = nullptr;
   std::shared_ptr<boost::asio::steady_timer> _timeoutTimer = nullptr;
   std::shared_ptr<boost::asio::steady_timer> _postCloseTimer = nullptr;
+  std::shared_ptr<TimingWheel> _timingWheel = nullptr; // context of the socket(pool only, else _timeoutTimer)
+  TimingWheelEntry _timeoutEntry;
 
   time_t _createTime = time(nullptr);
   time_t _sendCompleteTime = 0;
@@ -101,6 +123,14 @@ protected:
   uint64_t _sendTraffic = 0;                  // byte
   uint64_t _recvTraffic = 0;                  // byte
   int _postCloseTimeInterval = DefaultPostCloseTimerInterval;
+
+  // io_context load + migration
+  std::weak_ptr<ContextPool> _contextPool;
+  std::shared_ptr<ContextLoad> _contextLoad = nullptr;
+  std::shared_ptr<boost::asio::io_context> _migrateContext = nullptr;
+  std::function<void()> _migrateCallback = nullptr;
+  bool _isRecvHandling = false;
+  bool _isMigrateWait = false; // _sendQueueLock, migrate after the send queue is empty
 };
 
 } // namespace Network
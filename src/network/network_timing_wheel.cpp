@@ -0,0 +1,191 @@
+#include "network_timing_wheel.h"
+#include <algorithm>
+#include <vector>
+
+namespace Network {
+
+TimingWheel::TimingWheel() {}
+
+TimingWheel::~TimingWheel() {}
+
+//====================================================================================================
+// Start
+//  - tick timer on the io_context, tick N expires at start + N * TickInterval(no drift)
+//====================================================================================================
+void TimingWheel::Start(boost::asio::io_context &ioContext) {
+  std::lock_guard<std::mutex> lock(_lock);
+
+  _tickTimer = std::make_shared<boost::asio::steady_timer>(ioContext);
+  _startTime = std::chrono::steady_clock::now();
+  PostTick(_currentTick);
+}
+
+void TimingWheel::Stop() {
+  std::lock_guard<std::mutex> lock(_lock);
+
+  if (_tickTimer) {
+    _tickTimer->cancel();
+    _tickTimer = nullptr;
+  }
+}
+
+size_t TimingWheel::GetCount() const {
+  std::lock_guard<std::mutex> lock(_lock);
+  return _count;
+}
+
+//====================================================================================================
+// Add
+//  - scheduled entry is moved, minimum 1 tick
+//====================================================================================================
+void TimingWheel::Add(TimingWheelEntry *entry, uint64_t delay, const std::weak_ptr<void> &owner) {
+  std::lock_guard<std::mutex> lock(_lock);
+
+  if (entry->next != nullptr) {
+    Unlink(entry);
+  }
+
+  entry->expireTick = _currentTick + std::max<uint64_t>(1, (delay + TickInterval - 1) / TickInterval);
+  entry->owner = owner;
+  Insert(entry);
+}
+
+void TimingWheel::Cancel(TimingWheelEntry *entry) {
+  std::lock_guard<std::mutex> lock(_lock);
+
+  if (entry->next != nullptr) {
+    Unlink(entry);
+  }
+}
+
+//====================================================================================================
+// Insert
+//  - root : expire within 256 ticks, level N : within 2^(8 + 6 * (N + 1)) ticks(over : clamped to the top)
+//====================================================================================================
+void TimingWheel::Insert(TimingWheelEntry *entry) {
+  auto expireTick = std::max(entry->expireTick, _currentTick);
+  auto gap = expireTick - _currentTick;
+  Bucket *bucket = nullptr;
+
+  if (gap < RootSize) {
+    bucket = &_root[expireTick & (RootSize - 1)];
+  } else {
+    if (gap > MaxTick) {
+      expireTick = _currentTick + MaxTick;
+      gap = MaxTick;
+    }
+
+    int level = 0;
+    while (level < LevelCount - 1 && gap >= (1ull << (RootBits + LevelBits * (level + 1)))) {
+      ++level;
+    }
+
+    bucket = &_levels[level][(expireTick >> (RootBits + LevelBits * level)) & (LevelSize - 1)];
+  }
+
+  entry->expireTick = expireTick;
+  entry->prev = bucket->head.prev;
+  entry->next = &bucket->head;
+  bucket->head.prev->next = entry;
+  bucket->head.prev = entry;
+  ++_count;
+}
+
+void TimingWheel::Unlink(TimingWheelEntry *entry) {
+  entry->prev->next = entry->next;
+  entry->next->prev = entry->prev;
+  entry->prev = nullptr;
+  entry->next = nullptr;
+  --_count;
+}
+
+//====================================================================================================
+// Cascade
+//  - entries of the current slot of the level move down(root or a lower level)
+//====================================================================================================
+uint64_t TimingWheel::Cascade(int level) {
+  auto slot = (_currentTick >> (RootBits + LevelBits * level)) & (LevelSize - 1);
+  auto &head = _levels[level][slot].head;
+
+  auto entry = head.next;
+  head.prev = head.next = &head;
+
+  while (entry != &head) {
+    auto next = entry->next;
+    --_count; // Insert counts again
+    Insert(entry);
+    entry = next;
+  }
+
+  return slot;
+}
+
+uint64_t TimingWheel::GetElapsedTick() const {
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _startTime);
+  return static_cast<uint64_t>(elapsed.count()) / TickInterval;
+}
+
+void TimingWheel::PostTick(uint64_t tick) {
+  if (_tickTimer == nullptr) {
+    return;
+  }
+
+  _tickTimer->expires_at(_startTime + std::chrono::milliseconds(tick * TickInterval));
+  _tickTimer->async_wait([weakSelf = weak_from_this()](const boost::system::error_code &error) {
+    if (auto self = weakSelf.lock()) {
+      self->OnTick(error);
+    }
+  });
+}
+
+//====================================================================================================
+// OnTick
+//  - runs every tick up to now(late handler catches up), callbacks are called outside the lock
+//====================================================================================================
+void TimingWheel::OnTick(const boost::system::error_code &error) {
+  if (error) {
+    return;
+  }
+
+  std::vector<std::pair<std::shared_ptr<void>, TimingWheelEntry *>> expiredEntries;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto elapsedTick = GetElapsedTick();
+
+    while (_currentTick <= elapsedTick) {
+      auto index = _currentTick & (RootSize - 1);
+
+      if (index == 0) {
+        for (int level = 0; level < LevelCount && Cascade(level) == 0; ++level) {
+        }
+      }
+
+      auto &head = _root[index].head;
+
+      while (head.next != &head) {
+        auto entry = head.next;
+        Unlink(entry);
+
+        // owner in destruction : skip(its destructor cancel finds the entry unlinked)
+        if (auto owner = entry->owner.lock()) {
+          expiredEntries.emplace_back(std::move(owner), entry);
+        }
+      }
+
+      ++_currentTick;
+    }
+
+    PostTick(_currentTick);
+  }
+
+  for (const auto &[owner, entry] : expiredEntries) {
+    if (entry->callback) {
+      entry->callback();
+    }
+  }
+}
+
+} // namespace Network
@@ -0,0 +1,72 @@
+#pragma once
+#include "network_header.h"
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace Network {
+
+//====================================================================================================
+// Timing wheel entry(intrusive, embedded in the owner object)
+//  - callback runs on the wheel io_context while the owner is alive(weak_ptr lock)
+//====================================================================================================
+struct TimingWheelEntry {
+  TimingWheelEntry *prev = nullptr;
+  TimingWheelEntry *next = nullptr; // nullptr : not scheduled
+  uint64_t expireTick = 0;
+  std::weak_ptr<void> owner;
+  std::function<void()> callback;
+};
+
+//====================================================================================================
+// Network::TimingWheel
+//  - hierarchical(256 + 64 * 3 slots, tick 100ms), one steady_timer per io_context ticks every entry
+//  - Add/Cancel O(1), a tick walks the expired bucket only(upper levels cascade every 256 ticks)
+//====================================================================================================
+class TimingWheel : public std::enable_shared_from_this<TimingWheel> {
+public:
+  TimingWheel();
+  virtual ~TimingWheel();
+
+  void Start(boost::asio::io_context &ioContext);
+  void Stop(); // after the io_context thread is stopped
+
+  void Add(TimingWheelEntry *entry, uint64_t delay, const std::weak_ptr<void> &owner); // delay : ms, re-add moves
+  void Cancel(TimingWheelEntry *entry);
+  size_t GetCount() const;
+
+  static constexpr uint64_t TickInterval = 100; // ms
+
+private:
+  static constexpr int RootBits = 8;
+  static constexpr int LevelBits = 6;
+  static constexpr int LevelCount = 3; // above the root
+  static constexpr uint64_t RootSize = 1ull << RootBits;
+  static constexpr uint64_t LevelSize = 1ull << LevelBits;
+  static constexpr uint64_t MaxTick = (1ull << (RootBits + LevelBits * LevelCount)) - 1;
+
+  struct Bucket {
+    Bucket() { head.prev = head.next = &head; }
+    TimingWheelEntry head;
+  };
+
+  void PostTick(uint64_t tick);
+  void OnTick(const boost::system::error_code &error);
+  void Insert(TimingWheelEntry *entry); // _lock
+  void Unlink(TimingWheelEntry *entry); // _lock
+  uint64_t Cascade(int level);          // _lock, return : cascaded slot
+  uint64_t GetElapsedTick() const;
+
+private:
+  std::array<Bucket, RootSize> _root;
+  std::array<std::array<Bucket, LevelSize>, LevelCount> _levels;
+  uint64_t _currentTick = 0; // next tick to run
+  size_t _count = 0;
+  std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+  std::shared_ptr<boost::asio::steady_timer> _tickTimer = nullptr;
+  mutable std::mutex _lock;
+};
+
+} // namespace Network
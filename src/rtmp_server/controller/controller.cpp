@@ -60,6 +60,15 @@ bool Controller::OnRecv(const std::string &msg) {
 
       return OnVaildateStream(packet);
     }
+    case ServiceCmd::Restream: {
+      RestreamPacket packet;
+      if (!packet.Create(data)) {
+        std::cerr << "Failed to parse RestreamPacket" << std::endl;
+        return false;
+      }
+
+      return OnRestream(packet);
+    }
     case ServiceCmd::Error: {
       ErrorPacket packet;
       if (packet.Create(data)) {
@@ -103,6 +112,23 @@ bool Controller::OnVaildateStream(const ValidateStreamPacket &packet) {
   return true;
 }
 
+//====================================================================================================
+// Restream Handler
+//====================================================================================================
+bool Controller::OnRestream(const RestreamPacket &packet) {
+  if (packet.streamPath.empty()) {
+    return false;
+  }
+
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  event->OnControllerRestream(packet.streamPath, packet.urls);
+  return true;
+}
+
 //====================================================================================================
 // Error Handler
 //====================================================================================================
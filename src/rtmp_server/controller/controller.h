@@ -3,6 +3,7 @@
 #include "network/websocket_client.hpp"
 #include <memory>
 #include <string>
+#include <vector>
 
 const std::string ServiceName = "rtmp-server";
 
@@ -15,6 +16,7 @@ public:
 
   virtual void OnControllerStreamStart(const std::string &streamPath, const std::string &mediaId) = 0;
   virtual void OnControllerStreamStop(const std::string &streamPath) = 0;
+  virtual void OnControllerRestream(const std::string &streamPath, const std::vector<std::string> &urls) = 0;
 };
 
 //====================================================================================================
@@ -35,6 +37,7 @@ protected:
   void OnSend(std::size_t sendSize) override {};
   bool OnRecv(const std::string &msg) override;
   bool OnVaildateStream(const ValidateStreamPacket &packet);
+  bool OnRestream(const RestreamPacket &packet);
   bool OnError(const ErrorPacket &packet);
 
 private:
@@ -2,13 +2,14 @@
 #include <common/json/json.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
 //====================================================================================================
 // Command Defile
 //====================================================================================================
-enum class ServiceCmd { Connected, Error, StreamStart, VaildateStream, Unknown };
+enum class ServiceCmd { Connected, Error, StreamStart, VaildateStream, Restream, Unknown };
 
 /**
  * String to command
@@ -20,6 +21,8 @@ inline ServiceCmd GetServiceCmd(const std::string &cmd) {
     return ServiceCmd::StreamStart;
   else if (cmd == "vaildate-stream")
     return ServiceCmd::VaildateStream;
+  else if (cmd == "restream")
+    return ServiceCmd::Restream;
   else if (cmd == "error")
     return ServiceCmd::Error;
   return ServiceCmd::Unknown;
@@ -36,6 +39,8 @@ inline std::string GetServiceString(ServiceCmd cmd) {
     return "stream-start";
   case ServiceCmd::VaildateStream:
     return "vaildate-stream";
+  case ServiceCmd::Restream:
+    return "restream";
   case ServiceCmd::Error:
     return "error";
   default:
@@ -153,6 +158,38 @@ public:
   }
 };
 
+//====================================================================================================
+// Restream Packet
+//  - destination list of a stream(empty : restream stop), replaces the app config
+//====================================================================================================
+class RestreamPacket : public BasePacket {
+public:
+  std::string streamPath;
+  std::vector<std::string> urls;
+
+  bool Create(const json &data) override {
+    if (!BasePacket::Create(data))
+      return false;
+
+    if (!data.contains("streamPath") || !data.contains("urls") || !data["urls"].is_array()) {
+      std::cerr << "Invalid RestreamPacket structure - missing fields" << std::endl;
+      return false;
+    }
+
+    streamPath = data["streamPath"].get<std::string>();
+    urls = data["urls"].get<std::vector<std::string>>();
+
+    return true;
+  }
+
+  json MakeJson() const override {
+    auto data = BasePacket::MakeJson();
+    data["streamPath"] = streamPath;
+    data["urls"] = urls;
+    return data;
+  }
+};
+
 //====================================================================================================
 // Error Packet
 //====================================================================================================
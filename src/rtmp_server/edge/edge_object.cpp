@@ -0,0 +1,61 @@
+#include "edge_object.h"
+#include "common/common_header.h"
+
+//====================================================================================================
+// Create
+//====================================================================================================
+bool EdgeObject::Create(const std::shared_ptr<Network::NetTcpParam> &param) {
+  if (!Network::TcpObject::Create(param)) {
+    return false;
+  }
+
+  _stream = std::make_shared<EdgeStream>(std::static_pointer_cast<EdgeObject>(shared_from_this()), _streamPath,
+                                         _tcUrl);
+  return true;
+}
+
+//====================================================================================================
+// Play start(handshake)
+//====================================================================================================
+bool EdgeObject::PlayStart() { return _stream->Start(); }
+
+//====================================================================================================
+//  Recv Handler
+//====================================================================================================
+int EdgeObject::RecvHandler(std::span<const uint8_t> data) { return _stream->RecvHandler(data); }
+
+//====================================================================================================
+// stream send
+//====================================================================================================
+bool EdgeObject::StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data) {
+  if (!PostSend(data)) {
+    LOG_ERROR("StreamSendData - post send fail - object(%s) stream(%s)", _objectName.c_str(), _streamPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+//====================================================================================================
+// stream ready
+//====================================================================================================
+bool EdgeObject::OnStreamReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  _streamHub = _event->OnEdgeReady(_indexKey, _streamPath, mediaInfo);
+  if (_streamHub == nullptr) {
+    LOG_ERROR("OnStreamReady - ready fail - object(%s) stream(%s)", _objectName.c_str(), _streamPath.c_str());
+    return false;
+  }
+  return true;
+}
+
+//====================================================================================================
+// stream data
+//====================================================================================================
+bool EdgeObject::OnStreamData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) {
+  if (_streamHub == nullptr) {
+    LOG_ERROR("OnStreamData - stream hub none - object(%s) stream(%s)", _objectName.c_str(), _streamPath.c_str());
+    return false;
+  }
+
+  _streamHub->PushFrame(frame, isVideo);
+  return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "edge_stream.h"
+#include "network/network_tcp_object.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <memory>
+#include <string>
+
+class EdgeEvent {
+public:
+  virtual ~EdgeEvent() = default;
+
+  virtual std::shared_ptr<StreamHub> OnEdgeReady(int indexKey, const std::string &streamPath,
+                                                 const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) = 0;
+};
+
+//====================================================================================================
+// Edge Object(origin play session)
+//  - one upstream per stream, frames go to the local hub like a published stream
+//====================================================================================================
+class EdgeObject : public EdgeStreamEvent, public Network::TcpObject {
+public:
+  EdgeObject(const std::shared_ptr<EdgeEvent> &event, const std::string &streamPath, const std::string &tcUrl)
+      : _event(event), _streamPath(streamPath), _tcUrl(tcUrl) {}
+  virtual ~EdgeObject() = default;
+
+public:
+  bool Create(const std::shared_ptr<Network::NetTcpParam> &param);
+  bool PlayStart();
+  const std::string &GetStreamPath() { return _streamPath; }
+
+protected:
+  int RecvHandler(std::span<const uint8_t> data) override;
+
+  // EdgeStream implement
+  bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data);
+  bool OnStreamReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  bool OnStreamData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo);
+
+private:
+  std::shared_ptr<EdgeEvent> _event;
+  std::shared_ptr<EdgeStream> _stream;
+  std::string _streamPath;
+  std::string _tcUrl;
+  std::shared_ptr<StreamHub> _streamHub = nullptr; // resolved once at ready
+};
@@ -0,0 +1,53 @@
+#include "edge_service.h"
+#include "common/common_header.h"
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+EdgeService::EdgeService(int objectKey, const std::string &objectName,
+                         const std::shared_ptr<Network::NetEvent> &netEvent, const std::string &originHost,
+                         int originPort)
+    : Network::TcpManager(objectKey, objectName, netEvent), _originHost(originHost), _originPort(originPort) {}
+
+//====================================================================================================
+// Pull(origin connect)
+//====================================================================================================
+bool EdgeService::Pull(const std::string &streamPath) {
+  return ResolveConnect(_originHost, _originPort, std::make_shared<EdgeConnectedParam>(streamPath));
+}
+
+//====================================================================================================
+// Object 추가(Connected)
+//====================================================================================================
+int EdgeService::ConnectedAdd(const std::shared_ptr<EdgeConnectedParam> &param,
+                              const std::shared_ptr<EdgeEvent> &event) {
+  if (param->socket == nullptr) {
+    return -1;
+  }
+
+  const auto tcUrl = StringHelper::Format("rtmp://%s:%d/%s", _originHost.c_str(), _originPort,
+                                          param->streamPath.substr(0, param->streamPath.find('/')).c_str());
+
+  auto object = std::make_shared<EdgeObject>(event, param->streamPath, tcUrl);
+  if (!object->Create(std::make_shared<Network::NetTcpParam>(_objectKey, _objectName, param->socket, _netEvent))) {
+    return -1;
+  }
+
+  auto indexKey = Insert(object, true, RecvTimeout);
+  if (indexKey != -1 && !object->PlayStart()) {
+    Remove(indexKey);
+    return -1;
+  }
+
+  return indexKey;
+}
+
+//====================================================================================================
+// Get StreamPath
+//====================================================================================================
+std::string EdgeService::GetStreamPath(int indexKey) {
+  if (auto object = Find(indexKey); object != nullptr) {
+    return std::static_pointer_cast<EdgeObject>(object)->GetStreamPath();
+  }
+  return "";
+}
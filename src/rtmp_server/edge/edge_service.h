@@ -0,0 +1,31 @@
+#pragma once
+#include "edge_object.h"
+#include "network/network_tcp_manager.h"
+#include <memory>
+#include <string>
+
+struct EdgeConnectedParam : public Network::TcpConnectedParam {
+  explicit EdgeConnectedParam(const std::string &streamPath_) : streamPath(streamPath_) {}
+  std::string streamPath;
+};
+
+//====================================================================================================
+// Edge Service
+//  - rtmp play client to the origin, Pull -> OnConnected(EdgeConnectedParam) -> ConnectedAdd
+//====================================================================================================
+class EdgeService : public Network::TcpManager {
+public:
+  EdgeService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent,
+              const std::string &originHost, int originPort);
+
+  bool Pull(const std::string &streamPath);
+  int ConnectedAdd(const std::shared_ptr<EdgeConnectedParam> &param, const std::shared_ptr<EdgeEvent> &event);
+
+  std::string GetStreamPath(int indexKey);
+
+  static constexpr uint32_t RecvTimeout = 10; // sec
+
+private:
+  std::string _originHost;
+  int _originPort;
+};
@@ -0,0 +1,117 @@
+#include "edge_stream.h"
+#include <utility>
+
+constexpr double ConnectTransactionId = 1.0;
+constexpr double CreateStreamTransactionId = 2.0;
+
+//====================================================================================================
+// Constructor
+//  - stream path : app/key
+//====================================================================================================
+EdgeStream::EdgeStream(const std::shared_ptr<EdgeStreamEvent> &event, const std::string &streamPath,
+                       const std::string &tcUrl)
+    : RtmpClientSession(event, "edge", tcUrl, streamPath.substr(0, streamPath.find('/')),
+                        streamPath.find('/') != std::string::npos ? streamPath.substr(streamPath.find('/') + 1) : ""),
+      _event(event) {
+  _ingest.SetStreamPath(_streamPath);
+}
+
+//====================================================================================================
+// Handshake complete(connect)
+//====================================================================================================
+bool EdgeStream::OnHandshakeComplete() {
+  auto object = std::make_shared<AmfObject>();
+  object->AddProp("app", _streamApp.c_str());
+  object->AddProp("flashVer", "LNX 9,0,124,2");
+  object->AddProp("tcUrl", _tcUrl.c_str());
+  object->AddProp("fpad", false);
+  object->AddProp("capabilities", 15.0);
+  object->AddProp("audioCodecs", 3191.0);
+  object->AddProp("videoCodecs", 252.0);
+  object->AddProp("videoFunction", 1.0);
+
+  return SendAmfConnect(object, ConnectTransactionId);
+}
+
+//====================================================================================================
+// Chunk Message - media(audio, video, aggregate, amf0 data)
+//====================================================================================================
+bool EdgeStream::OnMediaMsg(const std::shared_ptr<ImportMsg> &msg) { return _ingest.OnMediaMsg(msg); }
+
+//====================================================================================================
+// Amf - _result
+//====================================================================================================
+bool EdgeStream::OnAmfResult(const std::shared_ptr<AmfDoc> &doc, double transactionId) {
+  if (transactionId == ConnectTransactionId) {
+    if (!SendWindowAckSize() || !SendAmfCreateStream(CreateStreamTransactionId)) {
+      LOG_ERROR("edge - send amf create stream fail - stream(%s)", _streamPath.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  if (transactionId == CreateStreamTransactionId) {
+    if (!OnAmfCreateStreamResult(doc)) {
+      return false;
+    }
+
+    if (!SendAmfPlay()) {
+      LOG_ERROR("edge - send amf play fail - stream(%s)", _streamPath.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Amf - onStatus
+//  - play error/stop : upstream end(close)
+//====================================================================================================
+bool EdgeStream::OnAmfStatus(const std::string &level, const std::string &code) {
+  if (level == "error" || code == "NetStream.Play.Stop" || code == "NetStream.Play.UnpublishNotify") {
+    return false;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Ingest - ready(video + audio config)
+//====================================================================================================
+bool EdgeStream::OnIngestReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->OnStreamReady(mediaInfo);
+}
+
+//====================================================================================================
+// Ingest - frame
+//====================================================================================================
+bool EdgeStream::OnIngestData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) {
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->OnStreamData(frame, isVideo);
+}
+
+//====================================================================================================
+// Send amf play
+//====================================================================================================
+bool EdgeStream::SendAmfPlay() {
+  auto doc = std::make_shared<AmfDoc>();
+  doc->AddProp(Rtmp::Cmd::Play);
+  doc->AddProp(0.0);
+  doc->AddProp(AmfDataType::Null);
+  doc->AddProp(_streamKey.c_str());
+
+  return SendAmfCmd(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Media), 0,
+                                                       static_cast<int>(Rtmp::MsgType::Amf0CmdMsg), _streamId, 0),
+                    doc);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "common/common_header.h"
+#include "rtmp_server/stream/rtmp_client_session.h"
+#include "rtmp_server/stream/stream_ingest.h"
+#include <memory>
+#include <string>
+
+class EdgeStreamEvent : public RtmpClientSessionEvent {
+public:
+  virtual ~EdgeStreamEvent() = default;
+
+  virtual bool OnStreamReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) = 0;
+  virtual bool OnStreamData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) = 0;
+};
+
+//====================================================================================================
+// Edge Stream(rtmp play client)
+// -> C0 C1          <- S0 S1 S2       -> C2
+// -> connect        <- _result
+// -> createStream   <- _result(stream id)
+// -> play(key)      <- onStatus, metadata, sequence headers, frames
+//====================================================================================================
+class EdgeStream : public RtmpClientSession, public StreamIngestEvent {
+public:
+  EdgeStream(const std::shared_ptr<EdgeStreamEvent> &event, const std::string &streamPath, const std::string &tcUrl);
+  virtual ~EdgeStream() = default;
+
+  uint32_t GetLastVideoTimestamp() { return _ingest.GetLastVideoTimestamp(); }
+  uint32_t GetLastAudioTimestamp() { return _ingest.GetLastAudioTimestamp(); }
+
+  bool OnIngestReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) override;
+  bool OnIngestData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) override;
+
+protected:
+  bool OnHandshakeComplete() override;
+  bool OnMediaMsg(const std::shared_ptr<ImportMsg> &msg) override;
+  bool OnAmfResult(const std::shared_ptr<AmfDoc> &doc, double transactionId) override;
+  bool OnAmfStatus(const std::string &level, const std::string &code) override;
+
+  bool SendAmfPlay();
+
+private:
+  std::weak_ptr<EdgeStreamEvent> _event;
+  StreamIngest _ingest{*this, "edge"};
+};
@@ -0,0 +1,255 @@
+#include "flv_object.h"
+#include "common/websocket_util.h"
+#include "media/flv/flv_mux_util.h"
+#include <algorithm>
+
+constexpr size_t MaxRequestSize = 8192;
+
+//====================================================================================================
+// Recv timeout
+//  - request wait only(viewer sends nothing after the request)
+//====================================================================================================
+void FlvObject::SetRecvTimeout(uint32_t maxWaitTime) {
+  if (_isPlayStart) {
+    return;
+  }
+
+  Network::TcpObject::SetRecvTimeout(maxWaitTime);
+}
+
+//====================================================================================================
+//  Recv Handler
+//  - http : request header only, data after the play start is ignored
+//  - websocket : client control frame(ping/close) after the upgrade
+//====================================================================================================
+int FlvObject::RecvHandler(std::span<const uint8_t> data) {
+  if (_isSendCompletedClose) {
+    return static_cast<int>(data.size());
+  }
+
+  if (_isPlayStart) {
+    return _isWebSocket ? OnWebSocketData(data) : static_cast<int>(data.size());
+  }
+
+  HttpRequest request;
+  auto requestSize = HttpUtil::ParseRequest(data, request, MaxRequestSize);
+  if (requestSize <= 0) {
+    if (requestSize < 0) {
+      LOG_ERROR("Flv request over - object(%s) ip(%s) size(%zu)", _objectName.c_str(), _ip.c_str(), data.size());
+    }
+    return requestSize;
+  }
+
+  if (!OnRequest(request)) {
+    return -1;
+  }
+
+  if (!_isWebSocket || !_isPlayStart) {
+    return static_cast<int>(data.size());
+  }
+
+  auto procSize = OnWebSocketData(data.subspan(requestSize));
+  return procSize < 0 ? -1 : requestSize + procSize;
+}
+
+//====================================================================================================
+// WebSocket data
+//  - return processed size(-1: error)
+//====================================================================================================
+int FlvObject::OnWebSocketData(std::span<const uint8_t> data) {
+  size_t offset = 0;
+
+  while (offset < data.size() && _isPlayStart) {
+    WebSocketFrame frame;
+    auto frameSize = WebSocketUtil::ParseFrame(data.subspan(offset), frame, MaxRequestSize);
+    if (frameSize < 0) {
+      LOG_ERROR("Flv websocket frame error - index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(),
+                _ip.c_str());
+      return -1;
+    }
+
+    if (frameSize == 0) {
+      break;
+    }
+    offset += frameSize;
+
+    if (frame.opcode == WebSocketOpcode::Ping) {
+      PostSend(WebSocketUtil::MakeFrame(WebSocketOpcode::Pong, frame.payload.data(), frame.payload.size()));
+    } else if (frame.opcode == WebSocketOpcode::Close) {
+      LOG_INFO("Flv websocket close - index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(), _ip.c_str());
+
+      // echo close, no more frame after the close
+      _isPlayStart = false;
+      _isSendCompletedClose = true;
+      PostSend(WebSocketUtil::MakeFrame(WebSocketOpcode::Close, frame.payload.data(),
+                                        std::min(frame.payload.size(), WebSocketUtil::MaxControlPayloadSize)));
+    }
+  }
+
+  return _isSendCompletedClose ? static_cast<int>(data.size()) : static_cast<int>(offset);
+}
+
+//====================================================================================================
+// Request
+//  - GET /app/key.flv[?query]
+//====================================================================================================
+bool FlvObject::OnRequest(const HttpRequest &request) {
+  if (request.method.empty()) {
+    LOG_ERROR("Flv request line error - ip(%s)", _ip.c_str());
+    return SendResponse(400);
+  }
+
+  if (request.method != "GET") {
+    return SendResponse(405);
+  }
+
+  // /app/key.flv -> app/key
+  std::string_view path = request.path;
+  constexpr std::string_view extension = ".flv";
+  if (path.size() <= extension.size() + 1 || path.front() != '/' || !path.ends_with(extension)) {
+    return SendResponse(404);
+  }
+  path = path.substr(1, path.size() - extension.size() - 1);
+
+  if (auto slash = path.find('/'); slash == std::string_view::npos || slash == 0 || slash == path.size() - 1) {
+    return SendResponse(404);
+  }
+
+  // websocket upgrade(ws-flv)
+  if (auto upgrade = request.GetHeader("Upgrade"); !upgrade.empty()) {
+    if (!HttpUtil::IsEqualNoCase(upgrade, "websocket")) {
+      return SendResponse(400);
+    }
+
+    _webSocketAccept = WebSocketUtil::MakeAcceptKey(request.GetHeader("Sec-WebSocket-Key"));
+    if (_webSocketAccept.empty()) {
+      return SendResponse(400);
+    }
+    _isWebSocket = true;
+  }
+
+  _streamPath = path;
+  _sendDrop.SetLogName(
+      StringHelper::Format("Flv index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(), _ip.c_str()));
+  _streamHub = _event->OnFlvPlay(_indexKey, _streamPath);
+  if (_streamHub == nullptr) {
+    LOG_WARN("Flv play fail, stream not found - index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(),
+             _ip.c_str());
+    return SendResponse(404);
+  }
+
+  _isPlayStart = true;
+  CancelRecvTimeout();
+
+  if (!SendStreamHeader()) {
+    return false;
+  }
+
+  LOG_INFO("Flv play start - index(%d) stream(%s) ip(%s) websocket(%s)", _indexKey, _streamPath.c_str(), _ip.c_str(),
+           _isWebSocket ? "true" : "false");
+
+  // gop cache + live frame start(live frames posted by the hub run after the gop is queued)
+  auto frames = _streamHub->AddSubscriber(StreamHub::MakeSubscriberKey(_objectKey, _indexKey),
+                                          std::static_pointer_cast<FlvObject>(shared_from_this()));
+  for (const auto &frame : frames) {
+    SendFrame(frame);
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Send error response(close after send)
+//====================================================================================================
+bool FlvObject::SendResponse(int statusCode) {
+  auto response = HttpUtil::MakeResponseHeader(statusCode, "", 0, false);
+
+  _isSendCompletedClose = true;
+  return PostSend(std::make_shared<std::vector<uint8_t>>(response.begin(), response.end()));
+}
+
+//====================================================================================================
+// Send stream header
+//  - http response(200 or 101) + flv header + meta data + sequence header(timestamp 0)
+//  - websocket : one binary message per flv header/tag
+//====================================================================================================
+bool FlvObject::SendStreamHeader() {
+  std::string response;
+  if (_isWebSocket) {
+    response = StringHelper::Format("HTTP/1.1 101 Switching Protocols\r\n"
+                                    "Upgrade: websocket\r\n"
+                                    "Connection: Upgrade\r\n"
+                                    "Sec-WebSocket-Accept: %s\r\n\r\n",
+                                    _webSocketAccept.c_str());
+  } else {
+    response = HttpUtil::MakeResponseHeader(200, "video/x-flv", -1, false);
+  }
+
+  const auto &mediaInfo = _streamHub->GetMediaInfo();
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> datas;
+
+  datas.push_back(FlvMuxUtil::MakeFlvHeader(mediaInfo->audioSeqHeader != nullptr || mediaInfo->audio != nullptr,
+                                            mediaInfo->videoSeqHeader != nullptr || mediaInfo->video != nullptr));
+
+  if (mediaInfo->metaData) {
+    datas.push_back(FlvMuxUtil::MakeMetaDataTag(mediaInfo->metaData));
+  }
+
+  if (const auto &seqHeader = mediaInfo->audioSeqHeader; seqHeader) {
+    datas.push_back(FlvMuxUtil::MakeFlvTag(Flv::TagType::Audio, 0, seqHeader->data(), seqHeader->size()));
+  }
+
+  if (const auto &seqHeader = mediaInfo->videoSeqHeader; seqHeader) {
+    datas.push_back(FlvMuxUtil::MakeFlvTag(Flv::TagType::Video, 0, seqHeader->data(), seqHeader->size()));
+  }
+
+  if (!PostSend(std::make_shared<std::vector<uint8_t>>(response.begin(), response.end()))) {
+    LOG_ERROR("Flv response send fail - stream(%s) ip(%s)", _streamPath.c_str(), _ip.c_str());
+    return false;
+  }
+
+  for (auto data : datas) {
+    if (data == nullptr) {
+      continue;
+    }
+
+    if (_isWebSocket) {
+      data = WebSocketUtil::MakeFrame(WebSocketOpcode::Binary, data->data(), data->size());
+    }
+
+    if (!PostSend(data)) {
+      LOG_ERROR("Flv stream header send fail - stream(%s) ip(%s)", _streamPath.c_str(), _ip.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Send frame
+//  - called on the player io_context(StreamHub delivery task)
+//====================================================================================================
+bool FlvObject::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (!_isPlayStart || _isClosing) {
+    return true;
+  }
+
+  if (frame->IsVideo() && _isKeyFrameWait) {
+    if (!frame->IsKeyFrame()) {
+      return true;
+    }
+    _isKeyFrameWait = false;
+  }
+
+  if (!_sendDrop.Check(*this, frame)) {
+    return true;
+  }
+
+  auto tag = _isWebSocket ? frame->GetWsFlvTag() : frame->GetFlvTag();
+  if (tag == nullptr) {
+    return false;
+  }
+
+  return PostSend(tag);
+}
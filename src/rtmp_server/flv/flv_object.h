@@ -0,0 +1,57 @@
+#pragma once
+#include "common/http_util.h"
+#include "network/network_tcp_object.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class FlvEvent {
+public:
+  virtual ~FlvEvent() = default;
+
+  virtual std::shared_ptr<StreamHub> OnFlvPlay(int indexKey, const std::string &streamPath) = 0;
+};
+
+//====================================================================================================
+// Http-Flv/WebSocket-Flv Client Object
+//  - GET /app/key.flv -> 200(close delimited) + flv header + meta/sequence tag + gop + live tag
+//  - GET /app/key.flv + Upgrade: websocket -> 101 + the same flv stream, one binary message per tag
+//  - flv tag(websocket message) is shared with the other players(RtmpExportFrame)
+//====================================================================================================
+class FlvObject : public StreamSubscriber, public Network::TcpObject {
+public:
+  FlvObject(const std::shared_ptr<FlvEvent> &event, const PlayerSendPolicy &sendPolicy)
+      : _event(event), _sendDrop(sendPolicy) {}
+  virtual ~FlvObject() = default;
+
+public:
+  void SetRecvTimeout(uint32_t maxWaitTime) override;
+  const std::string &GetStreamPath() { return _streamPath; }
+  std::shared_ptr<StreamHub> GetStreamHub() const { return _streamHub; }
+  PlayerDropInfo GetDropInfo() const { return _sendDrop.GetDropInfo(_streamPath, _ip); }
+
+  // StreamSubscriber implement
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) override;
+  boost::asio::io_context &GetSubscriberContext() override { return GetIoContext(); }
+
+protected:
+  int RecvHandler(std::span<const uint8_t> data);
+
+  bool OnRequest(const HttpRequest &request);
+  int OnWebSocketData(std::span<const uint8_t> data);
+  bool SendResponse(int statusCode);
+  bool SendStreamHeader();
+
+private:
+  std::shared_ptr<FlvEvent> _event;
+  std::string _streamPath;
+  std::shared_ptr<StreamHub> _streamHub = nullptr;
+  bool _isPlayStart = false;
+  bool _isWebSocket = false;
+  std::string _webSocketAccept;
+
+  // player io_context thread only(drop counters read by info timer)
+  PlayerSendDrop _sendDrop;
+  bool _isKeyFrameWait = true;
+};
@@ -0,0 +1,50 @@
+#include "flv_service.h"
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+FlvService::FlvService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent)
+    : Network::TcpManager(objectKey, objectName, netEvent) {}
+
+//====================================================================================================
+// Object 추가(Accepted)
+//  - recv timeout until the request(canceled at play start)
+//====================================================================================================
+int FlvService::AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+                            const std::shared_ptr<FlvEvent> &event) {
+  if (!socket) {
+    return -1;
+  }
+
+  auto object = std::make_shared<FlvObject>(event, _sendPolicy);
+  if (object->Create(std::make_shared<Network::NetTcpParam>(_objectKey, _objectName, socket, _netEvent))) {
+    return Insert(object, true, 5);
+  }
+
+  return -1;
+}
+
+//====================================================================================================
+// Get StreamHub
+//====================================================================================================
+std::shared_ptr<StreamHub> FlvService::GetStreamHub(int indexKey) {
+  if (auto object = Find(indexKey); object != nullptr) {
+    return std::static_pointer_cast<FlvObject>(object)->GetStreamHub();
+  }
+  return nullptr;
+}
+
+//====================================================================================================
+// Get drop info(drop viewers only)
+//====================================================================================================
+std::shared_ptr<std::vector<PlayerDropInfo>> FlvService::GetDropInfo() {
+  auto infos = std::make_shared<std::vector<PlayerDropInfo>>();
+
+  for (const auto &object : GetObjects()) {
+    if (auto info = std::static_pointer_cast<FlvObject>(object)->GetDropInfo(); info.dropStart != 0) {
+      infos->push_back(info);
+    }
+  }
+
+  return infos;
+}
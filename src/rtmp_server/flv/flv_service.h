@@ -0,0 +1,22 @@
+#pragma once
+#include "flv_object.h"
+#include "network/network_tcp_manager.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+//====================================================================================================
+// FlvService(http-flv)
+//====================================================================================================
+class FlvService : public Network::TcpManager {
+public:
+  FlvService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent);
+  int AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> socket, const std::shared_ptr<FlvEvent> &event);
+  void SetSendPolicy(const PlayerSendPolicy &sendPolicy) { _sendPolicy = sendPolicy; }
+
+  std::shared_ptr<StreamHub> GetStreamHub(int indexKey);
+  std::shared_ptr<std::vector<PlayerDropInfo>> GetDropInfo();
+
+private:
+  PlayerSendPolicy _sendPolicy;
+};
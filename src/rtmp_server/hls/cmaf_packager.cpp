@@ -0,0 +1,294 @@
+#include "cmaf_packager.h"
+#include <algorithm>
+
+constexpr size_t PartListSegmentCount = 2; // complete segments listing their parts(+ current)
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+CmafPackager::CmafPackager(const std::string &streamPath, uint32_t segmentDuration, uint32_t partDuration,
+                           uint32_t segmentCount, uint64_t maxCacheSize)
+    : _streamPath(streamPath), _segmentDuration(segmentDuration), _partDuration(std::max(partDuration, 1u)),
+      _segmentCount(std::max(segmentCount, 1u)), _maxCacheSize(maxCacheSize) {}
+
+//====================================================================================================
+// Create
+//====================================================================================================
+bool CmafPackager::Create(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (!_muxer.Init(mediaInfo)) {
+    LOG_WARN("Cmaf packager - unsupported codec(h264/aac only) - stream(%s)", _streamPath.c_str());
+    return false;
+  }
+
+  _initSegment = _muxer.MakeInitSegment();
+  return true;
+}
+
+//====================================================================================================
+// Push
+//  - called on the subscriber io_context
+//  - the previous sample of the track gets its duration and goes into the part, the new one waits
+//  - segment is cut before a key frame(audio only : any audio frame) over the target duration
+//====================================================================================================
+void CmafPackager::Push(const std::shared_ptr<RtmpExportFrame> &frame) {
+  const bool isVideo = frame->IsVideo();
+  const auto timestamp = frame->GetTimestamp();
+
+  Fmp4::Sample sample;
+  if (isVideo ? !_muxer.IsVideo() || !Fmp4Muxer::MakeVideoSample(frame->GetFrame()->data, timestamp, sample)
+              : !_muxer.IsAudio() || !Fmp4Muxer::MakeAudioSample(frame->GetFrame()->data, timestamp, sample)) {
+    return;
+  }
+
+  const bool isCutPoint = _muxer.IsVideo() ? isVideo && sample.isKey : !isVideo;
+
+  if (!_isStarted) {
+    if (!isCutPoint) {
+      return;
+    }
+    _isStarted = true;
+    _segmentStart = timestamp;
+  }
+
+  auto &pending = isVideo ? _pendingVideo : _pendingAudio;
+  if (pending.data != nullptr) {
+    pending.duration = timestamp > pending.timestamp ? static_cast<uint32_t>(timestamp - pending.timestamp) : 0;
+    AddSample(pending, isVideo);
+  }
+
+  if (isCutPoint && (timestamp >= _segmentStart + _segmentDuration || timestamp < _segmentStart)) {
+    Publish(ClosePart(), true, timestamp);
+    _segmentStart = timestamp;
+  }
+
+  pending = std::move(sample);
+}
+
+//====================================================================================================
+// Add sample
+//  - the part is closed before it goes over the part duration
+//====================================================================================================
+void CmafPackager::AddSample(const Fmp4::Sample &sample, bool isVideo) {
+  const auto sampleEnd = sample.timestamp + sample.duration;
+
+  if (!_partVideos.empty() || !_partAudios.empty()) {
+    if (sampleEnd > _partStart + _partDuration) {
+      Publish(ClosePart(), false, 0);
+    }
+  }
+
+  if (_partVideos.empty() && _partAudios.empty()) {
+    _partStart = sample.timestamp;
+    _partEnd = sampleEnd;
+  }
+
+  _partStart = std::min(_partStart, sample.timestamp);
+  _partEnd = std::max(_partEnd, sampleEnd);
+  (isVideo ? _partVideos : _partAudios).push_back(sample);
+}
+
+//====================================================================================================
+// Close part(nullptr : empty)
+//====================================================================================================
+std::shared_ptr<CmafPart> CmafPackager::ClosePart() {
+  if (_partVideos.empty() && _partAudios.empty()) {
+    return nullptr;
+  }
+
+  auto part = std::make_shared<CmafPart>();
+  part->duration = _partEnd - _partStart;
+  part->isIndependent = _muxer.IsVideo() ? !_partVideos.empty() && _partVideos.front().isKey : true;
+  part->header = _muxer.MakeFragmentHeader(++_fragmentSequence, _partVideos, _partAudios);
+  part->size = part->header->size();
+
+  // mdat order : video, audio
+  part->samples.reserve(_partVideos.size() + _partAudios.size());
+  for (auto *samples : {&_partVideos, &_partAudios}) {
+    for (auto &sample : *samples) {
+      part->size += sample.size;
+      part->samples.push_back(std::move(sample));
+    }
+    samples->clear();
+  }
+
+  return part;
+}
+
+//====================================================================================================
+// Publish
+//  - waiters of the published part are called after the lock is released
+//====================================================================================================
+void CmafPackager::Publish(const std::shared_ptr<CmafPart> &part, bool isSegmentEnd, uint64_t timestamp) {
+  std::vector<CmafPlaylistCallback> callbacks;
+  std::shared_ptr<std::vector<uint8_t>> playlist = nullptr;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_segmentsLock);
+
+    if (part != nullptr) {
+      part->index = static_cast<uint32_t>(_current.parts.size());
+      _current.parts.push_back(part);
+      _current.size += part->size;
+      _cacheSize += part->size;
+    }
+
+    if (isSegmentEnd && !_current.parts.empty()) {
+      _current.duration = timestamp > _segmentStart ? timestamp - _segmentStart : 0;
+      auto nextSequence = _current.sequence + 1;
+      _segments.push_back(std::move(_current));
+
+      Segment next;
+      next.sequence = nextSequence;
+      _current = std::move(next);
+
+      while (_segments.size() > _segmentCount + 2 ||
+             (_maxCacheSize != 0 && _cacheSize > _maxCacheSize && _segments.size() > 1)) {
+        _cacheSize -= _segments.front().size;
+        _segments.pop_front();
+      }
+    }
+
+    UpdatePlaylist();
+    playlist = _playlist;
+
+    const auto currentTime = GetCurrentMs();
+    std::erase_if(_waiters, [&](Waiter &waiter) {
+      if (IsPublished(waiter.sequence, waiter.partIndex)) {
+        callbacks.push_back(std::move(waiter.callback));
+        return true;
+      }
+      return waiter.expireTime < currentTime;
+    });
+  }
+
+  for (const auto &callback : callbacks) {
+    callback(playlist);
+  }
+}
+
+//====================================================================================================
+// Update playlist
+//  - the last PartListSegmentCount segments and the current one list their parts
+//====================================================================================================
+void CmafPackager::UpdatePlaylist() {
+  if (_segments.empty()) {
+    return;
+  }
+
+  const auto count = std::min<size_t>(_segments.size(), _segmentCount);
+  const auto first = _segments.end() - count;
+
+  uint64_t maxDuration = _segmentDuration;
+  for (auto it = first; it != _segments.end(); ++it) {
+    maxDuration = std::max(maxDuration, it->duration);
+  }
+
+  auto playlist = StringHelper::Format("#EXTM3U\n"
+                                       "#EXT-X-VERSION:9\n"
+                                       "#EXT-X-TARGETDURATION:%" PRIu64 "\n"
+                                       "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=%.3f\n"
+                                       "#EXT-X-PART-INF:PART-TARGET=%.3f\n"
+                                       "#EXT-X-MEDIA-SEQUENCE:%" PRIu64 "\n"
+                                       "#EXT-X-MAP:URI=\"init.mp4\"\n",
+                                       (maxDuration + 999) / 1000, _partDuration * 3 / 1000.0, _partDuration / 1000.0,
+                                       first->sequence);
+
+  auto writeParts = [&playlist](const Segment &segment) {
+    for (const auto &part : segment.parts) {
+      playlist += StringHelper::Format("#EXT-X-PART:DURATION=%.3f,URI=\"%" PRIu64 ".%u.m4s\"%s\n",
+                                       part->duration / 1000.0, segment.sequence, part->index,
+                                       part->isIndependent ? ",INDEPENDENT=YES" : "");
+    }
+  };
+
+  for (auto it = first; it != _segments.end(); ++it) {
+    if (static_cast<size_t>(_segments.end() - it) <= PartListSegmentCount) {
+      writeParts(*it);
+    }
+    playlist += StringHelper::Format("#EXTINF:%.3f,\n%" PRIu64 ".m4s\n", it->duration / 1000.0, it->sequence);
+  }
+  writeParts(_current);
+
+  _playlist = std::make_shared<std::vector<uint8_t>>(playlist.begin(), playlist.end());
+}
+
+//====================================================================================================
+// Is published(segment complete or part in the playlist)
+//====================================================================================================
+bool CmafPackager::IsPublished(uint64_t sequence, int partIndex) const {
+  if (_playlist == nullptr) {
+    return false;
+  }
+
+  if (sequence < _current.sequence) {
+    return true;
+  }
+
+  return sequence == _current.sequence && partIndex >= 0 &&
+         static_cast<size_t>(partIndex) < _current.parts.size();
+}
+
+//====================================================================================================
+// Wait playlist(blocking reload)
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> CmafPackager::WaitPlaylist(uint64_t sequence, int partIndex,
+                                                                 const CmafPlaylistCallback &callback) {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+
+  if (IsPublished(sequence, partIndex)) {
+    return _playlist;
+  }
+
+  _waiters.push_back({sequence, partIndex, GetCurrentMs() + GetBlockTimeout(), callback});
+  return nullptr;
+}
+
+//====================================================================================================
+// Get playlist(nullptr : no segment yet)
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> CmafPackager::GetPlaylist() const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+  return _playlist;
+}
+
+//====================================================================================================
+// Get current(in progress) segment sequence
+//====================================================================================================
+uint64_t CmafPackager::GetCurrentSequence() const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+  return _current.sequence;
+}
+
+//====================================================================================================
+// Get segment
+//====================================================================================================
+std::vector<std::shared_ptr<CmafPart>> CmafPackager::GetSegment(uint64_t sequence) const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+
+  if (_segments.empty() || sequence < _segments.front().sequence || sequence > _segments.back().sequence) {
+    return {};
+  }
+
+  return _segments[sequence - _segments.front().sequence].parts;
+}
+
+//====================================================================================================
+// Get part
+//====================================================================================================
+std::shared_ptr<CmafPart> CmafPackager::GetPart(uint64_t sequence, uint32_t index) const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+
+  const Segment *segment = nullptr;
+  if (sequence == _current.sequence) {
+    segment = &_current;
+  } else if (!_segments.empty() && sequence >= _segments.front().sequence && sequence <= _segments.back().sequence) {
+    segment = &_segments[sequence - _segments.front().sequence];
+  }
+
+  if (segment == nullptr || index >= segment->parts.size()) {
+    return nullptr;
+  }
+
+  return segment->parts[index];
+}
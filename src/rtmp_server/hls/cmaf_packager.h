@@ -0,0 +1,101 @@
+#pragma once
+#include "media/mp4/fmp4_muxer.h"
+#include "media/rtmp/rtmp_export_frame.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//====================================================================================================
+// CmafPart(ll-hls partial segment, one moof + mdat)
+//  - header is the moof + mdat header, the mdat payload is the samples(ranges of the shared rtmp frame data)
+//  - immutable after publish
+//====================================================================================================
+struct CmafPart {
+  uint32_t index;
+  uint64_t duration; // ms
+  bool isIndependent;
+  std::shared_ptr<std::vector<uint8_t>> header;
+  std::vector<Fmp4::Sample> samples;
+  size_t size;
+};
+
+using CmafPlaylistCallback = std::function<void(const std::shared_ptr<std::vector<uint8_t>> &playlist)>;
+
+//====================================================================================================
+// CmafPackager(fmp4 low latency hls)
+//  - fed by the HlsPackager on the subscriber io_context
+//  - a part is published every partDuration, a segment(sequence of parts) is cut on a key frame
+//  - sample duration is the next sample timestamp gap, so the last sample of each track waits for the next one
+//  - blocking playlist reload(_HLS_msn/_HLS_part) callbacks are called when the part is published
+//====================================================================================================
+class CmafPackager {
+public:
+  CmafPackager(const std::string &streamPath, uint32_t segmentDuration, uint32_t partDuration, uint32_t segmentCount,
+               uint64_t maxCacheSize);
+  ~CmafPackager() = default;
+
+  bool Create(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  void Push(const std::shared_ptr<RtmpExportFrame> &frame);
+
+  std::shared_ptr<std::vector<uint8_t>> GetInitSegment() const { return _initSegment; }
+  std::shared_ptr<std::vector<uint8_t>> GetPlaylist() const;
+  std::vector<std::shared_ptr<CmafPart>> GetSegment(uint64_t sequence) const; // complete segment only
+  std::shared_ptr<CmafPart> GetPart(uint64_t sequence, uint32_t index) const;
+  uint64_t GetCurrentSequence() const;
+  uint32_t GetBlockTimeout() const { return _segmentDuration * 3; } // ms
+
+  // partIndex < 0 : wait for the segment
+  // return the playlist if already published, otherwise callback is called on publish(packager thread)
+  std::shared_ptr<std::vector<uint8_t>> WaitPlaylist(uint64_t sequence, int partIndex,
+                                                     const CmafPlaylistCallback &callback);
+
+private:
+  struct Segment {
+    uint64_t sequence = 0;
+    uint64_t duration = 0; // ms
+    std::vector<std::shared_ptr<CmafPart>> parts;
+    size_t size = 0;
+  };
+
+  struct Waiter {
+    uint64_t sequence;
+    int partIndex;
+    uint64_t expireTime; // ms
+    CmafPlaylistCallback callback;
+  };
+
+  void AddSample(const Fmp4::Sample &sample, bool isVideo);
+  std::shared_ptr<CmafPart> ClosePart();
+  void Publish(const std::shared_ptr<CmafPart> &part, bool isSegmentEnd, uint64_t timestamp);
+  void UpdatePlaylist();                                    // _segmentsLock
+  bool IsPublished(uint64_t sequence, int partIndex) const; // _segmentsLock
+
+  std::string _streamPath;
+  uint32_t _segmentDuration; // ms
+  uint32_t _partDuration;    // ms
+  uint32_t _segmentCount;
+  uint64_t _maxCacheSize;
+  std::shared_ptr<std::vector<uint8_t>> _initSegment = nullptr;
+
+  // subscriber io_context only
+  Fmp4Muxer _muxer;
+  bool _isStarted = false;
+  uint64_t _segmentStart = 0; // ms
+  std::vector<Fmp4::Sample> _partVideos;
+  std::vector<Fmp4::Sample> _partAudios;
+  uint64_t _partStart = 0; // ms
+  uint64_t _partEnd = 0;   // ms
+  Fmp4::Sample _pendingVideo{};
+  Fmp4::Sample _pendingAudio{};
+  uint32_t _fragmentSequence = 0;
+
+  std::deque<Segment> _segments; // complete, _segmentsLock
+  Segment _current;              // _segmentsLock
+  uint64_t _cacheSize = 0;       // _segmentsLock
+  std::vector<Waiter> _waiters;  // _segmentsLock
+  std::shared_ptr<std::vector<uint8_t>> _playlist = nullptr;
+  mutable std::mutex _segmentsLock;
+};
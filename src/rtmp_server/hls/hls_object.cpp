@@ -0,0 +1,275 @@
+#include "hls_object.h"
+#include <charconv>
+
+constexpr size_t MaxRequestSize = 8192;
+
+//====================================================================================================
+//  Recv Handler
+//====================================================================================================
+int HlsObject::RecvHandler(std::span<const uint8_t> data) {
+  size_t offset = 0;
+
+  // blocked reload : the next request waits in the recv buffer(players do not pipeline)
+  while (offset < data.size() && !_isSendCompletedClose && !_isWaiting) {
+    HttpRequest request;
+    auto requestSize = HttpUtil::ParseRequest(data.subspan(offset), request, MaxRequestSize);
+    if (requestSize < 0) {
+      LOG_ERROR("Hls request over - object(%s) ip(%s) size(%zu)", _objectName.c_str(), _ip.c_str(), data.size());
+      return -1;
+    }
+
+    if (requestSize == 0) {
+      break;
+    }
+    offset += requestSize;
+
+    if (!OnRequest(request)) {
+      return -1;
+    }
+  }
+
+  return _isSendCompletedClose ? static_cast<int>(data.size()) : static_cast<int>(offset);
+}
+
+//====================================================================================================
+// Request
+//  - /app/key/index.m3u8 -> playlist, /app/key/{sequence}.ts -> segment
+//  - ll.m3u8, init.mp4, *.m4s -> cmaf
+//====================================================================================================
+bool HlsObject::OnRequest(const HttpRequest &request) {
+  const bool isKeepAlive = request.IsKeepAlive();
+
+  if (request.method.empty()) {
+    LOG_ERROR("Hls request line error - ip(%s)", _ip.c_str());
+    return SendResponse(400, "", nullptr, false);
+  }
+
+  if (request.method != "GET") {
+    return SendResponse(405, "", nullptr, isKeepAlive);
+  }
+
+  std::string_view path = request.path;
+  auto fileStart = path.rfind('/');
+  if (path.size() < 2 || path.front() != '/' || fileStart == 0 || fileStart == std::string_view::npos) {
+    return SendResponse(404, "", nullptr, isKeepAlive);
+  }
+
+  auto streamPath = std::string(path.substr(1, fileStart - 1));
+  auto fileName = path.substr(fileStart + 1);
+
+  auto packager = _event->OnHlsRequest(_indexKey, streamPath);
+  if (packager == nullptr) {
+    return SendResponse(404, "", nullptr, isKeepAlive);
+  }
+
+  if (fileName == "ll.m3u8" || fileName == "init.mp4" || fileName.ends_with(".m4s")) {
+    auto cmaf = packager->GetCmafPackager();
+    if (cmaf == nullptr) {
+      return SendResponse(404, "", nullptr, isKeepAlive);
+    }
+    return OnCmafRequest(request, cmaf, fileName);
+  }
+
+  // playlist
+  if (fileName == "index.m3u8") {
+    auto playlist = packager->GetPlaylist();
+    if (playlist == nullptr) {
+      // first segment not ready
+      return SendResponse(503, "", nullptr, isKeepAlive);
+    }
+    return SendResponse(200, "application/vnd.apple.mpegurl", playlist, isKeepAlive);
+  }
+
+  // segment
+  constexpr std::string_view extension = ".ts";
+  uint64_t sequence = 0;
+  if (fileName.size() > extension.size() && fileName.ends_with(extension)) {
+    auto number = fileName.substr(0, fileName.size() - extension.size());
+    auto [end, error] = std::from_chars(number.data(), number.data() + number.size(), sequence);
+
+    if (error == std::errc() && end == number.data() + number.size()) {
+      if (auto segment = packager->GetSegment(sequence); segment != nullptr) {
+        return SendResponse(200, "video/mp2t", segment, isKeepAlive);
+      }
+    }
+  }
+
+  return SendResponse(404, "", nullptr, isKeepAlive);
+}
+
+//====================================================================================================
+// Cmaf request
+//  - {sequence}.m4s : complete segment, {sequence}.{part}.m4s : part
+//====================================================================================================
+bool HlsObject::OnCmafRequest(const HttpRequest &request, const std::shared_ptr<CmafPackager> &packager,
+                              std::string_view fileName) {
+  const bool isKeepAlive = request.IsKeepAlive();
+
+  auto parseNumber = [](std::string_view text, uint64_t &value) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+  };
+
+  if (fileName == "init.mp4") {
+    auto initSegment = packager->GetInitSegment(); // none before the codec is known or for an unsupported codec
+    return initSegment ? SendResponse(200, "video/mp4", initSegment, isKeepAlive)
+                       : SendResponse(503, "", nullptr, isKeepAlive);
+  }
+
+  // playlist(blocking reload)
+  if (fileName == "ll.m3u8") {
+    auto msn = request.GetQuery("_HLS_msn");
+    auto part = request.GetQuery("_HLS_part");
+    if (msn.empty()) {
+      auto playlist = packager->GetPlaylist();
+      return playlist ? SendResponse(200, "application/vnd.apple.mpegurl", playlist, isKeepAlive)
+                      : SendResponse(503, "", nullptr, isKeepAlive);
+    }
+
+    uint64_t sequence = 0;
+    uint64_t partIndex = 0;
+    if (!parseNumber(msn, sequence) || (!part.empty() && !parseNumber(part, partIndex)) ||
+        partIndex > INT32_MAX || sequence > packager->GetCurrentSequence() + 2) {
+      return SendResponse(400, "", nullptr, isKeepAlive);
+    }
+
+    return WaitPlaylist(packager, sequence, part.empty() ? -1 : static_cast<int>(partIndex), isKeepAlive);
+  }
+
+  // segment/part
+  auto name = fileName.substr(0, fileName.size() - 4);
+  auto dot = name.find('.');
+  uint64_t sequence = 0;
+  uint64_t partIndex = 0;
+
+  if (dot == std::string_view::npos) {
+    if (parseNumber(name, sequence)) {
+      if (auto parts = packager->GetSegment(sequence); !parts.empty()) {
+        return SendParts(parts, isKeepAlive);
+      }
+    }
+  } else if (parseNumber(name.substr(0, dot), sequence) && parseNumber(name.substr(dot + 1), partIndex) &&
+             partIndex <= UINT32_MAX) {
+    if (auto part = packager->GetPart(sequence, static_cast<uint32_t>(partIndex)); part != nullptr) {
+      return SendParts({part}, isKeepAlive);
+    }
+  }
+
+  return SendResponse(404, "", nullptr, isKeepAlive);
+}
+
+//====================================================================================================
+// Wait playlist
+//  - answered on publish or 503 after the block timeout
+//  - the packager callback comes from the packager thread and is posted to this object's io_context
+//====================================================================================================
+bool HlsObject::WaitPlaylist(const std::shared_ptr<CmafPackager> &packager, uint64_t sequence, int partIndex,
+                             bool isKeepAlive) {
+  const auto waitId = ++_waitId;
+  _isWaiting = true;
+  _isWaitKeepAlive = isKeepAlive;
+
+  std::weak_ptr<HlsObject> weakSelf = std::static_pointer_cast<HlsObject>(shared_from_this());
+  auto &ioContext = GetIoContext();
+
+  auto playlist = packager->WaitPlaylist(
+      sequence, partIndex, [weakSelf, &ioContext, waitId](const std::shared_ptr<std::vector<uint8_t>> &playlist) {
+        boost::asio::post(ioContext, [weakSelf, waitId, playlist]() {
+          if (auto self = weakSelf.lock()) {
+            self->OnPlaylistReady(waitId, playlist);
+          }
+        });
+      });
+
+  if (playlist != nullptr) {
+    _isWaiting = false;
+    return SendResponse(200, "application/vnd.apple.mpegurl", playlist, isKeepAlive);
+  }
+
+  _waitTimer = std::make_shared<boost::asio::steady_timer>(ioContext);
+  _waitTimer->expires_from_now(std::chrono::milliseconds(packager->GetBlockTimeout()));
+  _waitTimer->async_wait([weakSelf, waitId](const boost::system::error_code &error) {
+    if (auto self = weakSelf.lock(); self && !error) {
+      self->OnPlaylistReady(waitId, nullptr);
+    }
+  });
+
+  return true;
+}
+
+//====================================================================================================
+// Playlist ready(nullptr : timeout)
+//====================================================================================================
+void HlsObject::OnPlaylistReady(uint64_t waitId, const std::shared_ptr<std::vector<uint8_t>> &playlist) {
+  if (!_isWaiting || waitId != _waitId || _isClosing) {
+    return;
+  }
+
+  _isWaiting = false;
+  if (_waitTimer != nullptr) {
+    _waitTimer->cancel();
+    _waitTimer = nullptr;
+  }
+
+  if (playlist == nullptr) {
+    LOG_WARN("Hls blocking reload timeout - object(%s) ip(%s)", _objectName.c_str(), _ip.c_str());
+    SendResponse(503, "", nullptr, _isWaitKeepAlive);
+    return;
+  }
+
+  SendResponse(200, "application/vnd.apple.mpegurl", playlist, _isWaitKeepAlive);
+}
+
+//====================================================================================================
+// Send response
+//  - body is shared(segment cache), sent without copy
+//====================================================================================================
+bool HlsObject::SendResponse(int statusCode, std::string_view contentType,
+                             const std::shared_ptr<std::vector<uint8_t>> &body, bool isKeepAlive) {
+  auto header = HttpUtil::MakeResponseHeader(statusCode, contentType, body ? body->size() : 0, isKeepAlive);
+
+  if (!isKeepAlive) {
+    _isSendCompletedClose = true;
+  }
+
+  if (!PostSend(std::make_shared<std::vector<uint8_t>>(header.begin(), header.end()))) {
+    return false;
+  }
+
+  return body == nullptr || PostSend(body);
+}
+
+//====================================================================================================
+// Send parts
+//  - moof/mdat header then the sample ranges of the shared frame data(no copy)
+//====================================================================================================
+bool HlsObject::SendParts(const std::vector<std::shared_ptr<CmafPart>> &parts, bool isKeepAlive) {
+  size_t contentLength = 0;
+  for (const auto &part : parts) {
+    contentLength += part->size;
+  }
+
+  auto header = HttpUtil::MakeResponseHeader(200, "video/mp4", contentLength, isKeepAlive);
+
+  if (!isKeepAlive) {
+    _isSendCompletedClose = true;
+  }
+
+  if (!PostSend(std::make_shared<std::vector<uint8_t>>(header.begin(), header.end()))) {
+    return false;
+  }
+
+  for (const auto &part : parts) {
+    if (!PostSend(part->header)) {
+      return false;
+    }
+
+    for (const auto &sample : part->samples) {
+      if (!PostSend(sample.data, sample.offset, sample.size)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
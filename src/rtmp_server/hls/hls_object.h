@@ -0,0 +1,48 @@
+#pragma once
+#include "common/http_util.h"
+#include "hls_packager.h"
+#include "network/network_tcp_object.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class HlsEvent {
+public:
+  virtual ~HlsEvent() = default;
+
+  virtual std::shared_ptr<HlsPackager> OnHlsRequest(int indexKey, const std::string &streamPath) = 0;
+};
+
+//====================================================================================================
+// Hls Client Object(http)
+//  - GET /app/key/index.m3u8, GET /app/key/{sequence}.ts
+//  - ll-hls(cmaf) : GET /app/key/ll.m3u8[?_HLS_msn=n[&_HLS_part=n]], init.mp4, {sequence}.m4s, {sequence}.{part}.m4s
+//  - keep-alive, requests on one connection are answered in order(blocked reload holds the next requests)
+//====================================================================================================
+class HlsObject : public Network::TcpObject {
+public:
+  explicit HlsObject(const std::shared_ptr<HlsEvent> &event) : _event(event) {}
+  virtual ~HlsObject() = default;
+
+protected:
+  int RecvHandler(std::span<const uint8_t> data);
+
+  bool OnRequest(const HttpRequest &request);
+  bool OnCmafRequest(const HttpRequest &request, const std::shared_ptr<CmafPackager> &packager,
+                     std::string_view fileName);
+  bool WaitPlaylist(const std::shared_ptr<CmafPackager> &packager, uint64_t sequence, int partIndex,
+                    bool isKeepAlive);
+  void OnPlaylistReady(uint64_t waitId, const std::shared_ptr<std::vector<uint8_t>> &playlist);
+  bool SendResponse(int statusCode, std::string_view contentType, const std::shared_ptr<std::vector<uint8_t>> &body,
+                    bool isKeepAlive);
+  bool SendParts(const std::vector<std::shared_ptr<CmafPart>> &parts, bool isKeepAlive);
+
+private:
+  std::shared_ptr<HlsEvent> _event;
+
+  // blocking playlist reload
+  bool _isWaiting = false;
+  bool _isWaitKeepAlive = false;
+  uint64_t _waitId = 0;
+  std::shared_ptr<boost::asio::steady_timer> _waitTimer = nullptr;
+};
@@ -0,0 +1,148 @@
+#include "hls_packager.h"
+#include <algorithm>
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+HlsPackager::HlsPackager(const std::string &streamPath, const HlsConfig &config,
+                         const std::shared_ptr<boost::asio::io_context> &ioContext)
+    : _streamPath(streamPath), _config(config), _ioContext(ioContext) {}
+
+//====================================================================================================
+// Create
+//====================================================================================================
+bool HlsPackager::Create(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  // hevc/av1 : rtmp/flv passthrough only(an audio only playlist would look like a broken stream)
+  if (mediaInfo->video != nullptr && mediaInfo->video->codecId != static_cast<uint8_t>(Rtmp::VideoCodecId::H264)) {
+    LOG_WARN("Hls packager - unsupported codec(h264/aac only) - stream(%s) codec(%d)", _streamPath.c_str(),
+             mediaInfo->video->codecId);
+    return false;
+  }
+
+  if (!_muxer.Init(mediaInfo)) {
+    LOG_WARN("Hls packager - unsupported codec(h264/aac only) - stream(%s)", _streamPath.c_str());
+    return false;
+  }
+
+  if (_config.partDuration != 0) {
+    _cmaf = std::make_shared<CmafPackager>(_streamPath, _config.segmentDuration, _config.partDuration,
+                                           _config.segmentCount, _config.maxCacheSize);
+    if (!_cmaf->Create(mediaInfo)) {
+      _cmaf = nullptr;
+    }
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Send frame
+//  - called on the subscriber io_context(StreamHub delivery task)
+//  - segment is cut on a key frame(audio only : any audio frame) over the target duration
+//====================================================================================================
+bool HlsPackager::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (_cmaf != nullptr) {
+    _cmaf->Push(frame);
+  }
+
+  const bool isCutPoint = _muxer.IsVideo() ? frame->IsKeyFrame() : !frame->IsVideo();
+  const auto timestamp = frame->GetTimestamp();
+
+  if (_current == nullptr) {
+    if (!isCutPoint) {
+      return true;
+    }
+    OpenSegment(timestamp);
+  } else if (isCutPoint && (timestamp >= _currentStart + _config.segmentDuration || timestamp < _currentStart)) {
+    CloseSegment(timestamp);
+    OpenSegment(timestamp);
+  }
+
+  const auto &data = *frame->GetFrame()->data;
+  if (frame->IsVideo()) {
+    _muxer.WriteVideo(*_current, timestamp, data);
+  } else {
+    _muxer.WriteAudio(*_current, timestamp, data);
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Open segment
+//====================================================================================================
+void HlsPackager::OpenSegment(uint64_t timestamp) {
+  auto reserveSize = _current ? _current->size() : 0;
+
+  _current = std::make_shared<std::vector<uint8_t>>();
+  _current->reserve(reserveSize);
+  _currentStart = timestamp;
+
+  _muxer.WriteTable(*_current);
+}
+
+//====================================================================================================
+// Close segment
+//====================================================================================================
+void HlsPackager::CloseSegment(uint64_t timestamp) {
+  Segment segment{_sequence++, timestamp > _currentStart ? timestamp - _currentStart : 0, _current};
+
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+
+  _cacheSize += segment.data->size();
+  _segments.push_back(std::move(segment));
+
+  while (_segments.size() > _config.segmentCount + 2 ||
+         (_config.maxCacheSize != 0 && _cacheSize > _config.maxCacheSize && _segments.size() > 1)) {
+    _cacheSize -= _segments.front().data->size();
+    _segments.pop_front();
+  }
+
+  UpdatePlaylist();
+}
+
+//====================================================================================================
+// Update playlist
+//====================================================================================================
+void HlsPackager::UpdatePlaylist() {
+  const auto count = std::min<size_t>(_segments.size(), std::max(_config.segmentCount, 1u));
+  const auto first = _segments.end() - count;
+
+  uint64_t maxDuration = 0;
+  for (auto it = first; it != _segments.end(); ++it) {
+    maxDuration = std::max(maxDuration, it->duration);
+  }
+
+  auto playlist = StringHelper::Format("#EXTM3U\n"
+                                       "#EXT-X-VERSION:3\n"
+                                       "#EXT-X-TARGETDURATION:%" PRIu64 "\n"
+                                       "#EXT-X-MEDIA-SEQUENCE:%" PRIu64 "\n",
+                                       (maxDuration + 999) / 1000, first->sequence);
+
+  for (auto it = first; it != _segments.end(); ++it) {
+    playlist += StringHelper::Format("#EXTINF:%.3f,\n%" PRIu64 ".ts\n", it->duration / 1000.0, it->sequence);
+  }
+
+  _playlist = std::make_shared<std::vector<uint8_t>>(playlist.begin(), playlist.end());
+}
+
+//====================================================================================================
+// Get playlist(nullptr : no segment yet)
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> HlsPackager::GetPlaylist() const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+  return _playlist;
+}
+
+//====================================================================================================
+// Get segment
+//====================================================================================================
+std::shared_ptr<std::vector<uint8_t>> HlsPackager::GetSegment(uint64_t sequence) const {
+  std::lock_guard<std::mutex> lock(_segmentsLock);
+
+  if (_segments.empty() || sequence < _segments.front().sequence || sequence > _segments.back().sequence) {
+    return nullptr;
+  }
+
+  return _segments[sequence - _segments.front().sequence].data;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "cmaf_packager.h"
+#include "media/ts/ts_muxer.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct HlsConfig {
+  uint32_t segmentDuration = 0; // ms(target, cut on the next key frame)
+  uint32_t segmentCount = 0;    // playlist window
+  uint64_t maxCacheSize = 0;    // byte per stream(0: no limit)
+  uint32_t partDuration = 0;    // ms(ll-hls cmaf part, 0: ts only)
+};
+
+//====================================================================================================
+// HlsPackager
+//  - one per published stream, subscribes to the StreamHub like a player
+//  - frames are remuxed to MPEG-TS on the subscriber io_context, segments are cut on key frames
+//  - segments/playlist are kept in memory(window + 2 for late requests, bounded by maxCacheSize)
+//  - segment/playlist data is immutable after publish, http objects share the buffers
+//  - partDuration != 0 : the same frames also feed a CmafPackager(ll-hls)
+//====================================================================================================
+class HlsPackager : public StreamSubscriber, public std::enable_shared_from_this<HlsPackager> {
+public:
+  HlsPackager(const std::string &streamPath, const HlsConfig &config,
+              const std::shared_ptr<boost::asio::io_context> &ioContext);
+  ~HlsPackager() = default;
+
+  bool Create(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  const std::string &GetStreamPath() const { return _streamPath; }
+
+  std::shared_ptr<std::vector<uint8_t>> GetPlaylist() const;
+  std::shared_ptr<std::vector<uint8_t>> GetSegment(uint64_t sequence) const;
+  std::shared_ptr<CmafPackager> GetCmafPackager() const { return _cmaf; }
+
+  // StreamSubscriber implement
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) override;
+  boost::asio::io_context &GetSubscriberContext() override { return *_ioContext; }
+
+private:
+  struct Segment {
+    uint64_t sequence;
+    uint64_t duration; // ms
+    std::shared_ptr<std::vector<uint8_t>> data;
+  };
+
+  void OpenSegment(uint64_t timestamp);
+  void CloseSegment(uint64_t timestamp);
+  void UpdatePlaylist(); // _segmentsLock
+
+  std::string _streamPath;
+  HlsConfig _config;
+  std::shared_ptr<boost::asio::io_context> _ioContext;
+
+  // subscriber io_context only
+  TsMuxer _muxer;
+  std::shared_ptr<CmafPackager> _cmaf = nullptr;
+  std::shared_ptr<std::vector<uint8_t>> _current = nullptr;
+  uint64_t _currentStart = 0; // ms
+  uint64_t _sequence = 0;
+
+  std::deque<Segment> _segments; // _segmentsLock
+  uint64_t _cacheSize = 0;       // _segmentsLock
+  std::shared_ptr<std::vector<uint8_t>> _playlist = nullptr;
+  mutable std::mutex _segmentsLock;
+};
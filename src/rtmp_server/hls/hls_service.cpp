@@ -0,0 +1,26 @@
+#include "hls_service.h"
+
+constexpr uint32_t IdleTimeout = 30; // seconds(keep-alive)
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+HlsService::HlsService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent)
+    : Network::TcpManager(objectKey, objectName, netEvent) {}
+
+//====================================================================================================
+// Object 추가(Accepted)
+//====================================================================================================
+int HlsService::AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> socket,
+                            const std::shared_ptr<HlsEvent> &event) {
+  if (!socket) {
+    return -1;
+  }
+
+  auto object = std::make_shared<HlsObject>(event);
+  if (object->Create(std::make_shared<Network::NetTcpParam>(_objectKey, _objectName, socket, _netEvent))) {
+    return Insert(object, true, IdleTimeout);
+  }
+
+  return -1;
+}
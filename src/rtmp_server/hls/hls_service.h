@@ -0,0 +1,14 @@
+#pragma once
+#include "hls_object.h"
+#include "network/network_tcp_manager.h"
+#include <memory>
+#include <string>
+
+//====================================================================================================
+// HlsService(http)
+//====================================================================================================
+class HlsService : public Network::TcpManager {
+public:
+  HlsService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent);
+  int AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> socket, const std::shared_ptr<HlsEvent> &event);
+};
@@ -5,8 +5,7 @@
 
 MainObject::MainObject() {
   _redisContext = nullptr;
-  _playerStreams.clear();
-  _mediaInfos.clear();
+  _streamHubs.clear();
 }
 
 MainObject::~MainObject() {
@@ -15,8 +14,7 @@ MainObject::~MainObject() {
     _controllerThread.join();
   }
 
-  _playerStreams.clear();
-  _mediaInfos.clear();
+  _streamHubs.clear();
 }
 
 void MainObject::Release() {
@@ -40,6 +38,26 @@ void MainObject::Release() {
     LOG_INFO("PlayerService released");
   }
 
+  if (_flvs != nullptr) {
+    _flvs->PostRelease();
+    LOG_INFO("FlvService released");
+  }
+
+  if (_hlsService != nullptr) {
+    _hlsService->PostRelease();
+    LOG_INFO("HlsService released");
+  }
+
+  if (_edges != nullptr) {
+    _edges->PostRelease();
+    LOG_INFO("EdgeService released");
+  }
+
+  if (_restreams != nullptr) {
+    _restreams->PostRelease();
+    LOG_INFO("RestreamService released");
+  }
+
   LOG_INFO("Network object close completed");
 
   if (_netPool != nullptr) {
@@ -47,6 +65,15 @@ void MainObject::Release() {
     LOG_INFO("Network service pool close completed");
   }
 
+  if (_servicePool != nullptr) {
+    _servicePool->Stop();
+  }
+
+  if (_recordWriter != nullptr) {
+    _recordWriter->Stop();
+    LOG_INFO("Record writer close completed");
+  }
+
   if (_redisContext) {
     redisFree(_redisContext); // Redis 연결 해제
     _redisContext = nullptr;
@@ -95,6 +122,16 @@ std::string MainObject::GetNetObjectName(NetObjectKey objectKey) {
     return "Studio";
   case NetObjectKey::Player:
     return "Player";
+  case NetObjectKey::Flv:
+    return "Flv";
+  case NetObjectKey::Hls:
+    return "Hls";
+  case NetObjectKey::Record:
+    return "Record";
+  case NetObjectKey::Edge:
+    return "Edge";
+  case NetObjectKey::Restream:
+    return "Restream";
   default:
     return "Unknown";
   }
@@ -109,6 +146,14 @@ std::shared_ptr<Network::TcpManager> MainObject::GetNetworkManager(NetObjectKey
     return _studios;
   case NetObjectKey::Player:
     return _players;
+  case NetObjectKey::Flv:
+    return _flvs;
+  case NetObjectKey::Hls:
+    return _hlsService;
+  case NetObjectKey::Edge:
+    return _edges;
+  case NetObjectKey::Restream:
+    return _restreams;
   default:
     return nullptr;
   }
@@ -129,15 +174,22 @@ bool MainObject::Create(std::unique_ptr<Config> param) {
   //   return false;
   // }
 
-  // IoService start
-  _netPool = std::make_shared<Network::ContextPool>(0);
+  // IoService start(one io_context thread per network cpu)
+  _netPool = std::make_shared<Network::ContextPool>(static_cast<int>(_config->networkCpuSet.size()));
+  _netPool->SetCpuSet(_config->networkCpuSet);
+  _netPool->SetBusyPollTime(_config->networkBusyPoll);
   _netPool->Run();
 
+  _servicePool = std::make_shared<Network::ContextPool>(1);
+  _servicePool->Run();
+
   const auto &self = shared_from_this();
 
   // Studio 생성
   _studios = std::make_shared<StudioService>(static_cast<int>(NetObjectKey::Studio),
                                              GetNetObjectName(NetObjectKey::Studio), self);
+  _studios->SetReusePort(_config->networkReusePort);
+
   if (!_studios->Create(_netPool, _config->studioPort)) {
     LOG_ERROR("Create fail - object(%s)", _studios->GetObjectName().c_str());
     return false;
@@ -146,20 +198,86 @@ bool MainObject::Create(std::unique_ptr<Config> param) {
   // Player 생성
   _players = std::make_shared<PlayerService>(static_cast<int>(NetObjectKey::Player),
                                              GetNetObjectName(NetObjectKey::Player), self);
+  _players->SetGopBurstRate(_config->gopBurstRate);
+  _players->SetSendPolicy(_config->playerSendPolicy);
+  _players->SetAggregateTime(_config->playerAggregateTime);
+  _players->SetReusePort(_config->networkReusePort);
 
   if (!_players->Create(_netPool, _config->playerPort)) {
     LOG_ERROR("Create fail - object(%s)", _players->GetObjectName().c_str());
     return false;
   }
 
+  // Http-flv 생성
+  if (_config->flvPort != 0) {
+    _flvs = std::make_shared<FlvService>(static_cast<int>(NetObjectKey::Flv), GetNetObjectName(NetObjectKey::Flv),
+                                         self);
+    _flvs->SetSendPolicy(_config->playerSendPolicy);
+    _flvs->SetReusePort(_config->networkReusePort);
+
+    if (!_flvs->Create(_netPool, _config->flvPort)) {
+      LOG_ERROR("Create fail - object(%s)", _flvs->GetObjectName().c_str());
+      return false;
+    }
+  }
+
+  // Hls 생성
+  if (_config->hlsPort != 0) {
+    _hlsService = std::make_shared<HlsService>(static_cast<int>(NetObjectKey::Hls),
+                                               GetNetObjectName(NetObjectKey::Hls), self);
+    _hlsService->SetReusePort(_config->networkReusePort);
+
+    if (!_hlsService->Create(_netPool, _config->hlsPort)) {
+      LOG_ERROR("Create fail - object(%s)", _hlsService->GetObjectName().c_str());
+      return false;
+    }
+  }
+
+  // Record 생성
+  if (!_config->recordPath.empty()) {
+    _recordWriter = std::make_shared<RecordWriter>(_config->recordPath);
+    if (!_recordWriter->Start()) {
+      LOG_ERROR("Create fail - object(%s)", GetNetObjectName(NetObjectKey::Record).c_str());
+      return false;
+    }
+  }
+
+  // Vod 생성
+  if (!_config->vodPath.empty()) {
+    _vodFiles = std::make_shared<VodFileCache>(_config->vodPath);
+  }
+
+  // Edge 생성
+  if (!_config->edgeOriginHost.empty()) {
+    _edges = std::make_shared<EdgeService>(static_cast<int>(NetObjectKey::Edge), GetNetObjectName(NetObjectKey::Edge),
+                                           self, _config->edgeOriginHost, _config->edgeOriginPort);
+    if (!_edges->Create(_netPool)) {
+      LOG_ERROR("Create fail - object(%s)", _edges->GetObjectName().c_str());
+      return false;
+    }
+  }
+
+  // Restream 생성(destinations from config or controller)
+  _restreams = std::make_shared<RestreamService>(static_cast<int>(NetObjectKey::Restream),
+                                                 GetNetObjectName(NetObjectKey::Restream), self,
+                                                 _config->restreamSendPolicy);
+  if (!_restreams->Create(_netPool)) {
+    LOG_ERROR("Create fail - object(%s)", _restreams->GetObjectName().c_str());
+    return false;
+  }
+
   // Controller 생성
-  _controller = std::make_shared<Controller>(_config->controllerHost, _config->controllerPort, _netPool->GetContext(),
-                                             _config->hostIp, _config->playerPort, self);
+  _controller = std::make_shared<Controller>(_config->controllerHost, _config->controllerPort,
+                                             _servicePool->GetContext(), _config->hostIp, _config->playerPort, self);
   _controllerThread = std::thread([this]() { _controller->Connect(); });
 
   // Timer 설정
   _timer.AddTimer(20000, [this]() { OnGarbageCheckTimer(); });
   _timer.AddTimer(30000, [this]() { OnInfoPrintTimer(); });
+  if (_edges != nullptr) {
+    _timer.AddTimer(5000, [this]() { OnEdgeIdleTimer(); });
+  }
+  _timer.AddTimer(1000, [this]() { _restreams->CheckReconnect(); });
 
   return true;
 }
@@ -182,6 +300,14 @@ bool MainObject::OnAccepted(int objectKey, std::shared_ptr<boost::asio::ip::tcp:
       indexKey = _players->AcceptedAdd(socket, shared_from_this());
       break;
     }
+    case static_cast<int>(NetObjectKey::Flv): {
+      indexKey = _flvs->AcceptedAdd(socket, shared_from_this());
+      break;
+    }
+    case static_cast<int>(NetObjectKey::Hls): {
+      indexKey = _hlsService->AcceptedAdd(socket, shared_from_this());
+      break;
+    }
     default: {
       LOG_WARN("Network accepted - unknown object - objectKey(%d) address(%s:%d)",
                GetNetObjectName(static_cast<NetObjectKey>(objectKey)).c_str(), ip.c_str(), port);
@@ -210,6 +336,46 @@ bool MainObject::OnConnected(int objectKey, const std::shared_ptr<Network::TcpCo
            GetNetObjectName(static_cast<NetObjectKey>(objectKey)).c_str(), connectedParam->ip.c_str(),
            connectedParam->port);
 
+  if (objectKey == static_cast<int>(NetObjectKey::Edge)) {
+    auto param = std::static_pointer_cast<EdgeConnectedParam>(connectedParam);
+    int indexKey = -1;
+
+    if (param->resultCode == Network::ConnectedResult::Success) {
+      indexKey = _edges->ConnectedAdd(param, shared_from_this());
+    }
+
+    if (indexKey == -1) {
+      LOG_ERROR("Edge connect fail - stream(%s) address(%s:%d)", param->streamPath.c_str(), param->ip.c_str(),
+                param->port);
+      if (param->socket != nullptr) {
+        param->socket->close();
+      }
+      EdgeRelease(param->streamPath, -1);
+      return false;
+    }
+
+    // --- Lock Block ---
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    if (auto it = _edgePulls.find(param->streamPath); it != _edgePulls.end() && it->second.indexKey == -1) {
+      it->second.indexKey = indexKey;
+    }
+  } else if (objectKey == static_cast<int>(NetObjectKey::Restream)) {
+    auto param = std::static_pointer_cast<RestreamConnectedParam>(connectedParam);
+    int indexKey = -1;
+
+    if (param->resultCode == Network::ConnectedResult::Success) {
+      indexKey = _restreams->ConnectedAdd(param);
+    }
+
+    if (indexKey == -1) {
+      if (param->socket != nullptr) {
+        param->socket->close();
+      }
+      _restreams->OnConnectFail(param->targetId);
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -221,9 +387,23 @@ int MainObject::OnClosed(int objectKey, int indexKey, const std::string &ip, int
            GetNetObjectName(static_cast<NetObjectKey>(objectKey)).c_str(), indexKey, ip.c_str(), port);
 
   std::string streamPath = "";
+  std::string edgeStreamPath = "";
 
   if (objectKey == static_cast<int>(NetObjectKey::Studio)) {
     streamPath = _studios->GetStreamPath(indexKey);
+  } else if (objectKey == static_cast<int>(NetObjectKey::Edge)) {
+    edgeStreamPath = _edges->GetStreamPath(indexKey);
+  } else if (objectKey == static_cast<int>(NetObjectKey::Player)) {
+    if (auto streamHub = _players->GetStreamHub(indexKey); streamHub != nullptr) {
+      streamHub->RemoveSubscriber(StreamHub::MakeSubscriberKey(objectKey, indexKey));
+    }
+  } else if (objectKey == static_cast<int>(NetObjectKey::Flv)) {
+    if (auto streamHub = _flvs->GetStreamHub(indexKey); streamHub != nullptr) {
+      streamHub->RemoveSubscriber(StreamHub::MakeSubscriberKey(objectKey, indexKey));
+    }
+  } else if (objectKey == static_cast<int>(NetObjectKey::Restream)) {
+    _restreams->Closed(indexKey); // subscriber + session remove, reconnect wait
+    return 0;
   }
 
   // remove session
@@ -231,20 +411,35 @@ int MainObject::OnClosed(int objectKey, int indexKey, const std::string &ip, int
            indexKey);
   GetNetworkManager(static_cast<NetObjectKey>(objectKey))->Remove(indexKey);
 
+  // upstream release(players waiting for the pull get not found)
+  if (!edgeStreamPath.empty()) {
+    EdgeRelease(edgeStreamPath, indexKey);
+  }
+
   // stream manager release
   if (!streamPath.empty()) {
     // --- Lock Block ---
+    std::shared_ptr<FlvRecorder> recorder = nullptr;
     {
-      std::lock_guard<std::mutex> lock(_mediaInfosLock);
-      _mediaInfos.erase(streamPath);
+      std::lock_guard<std::mutex> lock(_streamHubsLock);
+      if (auto it = _recorders.find(streamPath); it != _recorders.end()) {
+        recorder = it->second;
+        _recorders.erase(it);
+      }
+      if (auto it = _streamHubs.find(streamPath); it != _streamHubs.end() && recorder != nullptr) {
+        it->second->RemoveSubscriber(StreamHub::MakeSubscriberKey(static_cast<int>(NetObjectKey::Record), indexKey));
+      }
+      _streamHubs.erase(streamPath);
+      _hlsPackagers.erase(streamPath);
     }
 
-    // --- Lock Block ---
-    {
-      std::lock_guard<std::mutex> lock(_playerStreamsLock);
-      _playerStreams.erase(streamPath);
+    if (recorder != nullptr) {
+      recorder->Close();
     }
 
+    _restreams->Stop(streamPath);
+    _netPool->ReleaseStreamContext(streamPath);
+
     // TODO: 연결 Player 접속 제거
   }
 
@@ -262,47 +457,72 @@ bool MainObject::OnStudioStart(int indexKey, const std::string &streamPath) {
 //====================================================================================================
 // Studio implement
 //====================================================================================================
-bool MainObject::OnStudioReady(int indexKey, const std::string &streamPath, const std::string &streamApp,
-                               const std::string &streamKey, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+std::shared_ptr<StreamHub> MainObject::OnStudioReady(int indexKey, const std::string &streamPath,
+                                                     const std::string &streamApp, const std::string &streamKey,
+                                                     const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
   LOG_INFO("Step 2. studio ready complete - index(%d) stream(%s) %s", indexKey, streamPath.c_str(),
            mediaInfo->ToString().c_str());
 
+  auto [streamHub, hlsPackager] = CreateStreamHub(indexKey, streamPath, mediaInfo);
+
+  // recorder
+  std::shared_ptr<FlvRecorder> recorder = nullptr;
+  if (_recordWriter != nullptr) {
+    recorder = std::make_shared<FlvRecorder>(_recordWriter, _netPool->GetContext());
+    if (recorder->Open(streamPath, mediaInfo)) {
+      streamHub->AddSubscriber(StreamHub::MakeSubscriberKey(static_cast<int>(NetObjectKey::Record), indexKey),
+                               recorder);
+    } else {
+      recorder = nullptr;
+    }
+  }
+
   // set stream list
   // --- Lock Block ---
   {
-    std::lock_guard<std::mutex> lock(_mediaInfosLock);
-    _mediaInfos[streamPath] = mediaInfo;
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    _streamHubs[streamPath] = streamHub;
+    if (hlsPackager != nullptr) {
+      _hlsPackagers[streamPath] = hlsPackager;
+    }
+    if (recorder != nullptr) {
+      _recorders[streamPath] = recorder;
+    }
+  }
+
+  // restream(config by app, controller by stream path)
+  if (auto urls = GetRestreamUrls(streamPath, streamApp); !urls.empty()) {
+    _restreams->Start(streamPath, streamHub, urls);
   }
 
   // Controller에 스트림 시적 전송
   _controller->SendStreamStart(streamPath, streamApp, streamKey);
 
-  return true;
+  return streamHub;
 }
 
 //====================================================================================================
-// Studio implement
+// Create stream hub
+//  - hls packager subscribes first(new hub, gop empty)
 //====================================================================================================
-bool MainObject::OnStudioStream(int indexKey, const std::string &streamPath, const std::shared_ptr<Rtmp::Frame> &frame,
-                                bool isVideo) {
-  std::pair<std::multimap<std::string, int>::iterator, std::multimap<std::string, int>::iterator> players;
-
-  //--- Lock Block ---
-  {
-    std::lock_guard<std::mutex> lock(_playerStreamsLock);
-    players = _playerStreams.equal_range(streamPath);
-  }
-
-  // Player에 데이터 전달
-  if (players.first != players.second) {
-    if (isVideo) {
-      _players->SendVideo(players.first, players.second, frame);
+std::pair<std::shared_ptr<StreamHub>, std::shared_ptr<HlsPackager>>
+MainObject::CreateStreamHub(int indexKey, const std::string &streamPath,
+                            const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  auto streamHub =
+      std::make_shared<StreamHub>(streamPath, mediaInfo, _config->gopCacheDuration, _config->gopCacheSize);
+
+  std::shared_ptr<HlsPackager> hlsPackager = nullptr;
+  if (_hlsService != nullptr) {
+    hlsPackager = std::make_shared<HlsPackager>(streamPath, _config->hls, _netPool->GetContext());
+    if (hlsPackager->Create(mediaInfo)) {
+      streamHub->AddSubscriber(StreamHub::MakeSubscriberKey(static_cast<int>(NetObjectKey::Hls), indexKey),
+                               hlsPackager);
     } else {
-      _players->SendAudio(players.first, players.second, frame);
+      hlsPackager = nullptr;
     }
   }
 
-  return true;
+  return {streamHub, hlsPackager};
 }
 
 //====================================================================================================
@@ -317,40 +537,246 @@ bool MainObject::OnPlayerStart(int indexKey, const std::string &streamPath) {
 //====================================================================================================
 // Player implement
 //====================================================================================================
-std::shared_ptr<Rtmp::MediaInfo> MainObject::OnPlayerPlay(int indexKey, const std::string &streamPath) {
+std::shared_ptr<StreamHub> MainObject::OnPlayerPlay(int indexKey, const std::string &streamPath) {
   LOG_WRITE("Step 2. player play - index(%d)  stream(%s)", indexKey, streamPath.c_str());
 
-  std::shared_ptr<Rtmp::MediaInfo> mediaInfo;
-
   // --- Block Lock ---
+  std::lock_guard<std::mutex> lock(_streamHubsLock);
+  if (auto it = _streamHubs.find(streamPath); it != _streamHubs.end()) {
+    return it->second;
+  }
+
+  return nullptr;
+}
+
+//====================================================================================================
+// Player vod(no live stream)
+//  - file check/mapping/index scan run on the service context(no disk io on the network threads)
+//  - one service context : opens of the same file are serialized, the later ones hit the cache
+//====================================================================================================
+bool MainObject::OnPlayerVod(int indexKey, const std::string &streamPath, const PlayerVodCallback &callback) {
+  if (_vodFiles == nullptr) {
+    return false;
+  }
+
+  boost::asio::post(*_servicePool->GetContext(), [vodFiles = _vodFiles, indexKey, streamPath, callback]() {
+    auto file = vodFiles->Open(streamPath);
+    LOG_INFO("Player vod - index(%d) stream(%s) file(%s)", indexKey, streamPath.c_str(),
+             file ? file->GetFilePath().c_str() : "none");
+    callback(file);
+  });
+
+  return true;
+}
+
+//====================================================================================================
+// Player pull(no live stream and no file)
+//  - the first player opens the upstream, the others wait for the same one
+//====================================================================================================
+bool MainObject::OnPlayerPull(int indexKey, const std::string &streamPath, const PlayerPullCallback &callback) {
+  if (_edges == nullptr) {
+    return false;
+  }
+
+  std::shared_ptr<StreamHub> streamHub = nullptr;
+  bool isPull = false;
+
+  // --- Lock Block ---
   {
-    std::lock_guard<std::mutex> lock(_mediaInfosLock);
-    mediaInfo = _mediaInfos[streamPath];
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    if (auto it = _streamHubs.find(streamPath); it != _streamHubs.end()) {
+      streamHub = it->second; // published after the play check
+    } else {
+      auto [edgePull, isNew] = _edgePulls.try_emplace(streamPath);
+      edgePull->second.waiters.push_back(callback);
+      isPull = isNew;
+    }
   }
 
-  // --- Block Lock ---
+  if (streamHub != nullptr) {
+    callback(streamHub);
+    return true;
+  }
+
+  LOG_INFO("Player pull - index(%d) stream(%s) origin(%s:%d) %s", indexKey, streamPath.c_str(),
+           _config->edgeOriginHost.c_str(), _config->edgeOriginPort, isPull ? "connect" : "wait");
+
+  if (isPull && !_edges->Pull(streamPath)) {
+    EdgeRelease(streamPath, -1);
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Edge implement
+//====================================================================================================
+std::shared_ptr<StreamHub> MainObject::OnEdgeReady(int indexKey, const std::string &streamPath,
+                                                   const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  LOG_INFO("Edge ready - index(%d) stream(%s) %s", indexKey, streamPath.c_str(), mediaInfo->ToString().c_str());
+
+  auto [streamHub, hlsPackager] = CreateStreamHub(indexKey, streamPath, mediaInfo);
+  std::shared_ptr<StreamHub> waitHub = nullptr;
+  std::vector<PlayerPullCallback> waiters;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    auto it = _edgePulls.find(streamPath);
+    if (it == _edgePulls.end() || (it->second.indexKey != -1 && it->second.indexKey != indexKey)) {
+      return nullptr; // released(idle, close)
+    }
+
+    if (auto hub = _streamHubs.find(streamPath); hub != _streamHubs.end()) {
+      waitHub = hub->second; // local publish wins, upstream is closed
+      streamHub = nullptr;
+    } else {
+      _streamHubs[streamPath] = streamHub;
+      if (hlsPackager != nullptr) {
+        _hlsPackagers[streamPath] = hlsPackager;
+      }
+      waitHub = streamHub;
+
+      it->second.indexKey = indexKey;
+      it->second.streamHub = streamHub;
+      it->second.isHls = (hlsPackager != nullptr);
+    }
+    waiters.swap(it->second.waiters);
+  }
+
+  for (const auto &callback : waiters) {
+    callback(waitHub);
+  }
+
+  return streamHub;
+}
+
+//====================================================================================================
+// Edge release
+//  - indexKey -1 : connect fail
+//====================================================================================================
+void MainObject::EdgeRelease(const std::string &streamPath, int indexKey) {
+  std::vector<PlayerPullCallback> waiters;
+
+  // --- Lock Block ---
   {
-    if (mediaInfo != nullptr) {
-      std::lock_guard<std::mutex> lock(_playerStreamsLock);
-      _playerStreams.insert(std::make_pair(streamPath, indexKey));
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    auto it = _edgePulls.find(streamPath);
+    if (it == _edgePulls.end() || (indexKey != -1 && it->second.indexKey != -1 && it->second.indexKey != indexKey)) {
+      return;
+    }
+
+    if (auto hub = _streamHubs.find(streamPath);
+        hub != _streamHubs.end() && it->second.streamHub != nullptr && hub->second == it->second.streamHub) {
+      _streamHubs.erase(hub);
+      _hlsPackagers.erase(streamPath);
     }
+
+    waiters.swap(it->second.waiters);
+    _edgePulls.erase(it);
+  }
+
+  LOG_INFO("Edge release - index(%d) stream(%s) wait(%zu)", indexKey, streamPath.c_str(), waiters.size());
+  _netPool->ReleaseStreamContext(streamPath);
+
+  for (const auto &callback : waiters) {
+    callback(nullptr);
+  }
+}
+
+//====================================================================================================
+// Flv implement
+//====================================================================================================
+std::shared_ptr<StreamHub> MainObject::OnFlvPlay(int indexKey, const std::string &streamPath) {
+  LOG_INFO("Flv play - index(%d) stream(%s)", indexKey, streamPath.c_str());
+
+  // --- Block Lock ---
+  std::lock_guard<std::mutex> lock(_streamHubsLock);
+  if (auto it = _streamHubs.find(streamPath); it != _streamHubs.end()) {
+    return it->second;
   }
-  return mediaInfo;
+
+  return nullptr;
+}
+
+//====================================================================================================
+// Hls implement
+//====================================================================================================
+std::shared_ptr<HlsPackager> MainObject::OnHlsRequest(int indexKey, const std::string &streamPath) {
+  // --- Block Lock ---
+  std::lock_guard<std::mutex> lock(_streamHubsLock);
+  if (auto it = _hlsPackagers.find(streamPath); it != _hlsPackagers.end()) {
+    return it->second;
+  }
+
+  return nullptr;
 }
 
 //====================================================================================================
 // Garbage Check Proc
 //====================================================================================================
 void MainObject::OnGarbageCheckTimer() {
-  // Implement garbage collection logic if needed
+  if (_vodFiles != nullptr) {
+    _vodFiles->Cleanup();
+  }
+}
+
+//====================================================================================================
+// Edge idle check
+//  - upstream without viewers(hls packager is not a viewer) is closed after edgeIdleTime
+//====================================================================================================
+void MainObject::OnEdgeIdleTimer() {
+  const auto currentTime = GetCurrentMs();
+  std::vector<std::pair<std::string, int>> idleEdges;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    for (auto &[streamPath, edgePull] : _edgePulls) {
+      if (edgePull.streamHub == nullptr) {
+        continue; // connecting
+      }
+
+      if (edgePull.streamHub->GetSubscriberCount() > (edgePull.isHls ? 1 : 0)) {
+        edgePull.idleStartTime = 0;
+      } else if (edgePull.idleStartTime == 0) {
+        edgePull.idleStartTime = currentTime;
+      } else if (currentTime - edgePull.idleStartTime >= _config->edgeIdleTime) {
+        idleEdges.emplace_back(streamPath, edgePull.indexKey);
+      }
+    }
+  }
+
+  for (const auto &[streamPath, indexKey] : idleEdges) {
+    LOG_INFO("Edge idle close - index(%d) stream(%s)", indexKey, streamPath.c_str());
+    _edges->Remove(indexKey);
+    EdgeRelease(streamPath, indexKey);
+  }
 }
 
 //====================================================================================================
 // Information Print Proc
 //====================================================================================================
 void MainObject::OnInfoPrintTimer() {
-  LOG_INFO("Connected - encoder(%d) player(%d) controller(%s)", _studios->GetCount(), _players->GetCount(),
-           _controller->IsConnected() ? "true" : "false");
+  LOG_INFO("Connected - encoder(%d) player(%d) flv(%d) hls(%d) edge(%d) restream(%d/%d) controller(%s)",
+           _studios->GetCount(), _players->GetCount(), _flvs ? _flvs->GetCount() : 0,
+           _hlsService ? _hlsService->GetCount() : 0, _edges ? _edges->GetCount() : 0, _restreams->GetCount(),
+           _restreams->GetTargetCount(), _controller->IsConnected() ? "true" : "false");
+  LOG_INFO("Buffer pool - %s", BufferPool::GetStatsString().c_str());
+  LOG_INFO("Network context - %s", _netPool->GetLoadString().c_str());
+
+  auto printDropInfo = [](const char *type, const std::vector<PlayerDropInfo> &dropInfos) {
+    for (const auto &info : dropInfos) {
+      LOG_INFO("%s drop - stream(%s) ip(%s) start(%u) video(%" PRIu64 ") audio(%" PRIu64 ") size(%" PRIu64 ")", type,
+               info.streamPath.c_str(), info.remoteIp.c_str(), info.dropStart, info.videoCount, info.audioCount,
+               info.dropSize);
+    }
+  };
+
+  printDropInfo("Player", *_players->GetDropInfo());
+  if (_flvs) {
+    printDropInfo("Flv", *_flvs->GetDropInfo());
+  }
 }
 
 //====================================================================================================
@@ -368,3 +794,45 @@ void MainObject::OnControllerStreamStop(const std::string &streamPath) {
   LOG_INFO("Stream stop - stream(%s)", streamPath.c_str());
   _studios->StreamStop(streamPath);
 }
+
+//====================================================================================================
+// Restream event from controller
+//  - replaces the app config of the stream(empty : stop)
+//====================================================================================================
+void MainObject::OnControllerRestream(const std::string &streamPath, const std::vector<std::string> &urls) {
+  LOG_INFO("Restream - stream(%s) url(%zu)", streamPath.c_str(), urls.size());
+
+  std::shared_ptr<StreamHub> streamHub = nullptr;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    _restreamUrls[streamPath] = urls;
+    if (auto it = _streamHubs.find(streamPath); it != _streamHubs.end()) {
+      streamHub = it->second;
+    }
+  }
+
+  if (streamHub != nullptr) {
+    _restreams->Start(streamPath, streamHub, urls);
+  }
+}
+
+//====================================================================================================
+// Get restream urls
+//====================================================================================================
+std::vector<std::string> MainObject::GetRestreamUrls(const std::string &streamPath, const std::string &streamApp) {
+  // --- Block Lock ---
+  {
+    std::lock_guard<std::mutex> lock(_streamHubsLock);
+    if (auto it = _restreamUrls.find(streamPath); it != _restreamUrls.end()) {
+      return it->second;
+    }
+  }
+
+  if (auto it = _config->restreamUrls.find(streamApp); it != _config->restreamUrls.end()) {
+    return it->second;
+  }
+
+  return {};
+}
@@ -2,16 +2,24 @@
 #include "common/system_monitor.h"
 #include "common/timer_manager.h"
 #include "controller/controller.h"
+#include "edge/edge_service.h"
+#include "flv/flv_service.h"
+#include "hls/hls_service.h"
 #include "media/rtmp/rtmp_media_parser.h"
 #include "network/network_header.h"
 #include "network/network_manager.h"
 #include "player/player_service.h"
+#include "record/flv_recorder.h"
+#include "restream/restream_service.h"
+#include "stream/stream_hub.h"
 #include "studio/studio_service.h"
+#include "vod/vod_file_cache.h"
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 extern "C" {
@@ -29,7 +37,7 @@ extern "C" {
 #include <hiredis/sds.h>
 #endif
 
-enum class NetObjectKey { Studio, Player };
+enum class NetObjectKey { Studio, Player, Flv, Hls, Record, Edge, Restream }; // Record : stream hub subscriber only
 
 //===============================================================================================
 // Config
@@ -39,8 +47,35 @@ struct Config {
   std::string hostIp;
   int studioPort;
   int playerPort;
+  int flvPort; // http-flv(0: disable)
+  int hlsPort; // hls http(0: disable)
   std::string controllerHost;
   int controllerPort;
+  uint32_t gopCacheDuration; // ms
+  uint64_t gopCacheSize;     // byte
+  uint32_t gopBurstRate;     // kbps
+  PlayerSendPolicy playerSendPolicy;
+  uint32_t playerAggregateTime; // ms, audio/video packed into one aggregate message(0: disable), shared per window
+  HlsConfig hls;
+  std::string recordPath; // flv record(empty: disable)
+  std::string vodPath;    // rtmp play of recorded flv without live stream(empty: disable)
+  std::string edgeOriginHost; // rtmp pull of a stream not in this server(empty: disable)
+  int edgeOriginPort;
+  uint32_t edgeIdleTime; // ms(upstream close without viewers)
+  std::map<std::string, std::vector<std::string>> restreamUrls; // app, rtmp publish destinations
+  PlayerSendPolicy restreamSendPolicy;
+  std::vector<int> networkCpuSet; // io_context thread pin(empty: no pin, pool size = cpu count)
+  std::vector<int> serviceCpuSet; // main/timer/record/controller threads(default: cpus not in networkCpuSet)
+  uint32_t networkBusyPoll;       // us, SO_BUSY_POLL + io_context poll spin(0: disable)
+  bool networkReusePort;          // SO_REUSEPORT acceptor per network context(studio/player/flv/hls)
+
+  static std::string CpuSetToString(const std::vector<int> &cpus) {
+    std::string text;
+    for (auto cpu : cpus) {
+      text += (text.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    return text.empty() ? "all" : text;
+  }
 
   std::string ToString() const {
     std::ostringstream oss;
@@ -48,7 +83,30 @@ struct Config {
     oss << "  - Host ip : " << hostIp << std::endl;
     oss << "  - Studio port : " << playerPort << std::endl;
     oss << "  - Player port : " << playerPort << std::endl;
+    oss << "  - Http-flv port : " << flvPort << std::endl;
+    oss << "  - Hls port : " << hlsPort << std::endl;
     oss << "  - Controller : " << controllerHost << ":" << controllerPort << std::endl;
+    oss << "  - Gop cache : " << gopCacheDuration << "ms " << gopCacheSize << "byte burst(" << gopBurstRate
+        << "kbps)" << std::endl;
+    oss << "  - Player send limit : " << playerSendPolicy.maxBufferSize << "byte " << playerSendPolicy.maxDelay
+        << "ms audio drop(" << (playerSendPolicy.isAudioDrop ? "true" : "false") << ")" << std::endl;
+    oss << "  - Player aggregate : " << playerAggregateTime << "ms" << std::endl;
+    oss << "  - Hls : segment(" << hls.segmentDuration << "ms) window(" << hls.segmentCount << ") cache("
+        << hls.maxCacheSize << "byte) part(" << hls.partDuration << "ms)" << std::endl;
+    oss << "  - Record path : " << recordPath << std::endl;
+    oss << "  - Vod path : " << vodPath << std::endl;
+    oss << "  - Edge origin : " << edgeOriginHost << ":" << edgeOriginPort << " idle(" << edgeIdleTime << "ms)"
+        << std::endl;
+    oss << "  - Network cpu : " << CpuSetToString(networkCpuSet) << " service(" << CpuSetToString(serviceCpuSet)
+        << ") busy poll(" << networkBusyPoll << "us) reuse port(" << (networkReusePort ? "true" : "false") << ")"
+        << std::endl;
+    for (const auto &[app, urls] : restreamUrls) {
+      oss << "  - Restream(" << app << ") :";
+      for (const auto &url : urls) {
+        oss << " " << url;
+      }
+      oss << std::endl;
+    }
     return oss.str();
   }
 };
@@ -58,6 +116,9 @@ struct Config {
 //===============================================================================================
 class MainObject : public StudioEvent,
                    public PlayerEvent,
+                   public FlvEvent,
+                   public HlsEvent,
+                   public EdgeEvent,
                    public ControllerEvent,
                    public Network::NetEvent,
                    public std::enable_shared_from_this<MainObject> {
@@ -81,36 +142,73 @@ private:
 
   // Studio implement
   bool OnStudioStart(int indexKey, const std::string &streamPath);
-  bool OnStudioReady(int indexKey, const std::string &streamPath, const std::string &streamApp,
-                     const std::string &streamKey, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
-  bool OnStudioStream(int indexKey, const std::string &streamPath, const std::shared_ptr<Rtmp::Frame> &frame,
-                      bool isVideo);
+  std::shared_ptr<StreamHub> OnStudioReady(int indexKey, const std::string &streamPath, const std::string &streamApp,
+                                           const std::string &streamKey,
+                                           const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
 
   // Player implement
   bool OnPlayerStart(int indexKey, const std::string &streamPath);
-  std::shared_ptr<Rtmp::MediaInfo> OnPlayerPlay(int indexKey, const std::string &streamPath);
+  std::shared_ptr<StreamHub> OnPlayerPlay(int indexKey, const std::string &streamPath);
+  bool OnPlayerVod(int indexKey, const std::string &streamPath, const PlayerVodCallback &callback);
+  bool OnPlayerPull(int indexKey, const std::string &streamPath, const PlayerPullCallback &callback);
+
+  // Flv implement
+  std::shared_ptr<StreamHub> OnFlvPlay(int indexKey, const std::string &streamPath);
+
+  // Hls implement
+  std::shared_ptr<HlsPackager> OnHlsRequest(int indexKey, const std::string &streamPath);
+
+  // Edge implement
+  std::shared_ptr<StreamHub> OnEdgeReady(int indexKey, const std::string &streamPath,
+                                         const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  void EdgeRelease(const std::string &streamPath, int indexKey);
 
   // Controller implement
   void OnControllerStreamStart(const std::string &streamPath, const std::string &mediaId);
   void OnControllerStreamStop(const std::string &streamPath);
+  void OnControllerRestream(const std::string &streamPath, const std::vector<std::string> &urls);
+
+  std::vector<std::string> GetRestreamUrls(const std::string &streamPath, const std::string &streamApp);
+
+  std::pair<std::shared_ptr<StreamHub>, std::shared_ptr<HlsPackager>>
+  CreateStreamHub(int indexKey, const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
 
   void OnGarbageCheckTimer();
+  void OnEdgeIdleTimer();
   void OnInfoPrintTimer();
 
 private:
   std::unique_ptr<Config> _config;
   std::shared_ptr<StudioService> _studios;
   std::shared_ptr<PlayerService> _players;
+  std::shared_ptr<FlvService> _flvs;
+  std::shared_ptr<HlsService> _hlsService;
+  std::shared_ptr<RecordWriter> _recordWriter;
+  std::shared_ptr<VodFileCache> _vodFiles;
+  std::shared_ptr<EdgeService> _edges;
+  std::shared_ptr<RestreamService> _restreams;
   std::shared_ptr<Network::ContextPool> _netPool;
+  std::shared_ptr<Network::ContextPool> _servicePool; // controller, vod file open(off the network cpus)
   std::shared_ptr<Controller> _controller;
   std::thread _controllerThread;
   TimerManager _timer;
 
-  std::map<std::string, std::shared_ptr<Rtmp::MediaInfo>> _mediaInfos;
-  mutable std::mutex _mediaInfosLock;
-
-  std::multimap<std::string, int> _playerStreams;
-  mutable std::mutex _playerStreamsLock;
+  // publish/play/close only(frame delivery goes through the hub)
+  std::map<std::string, std::shared_ptr<StreamHub>> _streamHubs;
+  std::map<std::string, std::shared_ptr<HlsPackager>> _hlsPackagers;
+  std::map<std::string, std::shared_ptr<FlvRecorder>> _recorders;
+
+  // origin pull(one upstream per stream)
+  struct EdgePull {
+    int indexKey = -1; // -1 : connecting
+    std::shared_ptr<StreamHub> streamHub = nullptr;
+    bool isHls = false; // hls packager subscriber(not a viewer)
+    std::vector<PlayerPullCallback> waiters;
+    uint64_t idleStartTime = 0; // ms
+  };
+  std::map<std::string, EdgePull> _edgePulls; // _streamHubsLock
+  std::map<std::string, std::vector<std::string>> _restreamUrls; // controller set(stream path), _streamHubsLock
+  mutable std::mutex _streamHubsLock;
 
   redisContext *_redisContext; // Redis 컨텍스트
 };
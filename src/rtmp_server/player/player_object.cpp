@@ -1,5 +1,10 @@
 ﻿#include "player_object.h"
 
+constexpr uint64_t VodBufferTime = 1000;              // ms(sent ahead of the play time)
+constexpr uint64_t VodTickTime = 100;                 // ms(max wait)
+constexpr uint64_t VodPrefetchSize = 4 * 1024 * 1024; // byte
+constexpr uint64_t AggregateFlushRate = 2;            // timer flush at the window start + rate * aggregate time
+
 //====================================================================================================
 // Create
 //====================================================================================================
@@ -9,6 +14,7 @@ bool PlayerObject::Create(const std::shared_ptr<Network::NetTcpParam> &param) {
   }
 
   _stream = std::make_shared<PlayerStream>(std::static_pointer_cast<PlayerObject>(shared_from_this()));
+  _stream->SetAggregateTime(_aggregateTime);
   return true;
 }
 //====================================================================================================
@@ -21,7 +27,7 @@ bool PlayerObject::SendPackt(int dataSize, uint8_t *data) {
 //====================================================================================================
 //  Recv Handler
 //====================================================================================================
-int PlayerObject::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) { return _stream->RecvHandler(data); }
+int PlayerObject::RecvHandler(std::span<const uint8_t> data) { return _stream->RecvHandler(data); }
 
 //====================================================================================================
 // stream send
@@ -56,15 +62,417 @@ bool PlayerObject::OnStreamStart(const std::string &streamPath) {
 //====================================================================================================
 std::shared_ptr<Rtmp::MediaInfo> PlayerObject::OnStreamPlay(const std::string &streamPath) {
   _streamPath = streamPath;
-  return _event->OnPlayerPlay(_indexKey, _streamPath);
+  _sendDrop.SetLogName(
+      StringHelper::Format("Player index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(), _ip.c_str()));
+
+  _streamHub = _event->OnPlayerPlay(_indexKey, _streamPath);
+  if (_streamHub != nullptr) {
+    return _streamHub->GetMediaInfo();
+  }
+
+  return nullptr;
+}
+
+//====================================================================================================
+// play wait event
+//  - no live stream : recorded file(opened off the network thread), then the origin pull
+//====================================================================================================
+bool PlayerObject::OnStreamPlayWait(const std::string &streamPath) {
+  std::weak_ptr<PlayerObject> weakSelf = std::static_pointer_cast<PlayerObject>(shared_from_this());
+
+  if (_event->OnPlayerVod(_indexKey, streamPath, [weakSelf](const std::shared_ptr<FlvFile> &file) {
+        if (auto self = weakSelf.lock()) {
+          boost::asio::post(self->GetIoContext(), [self, file]() { self->OnVodOpenComplete(file); });
+        }
+      })) {
+    return true;
+  }
+
+  return Pull(streamPath);
+}
+
+//====================================================================================================
+// Pull(origin, the hub comes from the edge)
+//====================================================================================================
+bool PlayerObject::Pull(const std::string &streamPath) {
+  std::weak_ptr<PlayerObject> weakSelf = std::static_pointer_cast<PlayerObject>(shared_from_this());
+
+  return _event->OnPlayerPull(_indexKey, streamPath, [weakSelf](const std::shared_ptr<StreamHub> &streamHub) {
+    if (auto self = weakSelf.lock()) {
+      boost::asio::post(self->GetIoContext(), [self, streamHub]() { self->OnPullComplete(streamHub); });
+    }
+  });
+}
+
+//====================================================================================================
+// vod open complete
+//  - called on the player io_context, no file : origin pull
+//  - metadata/sequence headers are in the file(empty media info)
+//====================================================================================================
+void PlayerObject::OnVodOpenComplete(const std::shared_ptr<FlvFile> &file) {
+  if (!IsOpened()) {
+    return;
+  }
+
+  if (file == nullptr) {
+    if (!Pull(_streamPath)) {
+      _stream->PlayWaitComplete(nullptr);
+    }
+    return;
+  }
+
+  _vodFile = file;
+  if (!_stream->PlayWaitComplete(std::make_shared<Rtmp::MediaInfo>())) {
+    LOG_WARN("Player vod fail - index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(), _ip.c_str());
+  }
+}
+
+//====================================================================================================
+// pull complete
+//  - called on the player io_context
+//====================================================================================================
+void PlayerObject::OnPullComplete(const std::shared_ptr<StreamHub> &streamHub) {
+  if (!IsOpened()) {
+    return;
+  }
+
+  _streamHub = streamHub;
+  if (!_stream->PlayWaitComplete(streamHub ? streamHub->GetMediaInfo() : nullptr)) {
+    LOG_WARN("Player pull fail - index(%d) stream(%s) ip(%s)", _indexKey, _streamPath.c_str(), _ip.c_str());
+  }
+}
+
+//====================================================================================================
+// play start event
+//  - called on the player io_context, live frames posted by the hub run after the gop is queued
+//====================================================================================================
+bool PlayerObject::OnStreamPlayStart(const std::string &streamPath) {
+  if (_vodFile != nullptr) {
+    LOG_INFO("Player vod start - index(%d) stream(%s) file(%s)", _indexKey, streamPath.c_str(),
+             _vodFile->GetFilePath().c_str());
+    VodStart(_vodFile->GetFirstTagOffset(), false);
+    return true;
+  }
+
+  if (_streamHub == nullptr) {
+    return false;
+  }
+
+  LOG_INFO("Player play start - index(%d) stream(%s)", _indexKey, streamPath.c_str());
+
+  // stream affinity : subscribe after the socket moves to the context of the stream
+  if (auto contextPool = _contextPool.lock()) {
+    std::weak_ptr<PlayerObject> weakSelf = std::static_pointer_cast<PlayerObject>(shared_from_this());
+
+    if (PostMigrate(contextPool->GetStreamContext(_streamPath), [weakSelf]() {
+          if (auto self = weakSelf.lock(); self && self->IsOpened()) {
+            self->Subscribe();
+          }
+        })) {
+      return true;
+    }
+  }
+
+  Subscribe();
+  return true;
+}
+
+//====================================================================================================
+// Subscribe
+//  - called on the player io_context, frame delivery runs on this context
+//====================================================================================================
+void PlayerObject::Subscribe() {
+  SendGop(_streamHub->AddSubscriber(StreamHub::MakeSubscriberKey(_objectKey, _indexKey),
+                                    std::static_pointer_cast<PlayerObject>(shared_from_this())));
 }
 
 //====================================================================================================
-// Send video
+// Send frame
+//  - called on the player io_context(StreamHub delivery task)
 //====================================================================================================
-bool PlayerObject::SendVideo(const std::shared_ptr<Rtmp::Frame> &frame) { return _stream->SendVideo(frame); }
+bool PlayerObject::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  // gop burst sending
+  if (!_burstFrames.empty()) {
+    _burstFrames.push_back(frame);
+    return true;
+  }
+
+  if (!_sendDrop.Check(*this, frame)) {
+    return true;
+  }
+
+  return StreamSendFrame(frame);
+}
 
 //====================================================================================================
-// Send audio
+// Stream send frame
+//  - aggregate send : frames left in the stream are flushed by the timer
 //====================================================================================================
-bool PlayerObject::SendAudio(const std::shared_ptr<Rtmp::Frame> &frame) { return _stream->SendAudio(frame); }
+bool PlayerObject::StreamSendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (!_stream->SendFrame(frame)) {
+    return false;
+  }
+
+  StartAggregateTimer();
+  return true;
+}
+
+//====================================================================================================
+// Aggregate timer
+//====================================================================================================
+void PlayerObject::StartAggregateTimer() {
+  if (_isAggregateWait || !_stream->IsAggregatePending()) {
+    return;
+  }
+
+  if (!_aggregateTimer) {
+    _aggregateTimer = std::make_shared<boost::asio::steady_timer>(GetIoContext());
+  }
+
+  // a frame over the window boundary normally closes the window, the timer flushes a stalled stream
+  //  - flushed at the start of the pending window + AggregateFlushRate * _aggregateTime
+  const auto expireTick = _stream->GetAggregateStartTick() + _aggregateTime * AggregateFlushRate;
+  const auto currentTick = GetCurrentMs();
+
+  _isAggregateWait = true;
+  _aggregateTimer->expires_from_now(std::chrono::milliseconds(expireTick > currentTick ? expireTick - currentTick : 0));
+  _aggregateTimer->async_wait([weak = weak_from_this()](const boost::system::error_code &error) {
+    auto self = weak.lock();
+    if (error || !self) {
+      return;
+    }
+
+    auto player = std::static_pointer_cast<PlayerObject>(self);
+    player->_isAggregateWait = false;
+
+    if (player->_isClosing) {
+      return;
+    }
+
+    // the window of the timer was closed by a frame : wait for the pending one
+    if (GetCurrentMs() < player->_stream->GetAggregateStartTick() + player->_aggregateTime * AggregateFlushRate) {
+      player->StartAggregateTimer();
+      return;
+    }
+
+    player->_stream->FlushAggregate();
+  });
+}
+
+//====================================================================================================
+// Send gop
+//====================================================================================================
+void PlayerObject::SendGop(const std::vector<std::shared_ptr<RtmpExportFrame>> &frames) {
+  if (frames.empty()) {
+    return;
+  }
+
+  LOG_INFO("Player gop send - stream(%s) ip(%s) frame(%zu) rate(%ukbps)", _streamPath.c_str(), _ip.c_str(),
+           frames.size(), _gopBurstRate);
+
+  if (_gopBurstRate == 0) {
+    for (const auto &frame : frames) {
+      StreamSendFrame(frame);
+    }
+    return;
+  }
+
+  _burstFrames.assign(frames.begin(), frames.end());
+  _burstStartTick = GetCurrentMs();
+  _burstSendSize = 0;
+  BurstSend();
+}
+
+//====================================================================================================
+// Burst send
+//  - send gop(and live frames queued behind it) under _gopBurstRate
+//====================================================================================================
+void PlayerObject::BurstSend() {
+  if (_isClosing) {
+    _burstFrames.clear();
+    return;
+  }
+
+  uint64_t bytePerMs = std::max(_gopBurstRate / 8, 1u);
+  uint64_t allowSize = (GetCurrentMs() - _burstStartTick) * bytePerMs;
+
+  while (!_burstFrames.empty() && (_burstSendSize == 0 || _burstSendSize < allowSize)) {
+    _burstSendSize += _burstFrames.front()->GetSize();
+    if (_sendDrop.Check(*this, _burstFrames.front())) {
+      StreamSendFrame(_burstFrames.front());
+    }
+    _burstFrames.pop_front();
+  }
+
+  if (_burstFrames.empty()) {
+    return;
+  }
+
+  auto waitTime = std::max<uint64_t>((_burstSendSize - allowSize) / bytePerMs, 1);
+
+  if (!_burstTimer) {
+    _burstTimer = std::make_shared<boost::asio::steady_timer>(GetIoContext());
+  }
+
+  _burstTimer->expires_from_now(std::chrono::milliseconds(waitTime));
+  _burstTimer->async_wait([weak = weak_from_this()](const boost::system::error_code &error) {
+    auto self = weak.lock();
+    if (error || !self) {
+      return;
+    }
+
+    std::static_pointer_cast<PlayerObject>(self)->BurstSend();
+  });
+}
+
+//====================================================================================================
+// stream send(file mapping)
+//====================================================================================================
+bool PlayerObject::StreamSendMemory(const std::shared_ptr<const uint8_t> &data, size_t size) {
+  if (!PostSend(data, size)) {
+    LOG_ERROR("StreamSendMemory - post send fail - object(%s) ip(%s)", _objectName.c_str(), _ip.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// seek event(vod)
+//  - restart from the key frame before the timestamp, sequence headers first
+//====================================================================================================
+bool PlayerObject::OnStreamSeek(uint32_t timestamp) {
+  if (_vodFile == nullptr) {
+    return false;
+  }
+
+  LOG_INFO("Player vod seek - index(%d) stream(%s) time(%u)", _indexKey, _streamPath.c_str(), timestamp);
+  VodStart(_vodFile->Seek(timestamp), true);
+  return true;
+}
+
+//====================================================================================================
+// pause event(vod)
+//====================================================================================================
+bool PlayerObject::OnStreamPause(bool isPause) {
+  if (_vodFile == nullptr) {
+    return false;
+  }
+
+  if (!isPause) {
+    VodStart(_vodOffset, false);
+    return true;
+  }
+
+  _isVodPaused = true;
+  if (_vodTimer) {
+    _vodTimer->cancel();
+  }
+  return true;
+}
+
+//====================================================================================================
+// Vod start
+//  - play time restarts from the tag at offset(file start : first frame)
+//  - the first send runs after the current handler(status messages go first)
+//====================================================================================================
+void PlayerObject::VodStart(uint64_t offset, bool isSequenceHeaderSend) {
+  FlvFile::Tag tag;
+
+  _vodOffset = offset;
+  _vodPrefetchOffset = offset;
+  _vodStartTick = GetCurrentMs();
+  _vodStartTimestamp = offset == _vodFile->GetFirstTagOffset() || !_vodFile->ReadTag(offset, tag)
+                           ? _vodFile->GetStartTimestamp()
+                           : tag.timestamp;
+  _isVodSequenceHeaderSend = isSequenceHeaderSend;
+  _isVodPaused = false;
+
+  if (!_vodTimer) {
+    _vodTimer = std::make_shared<boost::asio::steady_timer>(GetIoContext());
+  }
+
+  _vodTimer->expires_from_now(std::chrono::milliseconds(0));
+  _vodTimer->async_wait([weak = weak_from_this()](const boost::system::error_code &error) {
+    auto self = weak.lock();
+    if (error || !self) {
+      return;
+    }
+
+    std::static_pointer_cast<PlayerObject>(self)->VodSend();
+  });
+}
+
+//====================================================================================================
+// Vod send
+//  - no read/copy per tag : chunk header + mapped tag body
+//====================================================================================================
+void PlayerObject::VodSend() {
+  if (_isClosing || _isVodPaused) {
+    return;
+  }
+
+  if (_isVodSequenceHeaderSend) {
+    _isVodSequenceHeaderSend = false;
+    for (const auto &tag : _vodFile->GetSequenceHeaders()) {
+      if (!_stream->SendRecordedTag(tag.type, _vodStartTimestamp, _vodFile->GetData(tag.data), tag.size)) {
+        VodSendFail();
+        return;
+      }
+    }
+  }
+
+  const uint64_t playTime = _vodStartTimestamp + (GetCurrentMs() - _vodStartTick) + VodBufferTime;
+  uint64_t waitTime = VodTickTime;
+  FlvFile::Tag tag;
+
+  while (!_sendDrop.IsSendOver(*this)) {
+    if (!_vodFile->ReadTag(_vodOffset, tag)) {
+      LOG_INFO("Player vod end - index(%d) stream(%s) time(%u)", _indexKey, _streamPath.c_str(),
+               _stream->GetLastVideoTimestamp());
+      _stream->SendPlayStop();
+      return;
+    }
+
+    if (tag.timestamp > playTime) {
+      waitTime = std::min<uint64_t>(tag.timestamp - playTime, VodTickTime);
+      break;
+    }
+
+    if (!_stream->SendRecordedTag(tag.type, tag.timestamp, _vodFile->GetData(tag.data), tag.size)) {
+      VodSendFail();
+      return;
+    }
+    _vodOffset = tag.nextOffset;
+  }
+
+  // page cache read ahead(one madvise per VodPrefetchSize)
+  if (_vodPrefetchOffset < _vodOffset + VodPrefetchSize) {
+    const auto prefetchStart = std::max(_vodPrefetchOffset, _vodOffset);
+    _vodPrefetchOffset = _vodOffset + VodPrefetchSize * 2;
+    _vodFile->Prefetch(prefetchStart, _vodPrefetchOffset - prefetchStart);
+  }
+
+  _vodTimer->expires_from_now(std::chrono::milliseconds(waitTime));
+  _vodTimer->async_wait([weak = weak_from_this()](const boost::system::error_code &error) {
+    auto self = weak.lock();
+    if (error || !self) {
+      return;
+    }
+
+    std::static_pointer_cast<PlayerObject>(self)->VodSend();
+  });
+}
+
+//====================================================================================================
+// Vod send fail
+//  - timer is not re-armed : stop the play, close when even the stop can not be sent
+//====================================================================================================
+void PlayerObject::VodSendFail() {
+  LOG_ERROR("Player vod send fail - index(%d) stream(%s) offset(%" PRIu64 ")", _indexKey, _streamPath.c_str(),
+            _vodOffset);
+
+  if (!_stream->SendPlayStop()) {
+    PostClose();
+  }
+}
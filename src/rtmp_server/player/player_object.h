@@ -1,23 +1,36 @@
 ﻿#pragma once
+#include "media/flv/flv_file.h"
 #include "network/network_tcp_object.h"
 #include "player_stream.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <deque>
+#include <functional>
 #include <memory>
 #include <vector>
 
+using PlayerPullCallback = std::function<void(const std::shared_ptr<StreamHub> &streamHub)>; // nullptr : fail
+using PlayerVodCallback = std::function<void(const std::shared_ptr<FlvFile> &file)>;         // nullptr : no file
+
 class PlayerEvent {
 public:
   virtual ~PlayerEvent() = default;
 
   virtual bool OnPlayerStart(int indexKey, const std::string &streamPath) = 0;
-  virtual std::shared_ptr<Rtmp::MediaInfo> OnPlayerPlay(int indexKey, const std::string &streamPath) = 0;
+  virtual std::shared_ptr<StreamHub> OnPlayerPlay(int indexKey, const std::string &streamPath) = 0;
+  // no live stream : recorded file opened off the network thread, false : no vod
+  virtual bool OnPlayerVod(int indexKey, const std::string &streamPath, const PlayerVodCallback &callback) = 0;
+  // no live stream and no file : origin pull(edge), false : no pull
+  virtual bool OnPlayerPull(int indexKey, const std::string &streamPath, const PlayerPullCallback &callback) = 0;
 };
 
 //====================================================================================================
 // Rtmp Client Object
 //====================================================================================================
-class PlayerObject : public PlayerStreamEvent, public Network::TcpObject {
+class PlayerObject : public PlayerStreamEvent, public StreamSubscriber, public Network::TcpObject {
 public:
-  PlayerObject(const std::shared_ptr<PlayerEvent> &event) : _event(event) {}
+  PlayerObject(const std::shared_ptr<PlayerEvent> &event, uint32_t gopBurstRate, const PlayerSendPolicy &sendPolicy,
+               uint32_t aggregateTime = 0)
+      : _event(event), _gopBurstRate(gopBurstRate), _aggregateTime(aggregateTime), _sendDrop(sendPolicy) {}
   virtual ~PlayerObject() = default;
 
 public:
@@ -25,23 +38,72 @@ public:
 
   bool SendPackt(int dataSize, uint8_t *data);
   const std::string &GetStreamPath() { return _streamPath; }
+  std::shared_ptr<StreamHub> GetStreamHub() const { return _streamHub; }
+  PlayerDropInfo GetDropInfo() const { return _sendDrop.GetDropInfo(_streamPath, _ip); }
 
-  bool SendVideo(const std::shared_ptr<Rtmp::Frame> &frame);
-  bool SendAudio(const std::shared_ptr<Rtmp::Frame> &frame);
+  // StreamSubscriber implement
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) override;
+  boost::asio::io_context &GetSubscriberContext() override { return GetIoContext(); }
 
 protected:
-  int RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data);
+  int RecvHandler(std::span<const uint8_t> data);
 
   // RtmpStream implement
   bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data);
   bool OnStreamStart(const std::string &streamPath);
   std::shared_ptr<Rtmp::MediaInfo> OnStreamPlay(const std::string &streamPath);
+  bool OnStreamPlayWait(const std::string &streamPath);
+  bool OnStreamPlayStart(const std::string &streamPath);
+  bool IsStreamRecorded() { return _vodFile != nullptr; }
+  bool StreamSendMemory(const std::shared_ptr<const uint8_t> &data, size_t size);
+  bool OnStreamSeek(uint32_t timestamp);
+  bool OnStreamPause(bool isPause);
+
+  bool Pull(const std::string &streamPath);
+  void OnVodOpenComplete(const std::shared_ptr<FlvFile> &file);
+  void OnPullComplete(const std::shared_ptr<StreamHub> &streamHub);
+  void Subscribe();
+  void SendGop(const std::vector<std::shared_ptr<RtmpExportFrame>> &frames);
+  void BurstSend();
+  bool StreamSendFrame(const std::shared_ptr<RtmpExportFrame> &frame);
+  void StartAggregateTimer();
+
+  void VodStart(uint64_t offset, bool isSequenceHeaderSend);
+  void VodSend();
+  void VodSendFail();
 
 private:
   std::shared_ptr<PlayerEvent> _event;
   std::shared_ptr<PlayerStream> _stream;
   std::string _streamPath;
-  std::shared_ptr<Rtmp::MediaInfo> _mediaInfo = nullptr;
+  std::shared_ptr<StreamHub> _streamHub = nullptr;
 
   uint64_t _lastAudioTimestamp = 0;
+
+  // gop burst(player io_context thread only)
+  uint32_t _gopBurstRate = 0; // kbps(0: no limit)
+  std::deque<std::shared_ptr<RtmpExportFrame>> _burstFrames;
+  std::shared_ptr<boost::asio::steady_timer> _burstTimer = nullptr;
+  uint64_t _burstStartTick = 0;
+  uint64_t _burstSendSize = 0;
+
+  // aggregate send(player io_context thread only)
+  //  - pending frames are flushed after _aggregateTime even if no more frame comes
+  uint32_t _aggregateTime = 0; // ms(0: off)
+  std::shared_ptr<boost::asio::steady_timer> _aggregateTimer = nullptr;
+  bool _isAggregateWait = false;
+
+  // vod(player io_context thread only)
+  //  - tags up to play time + VodBufferTime are sent from the file mapping, paused while the send is over
+  std::shared_ptr<FlvFile> _vodFile = nullptr;
+  std::shared_ptr<boost::asio::steady_timer> _vodTimer = nullptr;
+  uint64_t _vodOffset = 0;         // next tag
+  uint64_t _vodPrefetchOffset = 0; // read ahead end
+  uint64_t _vodStartTick = 0;
+  uint32_t _vodStartTimestamp = 0;
+  bool _isVodSequenceHeaderSend = false;
+  bool _isVodPaused = false;
+
+  // slow viewer drop(player io_context thread only, counters read by info timer)
+  PlayerSendDrop _sendDrop;
 };
@@ -16,7 +16,7 @@ int PlayerService::AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> soc
     return -1;
   }
 
-  auto object = std::make_shared<PlayerObject>(event);
+  auto object = std::make_shared<PlayerObject>(event, _gopBurstRate, _sendPolicy, _aggregateTime);
   if (object->Create(std::make_shared<Network::NetTcpParam>(_objectKey, _objectName, socket, _netEvent))) {
     return Insert(object, true, 5);
   }
@@ -35,29 +35,26 @@ const std::string &PlayerService::GetStreamPath(int indexKey) {
 }
 
 //====================================================================================================
-// Send Video
+// Get StreamHub
 //====================================================================================================
-bool PlayerService::SendVideo(const std::multimap<std::string, int>::iterator &begin,
-                              const std::multimap<std::string, int>::iterator &end,
-                              const std::shared_ptr<Rtmp::Frame> &frame) {
-  for (auto it = begin; it != end; ++it) {
-    if (auto object = Find(it->second); object != nullptr) {
-      std::static_pointer_cast<PlayerObject>(object)->SendVideo(frame);
-    }
+std::shared_ptr<StreamHub> PlayerService::GetStreamHub(int indexKey) {
+  if (auto object = Find(indexKey); object != nullptr) {
+    return std::static_pointer_cast<PlayerObject>(object)->GetStreamHub();
   }
-  return true;
+  return nullptr;
 }
 
 //====================================================================================================
-// Send Audio
+// Get drop info(drop players only)
 //====================================================================================================
-bool PlayerService::SendAudio(const std::multimap<std::string, int>::iterator &begin,
-                              const std::multimap<std::string, int>::iterator &end,
-                              const std::shared_ptr<Rtmp::Frame> &frame) {
-  for (auto it = begin; it != end; ++it) {
-    if (auto object = Find(it->second); object != nullptr) {
-      std::static_pointer_cast<PlayerObject>(object)->SendAudio(frame);
+std::shared_ptr<std::vector<PlayerDropInfo>> PlayerService::GetDropInfo() {
+  auto infos = std::make_shared<std::vector<PlayerDropInfo>>();
+
+  for (const auto &object : GetObjects()) {
+    if (auto info = std::static_pointer_cast<PlayerObject>(object)->GetDropInfo(); info.dropStart != 0) {
+      infos->push_back(info);
     }
   }
-  return true;
+
+  return infos;
 }
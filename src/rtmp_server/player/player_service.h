@@ -13,10 +13,16 @@ class PlayerService : public Network::TcpManager {
 public:
   PlayerService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent);
   int AcceptedAdd(std::shared_ptr<boost::asio::ip::tcp::socket> socket, const std::shared_ptr<PlayerEvent> &event);
+  void SetGopBurstRate(uint32_t gopBurstRate) { _gopBurstRate = gopBurstRate; }
+  void SetSendPolicy(const PlayerSendPolicy &sendPolicy) { _sendPolicy = sendPolicy; }
+  void SetAggregateTime(uint32_t aggregateTime) { _aggregateTime = aggregateTime; }
 
   const std::string &GetStreamPath(int indexKey);
-  bool SendVideo(const std::multimap<std::string, int>::iterator &begin,
-                 const std::multimap<std::string, int>::iterator &end, const std::shared_ptr<Rtmp::Frame> &frame);
-  bool SendAudio(const std::multimap<std::string, int>::iterator &begin,
-                 const std::multimap<std::string, int>::iterator &end, const std::shared_ptr<Rtmp::Frame> &frame);
+  std::shared_ptr<StreamHub> GetStreamHub(int indexKey);
+  std::shared_ptr<std::vector<PlayerDropInfo>> GetDropInfo();
+
+private:
+  uint32_t _gopBurstRate = 0; // kbps
+  PlayerSendPolicy _sendPolicy;
+  uint32_t _aggregateTime = 0; // ms(0: off)
 };
@@ -1,8 +1,11 @@
 ﻿#include "player_stream.h"
 #include "common/common_header.h"
+#include "media/flv/flv_mux_util.h"
 #include <string>
 #include <utility>
 
+constexpr size_t AggregateMaxSize = 256 * 1024; // byte, aggregate message body
+
 /*
 # Player 절차
   - handshake
@@ -18,9 +21,9 @@
 //====================================================================================================
 //  OnDataReceived
 //====================================================================================================
-int PlayerStream::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) {
-  if (data->size() > Rtmp::MaxPacketSize) {
-    LOG_ERROR("player - recv data size fail - stream(%s) size(%d)", _streamPath.c_str(), data->size());
+int PlayerStream::RecvHandler(std::span<const uint8_t> data) {
+  if (data.size() > Rtmp::MaxPacketSize) {
+    LOG_ERROR("player - recv data size fail - stream(%s) size(%zu)", _streamPath.c_str(), data.size());
     return -1;
   }
 
@@ -37,7 +40,7 @@ int PlayerStream::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data)
 //====================================================================================================
 // Handshake
 //====================================================================================================
-int PlayerStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+int PlayerStream::RecvHandshake(std::span<const uint8_t> data) {
   int procSize = 0;
 
   if (_handshakeState == Rtmp::HandshakeState::Ready) {
@@ -50,14 +53,14 @@ int PlayerStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
   }
 
   // Process Data Size Check
-  if (static_cast<int>(data->size()) < procSize) {
+  if (static_cast<int>(data.size()) < procSize) {
     return 0;
   }
 
   // c0+c1 / s0+s1+s2
   if (_handshakeState == Rtmp::HandshakeState::Ready) {
-    if ((*data)[0] != Rtmp::HandshakeVersion) {
-      LOG_WRITE("player - handshake version fail - version(%d:%d)", (*data)[0], Rtmp::HandshakeVersion);
+    if (data[0] != Rtmp::HandshakeVersion) {
+      LOG_WRITE("player - handshake version fail - version(%d:%d)", data[0], Rtmp::HandshakeVersion);
       return -1;
     }
     _handshakeState = Rtmp::HandshakeState::C0;
@@ -74,8 +77,8 @@ int PlayerStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
   _handshakeState = Rtmp::HandshakeState::C2;
 
   // chunk가 같이 들어오는 경우 처리
-  if (procSize < static_cast<int>(data->size())) {
-    int chunkProcSize = RecvChunk(std::make_shared<std::vector<uint8_t>>(data->begin() + procSize, data->end()));
+  if (procSize < static_cast<int>(data.size())) {
+    int chunkProcSize = RecvChunk(data.subspan(procSize));
 
     if (chunkProcSize < 0) {
       return -1;
@@ -93,7 +96,7 @@ int PlayerStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
 // SendHandshake
 // s0+s1+s2
 //====================================================================================================
-bool PlayerStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+bool PlayerStream::SendHandshake(std::span<const uint8_t> data) {
   _handshakeState = Rtmp::HandshakeState::C1;
 
   // S0 S1 S2 Send
@@ -102,7 +105,7 @@ bool PlayerStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t
     return false;
   }
 
-  if (!event->StreamSendData(RtmpHandshake::MakeS0_S1_S2(data->data() + 1))) {
+  if (!event->StreamSendData(RtmpHandshake::MakeS0_S1_S2(data.data() + 1))) {
     LOG_ERROR("player - handshake s0+s1+s2 send fail");
     return false;
   }
@@ -115,11 +118,11 @@ bool PlayerStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t
 //====================================================================================================
 // RecvChunk
 //====================================================================================================
-int32_t PlayerStream::RecvChunk(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+int32_t PlayerStream::RecvChunk(std::span<const uint8_t> data) {
   int procSize = 0;
 
-  while (procSize < static_cast<int>(data->size())) {
-    auto [size, isComplete] = _imortChunk->ImportStreamData(data->data() + procSize, data->size() - procSize);
+  while (procSize < static_cast<int>(data.size())) {
+    auto [size, isComplete] = _imortChunk->ImportStreamData(data.data() + procSize, data.size() - procSize);
 
     if (size == 0) {
       break;
@@ -264,6 +267,10 @@ void PlayerStream::OnAmfCmdMsg(const std::shared_ptr<ImportMsg> &msg) {
     OnAmfDeleteStream(msg->header, doc, transacrtionId);
   } else if (command == Rtmp::Cmd::Play) {
     OnAmfPlay(msg->header, doc);
+  } else if (command == Rtmp::Cmd::Seek) {
+    OnAmfSeek(msg->header, doc);
+  } else if (command == Rtmp::Cmd::Pause) {
+    OnAmfPause(msg->header, doc);
   } else {
     LOG_WARN("player - unknown amf0 command message - stream(%s) "
              "message(%s:%.1f)",
@@ -341,9 +348,15 @@ bool PlayerStream::OnAmfPlay(const std::shared_ptr<RtmpMuxMsgHeader> &header, co
     return false;
   }
 
+  if (_isPlayStart || _isPlayWait) {
+    LOG_WARN("player - play again - stream(%s)", _streamPath.c_str());
+    return false;
+  }
+
   // stream key setting
   _streamKey = doc->GetProp(nameIndex)->GetString();
   _streamPath = _streamApp + "/" + _streamKey;
+  _chunkStreamId = chunkId;
 
   // play callback
   auto event = _event.lock();
@@ -353,13 +366,61 @@ bool PlayerStream::OnAmfPlay(const std::shared_ptr<RtmpMuxMsgHeader> &header, co
 
   const auto mediaInfo = event->OnStreamPlay(_streamPath);
   if (mediaInfo == nullptr) {
+    // no live stream : recorded file or origin pull(edge)
+    if (event->OnStreamPlayWait(_streamPath)) {
+      _isPlayWait = true;
+      return true;
+    }
+
     // Reject
     SendAmfOnStatus(chunkId, _streamId, "error", "NetStream.Play.BadConnection", "Authentication Failed.", _clientId);
     return false;
   }
 
+  return StartPlay(mediaInfo);
+}
+
+//====================================================================================================
+// Play wait complete(vod open, edge pull)
+//====================================================================================================
+bool PlayerStream::PlayWaitComplete(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (!_isPlayWait) {
+    return false;
+  }
+  _isPlayWait = false;
+
+  if (mediaInfo == nullptr) {
+    LOG_WARN("player - play wait fail - stream(%s)", _streamPath.c_str());
+    SendAmfOnStatus(static_cast<uint32_t>(_chunkStreamId), _streamId, "error", "NetStream.Play.StreamNotFound",
+                    "Stream not found.", _clientId);
+    return false;
+  }
+
+  return StartPlay(mediaInfo);
+}
+
+//====================================================================================================
+// Start play
+//====================================================================================================
+bool PlayerStream::StartPlay(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  const auto chunkId = static_cast<uint32_t>(_chunkStreamId);
+
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
   _mediaInfo = mediaInfo;
 
+  // recorded stream : metadata/sequence headers are the file tags(sent by the vod reader)
+  _isRecorded = event->IsStreamRecorded();
+  if (_isRecorded) {
+    if (!SendSetChunkSize(Rtmp::MaxChunkSize) || !SendStreamIsRecorded() || !SendStreamBegin()) {
+      LOG_ERROR("player - recorded stream start fail - stream(%s)", _streamPath.c_str());
+      return false;
+    }
+  }
+
   SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Play.Reset", "Playing and resetting stream.", _clientId);
   SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Play.Start", "Started playing stream.", _clientId);
 
@@ -377,9 +438,73 @@ bool PlayerStream::OnAmfPlay(const std::shared_ptr<RtmpMuxMsgHeader> &header, co
 
   _isPlayStart = true;
 
+  // gop cache + live frame start
+  if (!event->OnStreamPlayStart(_streamPath)) {
+    LOG_ERROR("player - play start fail - stream(%s)", _streamPath.c_str());
+    return false;
+  }
+
   return true;
 }
 
+//====================================================================================================
+// Amf Command - Seek(recorded stream only)
+//  - 3 : milliseconds
+//  - the vod reader restarts from the key frame before the position, after these status messages
+//====================================================================================================
+void PlayerStream::OnAmfSeek(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc) {
+  const auto chunkId = header->chunkStreamId;
+
+  auto event = _event.lock();
+  if (!event) {
+    return;
+  }
+
+  if (!_isRecorded || doc->GetProp(3) == nullptr || doc->GetProp(3)->GetType() != AmfDataType::Number ||
+      !event->OnStreamSeek(static_cast<uint32_t>(std::max(doc->GetProp(3)->GetNumber(), 0.0)))) {
+    SendAmfOnStatus(chunkId, _streamId, "error", "NetStream.Seek.Failed", "Seek failed.", _clientId);
+    return;
+  }
+
+  SendStreamEof();
+  SendStreamIsRecorded();
+  SendStreamBegin();
+  SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Seek.Notify", "Seeking.", _clientId);
+  SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Play.Start", "Started playing stream.", _clientId);
+}
+
+//====================================================================================================
+// Amf Command - Pause(recorded stream only)
+//  - 3 : pause(true)/unpause(false)
+//  - unpause resumes from the paused position
+//====================================================================================================
+void PlayerStream::OnAmfPause(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc) {
+  const auto chunkId = header->chunkStreamId;
+
+  auto event = _event.lock();
+  if (!event) {
+    return;
+  }
+
+  if (!_isRecorded || doc->GetProp(3) == nullptr || doc->GetProp(3)->GetType() != AmfDataType::Boolean) {
+    SendAmfOnStatus(chunkId, _streamId, "error", "NetStream.Pause.Failed", "Pause failed.", _clientId);
+    return;
+  }
+
+  const bool isPause = doc->GetProp(3)->GetBoolean();
+  if (!event->OnStreamPause(isPause)) {
+    return;
+  }
+
+  if (isPause) {
+    SendStreamEof();
+    SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Pause.Notify", "Paused stream.", _clientId);
+  } else {
+    SendStreamBegin();
+    SendAmfOnStatus(chunkId, _streamId, "status", "NetStream.Unpause.Notify", "Unpaused stream.", _clientId);
+  }
+}
+
 //====================================================================================================
 // Amf Command - Publish
 //====================================================================================================
@@ -400,7 +525,7 @@ bool PlayerStream::SendMsg(std::shared_ptr<RtmpMuxMsgHeader> header,
     return false;
   }
 
-  auto exportData = _exportChunk->ExportStreamData(header, data);
+  auto exportData = _exportChunk->ExportStreamData(*header, data);
 
   if (exportData == nullptr || exportData->data() == nullptr) {
     return false;
@@ -422,7 +547,8 @@ bool PlayerStream::SendAmfCmd(std::shared_ptr<RtmpMuxMsgHeader> header, const st
     return false;
   }
 
-  auto body = std::make_shared<std::vector<uint8_t>>(2048);
+  // meta data is publisher data : sized from the doc
+  auto body = BufferPool::Alloc(doc->GetEncodeSize());
 
   // body
   uint32_t bodySize = static_cast<uint32_t>(doc->Encode(body->data()));
@@ -499,6 +625,43 @@ bool PlayerStream::SendStreamBegin() {
   return SendUserControlMsg(static_cast<int>(Rtmp::UserControlMsgType::StreamBegin), body);
 }
 
+//====================================================================================================
+// StreamEof / StreamIsRecorded
+//====================================================================================================
+bool PlayerStream::SendStreamEof() {
+  auto body = std::make_shared<std::vector<uint8_t>>(4);
+
+  RtmpMuxUtil::WriteInt32(body->data(), _streamId);
+
+  return SendUserControlMsg(static_cast<int>(Rtmp::UserControlMsgType::StreamEof), body);
+}
+
+bool PlayerStream::SendStreamIsRecorded() {
+  auto body = std::make_shared<std::vector<uint8_t>>(4);
+
+  RtmpMuxUtil::WriteInt32(body->data(), _streamId);
+
+  return SendUserControlMsg(static_cast<int>(Rtmp::UserControlMsgType::StreamIsRecorded), body);
+}
+
+//====================================================================================================
+// SetChunkSize
+//  - following messages use the new size
+//====================================================================================================
+bool PlayerStream::SendSetChunkSize(int chunkSize) {
+  auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+  RtmpMuxUtil::WriteInt32(body->data(), chunkSize);
+
+  if (!SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Urgent), 0,
+                                                  static_cast<int>(Rtmp::MsgType::SetChunkSize), 0, body->size()),
+               body)) {
+    return false;
+  }
+
+  _exportChunk->SetChunkSize(chunkSize);
+  return true;
+}
+
 //====================================================================================================
 // SendAmfConnectResult
 //====================================================================================================
@@ -638,37 +801,150 @@ bool PlayerStream::SendAudioSequenceData(std::shared_ptr<std::vector<uint8_t>> s
 }
 
 //====================================================================================================
-// Send Video Frame
+// Send Frame
+//  - chunk data is shared with the other players(no per player chunking)
 //====================================================================================================
-bool PlayerStream::SendVideo(const std::shared_ptr<Rtmp::Frame> &frame) {
+bool PlayerStream::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
   // start check
   if (!_isPlayStart) {
     return true;
   }
 
   // set last timestamp
-  _lastVideoTimestamp = frame->timestamp;
+  if (frame->IsVideo()) {
+    if (_isKeyFrameWait) {
+      if (!frame->IsKeyFrame()) {
+        return true;
+      }
+      _isKeyFrameWait = false;
+    }
+    _lastVideoTimestamp = frame->GetTimestamp();
+  } else {
+    _lastAudioTimestamp = frame->GetTimestamp();
+  }
 
-  return SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Stream), frame->timestamp,
-                                                    static_cast<int>(Rtmp::MsgType::VideoMsg), _streamId,
-                                                    frame->data->size()),
-                 frame->data);
+  if (_aggregateTime != 0) {
+    return AppendAggregate(frame);
+  }
+
+  auto chunkData = frame->GetChunkData(_exportChunk->GetChunkSize(), _streamId);
+  if (chunkData == nullptr) {
+    return false;
+  }
+
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->StreamSendData(chunkData);
 }
 
 //====================================================================================================
-// Send Audio Frame
+// Append aggregate
+//  - a window ends at the first frame over the next multiple of _aggregateTime(frame timestamp)
+//  - players of a stream cut the same windows and share the aggregate message, the player timer flushes the rest
 //====================================================================================================
-bool PlayerStream::SendAudio(const std::shared_ptr<Rtmp::Frame> &frame) {
+bool PlayerStream::AppendAggregate(const std::shared_ptr<RtmpExportFrame> &frame) {
+  auto subSize = FlvMuxUtil::GetFlvTagSize(frame->GetSize());
 
-  if (!_isPlayStart) {
+  if (!_aggregateFrames.empty() && _aggregateSize + subSize > AggregateMaxSize && !FlushAggregate()) {
+    return false;
+  }
+
+  if (_aggregateFrames.empty()) {
+    _aggregateStartTick = GetCurrentMs();
+  }
+
+  _aggregateFrames.push_back(frame);
+  _aggregateSize += subSize;
+
+  if (_aggregateSize >= AggregateMaxSize ||
+      frame->GetTimestamp() >= (_aggregateFrames.front()->GetTimestamp() / _aggregateTime + 1) * _aggregateTime) {
+    return FlushAggregate();
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Flush aggregate
+//  - single frame : shared chunk data of the frame(no copy)
+//  - frames : shared aggregate message of the window(kept on the last frame)
+//====================================================================================================
+bool PlayerStream::FlushAggregate() {
+  if (_aggregateFrames.empty()) {
     return true;
   }
 
-  // set last timestamp
-  _lastAudioTimestamp = frame->timestamp;
+  std::shared_ptr<std::vector<uint8_t>> chunkData;
 
-  return SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Stream), frame->timestamp,
-                                                    static_cast<int>(Rtmp::MsgType::AudioMsg), _streamId,
-                                                    frame->data->size()),
-                 frame->data);
+  if (_aggregateFrames.size() == 1) {
+    chunkData = _aggregateFrames.front()->GetChunkData(_exportChunk->GetChunkSize(), _streamId);
+  } else {
+    chunkData = _aggregateFrames.back()->GetAggregateChunkData(_aggregateFrames, _exportChunk->GetChunkSize(),
+                                                               _streamId);
+  }
+
+  _aggregateFrames.clear();
+  _aggregateSize = 0;
+
+  if (chunkData == nullptr) {
+    return false;
+  }
+
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->StreamSendData(chunkData);
+}
+
+//====================================================================================================
+// Send recorded tag
+//  - chunk header buffer + tag body(file mapping), one chunk per tag
+//====================================================================================================
+bool PlayerStream::SendRecordedTag(Flv::TagType type, uint32_t timestamp, const std::shared_ptr<const uint8_t> &data,
+                                   size_t size) {
+  if (!_isPlayStart || size == 0) {
+    return true;
+  }
+
+  if (size > static_cast<size_t>(_exportChunk->GetChunkSize())) {
+    LOG_ERROR("player - recorded tag size fail - stream(%s) size(%zu)", _streamPath.c_str(), size);
+    return false;
+  }
+
+  if (type == Flv::TagType::Video) {
+    _lastVideoTimestamp = timestamp;
+  } else if (type == Flv::TagType::Audio) {
+    _lastAudioTimestamp = timestamp;
+  }
+
+  // flv tag type == rtmp message type(audio/video/amf0 data)
+  auto header = RtmpExportChunk::ExportMsgHeader(RtmpMuxMsgHeader(
+      static_cast<int>(Rtmp::ChunkStreamType::Stream), timestamp, static_cast<int>(type), _streamId, size));
+  if (header == nullptr) {
+    return false;
+  }
+
+  auto event = _event.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->StreamSendData(header) && event->StreamSendMemory(data, size);
+}
+
+//====================================================================================================
+// Send play stop(recorded stream end)
+//====================================================================================================
+bool PlayerStream::SendPlayStop() {
+  if (!SendStreamEof()) {
+    return false;
+  }
+
+  return SendAmfOnStatus(_chunkStreamId, _streamId, "status", "NetStream.Play.Stop", "Stopped playing stream.",
+                         _clientId);
 }
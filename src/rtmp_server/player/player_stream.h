@@ -1,12 +1,15 @@
 #pragma once
+#include "media/flv/flv_define.h"
 #include "media/rtmp/amf_document.h"
 #include "media/rtmp/rtmp_export_chunk.h"
+#include "media/rtmp/rtmp_export_frame.h"
 #include "media/rtmp/rtmp_handshake.h"
 #include "media/rtmp/rtmp_import_chunk.h"
 #include "media/rtmp/rtmp_media_parser.h"
 #include <functional>
 #include <map>
 #include <memory>
+#include <span>
 #include <vector>
 
 class PlayerStreamEvent {
@@ -16,6 +19,14 @@ public:
   virtual bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data) = 0;
   virtual bool OnStreamStart(const std::string &streamPath) = 0;
   virtual std::shared_ptr<Rtmp::MediaInfo> OnStreamPlay(const std::string &streamPath) = 0;
+  virtual bool OnStreamPlayWait(const std::string &streamPath) = 0; // no local stream : PlayWaitComplete later
+  virtual bool OnStreamPlayStart(const std::string &streamPath) = 0;
+
+  // recorded(vod) stream only
+  virtual bool IsStreamRecorded() = 0;
+  virtual bool StreamSendMemory(const std::shared_ptr<const uint8_t> &data, size_t size) = 0;
+  virtual bool OnStreamSeek(uint32_t timestamp) = 0;
+  virtual bool OnStreamPause(bool isPause) = 0;
 };
 
 //====================================================================================================
@@ -27,19 +38,28 @@ public:
   virtual ~PlayerStream() = default;
 
 public:
-  int RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data);
+  int RecvHandler(std::span<const uint8_t> data);
   const std::string &GetStreamPath() { return _streamPath; }
   uint32_t GetLastVideoTimestamp() { return _lastVideoTimestamp; }
   uint32_t GetLastAudioTimestamp() { return _lastAudioTimestamp; }
 
-  bool SendVideo(const std::shared_ptr<Rtmp::Frame> &frame);
-  bool SendAudio(const std::shared_ptr<Rtmp::Frame> &frame);
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame);
+  void SetAggregateTime(uint32_t aggregateTime) { _aggregateTime = aggregateTime; }
+  bool IsAggregatePending() const { return !_aggregateFrames.empty(); }
+  uint64_t GetAggregateStartTick() const { return _aggregateStartTick; } // ms, first pending frame
+  bool FlushAggregate(); // pending frames -> one aggregate message
+  bool PlayWaitComplete(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo); // nullptr : stream not found
+
+  // recorded stream : one chunk per tag(MaxChunkSize), tag body sent from the file mapping
+  bool SendRecordedTag(Flv::TagType type, uint32_t timestamp, const std::shared_ptr<const uint8_t> &data,
+                       size_t size);
+  bool SendPlayStop();
 
 protected:
-  int32_t RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data);
-  int32_t RecvChunk(const std::shared_ptr<const std::vector<uint8_t>> &data);
+  int32_t RecvHandshake(std::span<const uint8_t> data);
+  int32_t RecvChunk(std::span<const uint8_t> data);
 
-  bool SendHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data);
+  bool SendHandshake(std::span<const uint8_t> data);
 
   bool RecvChunkMsg();
   bool OnSetChunkSize(const std::shared_ptr<ImportMsg> &msg);
@@ -54,6 +74,9 @@ protected:
                          double transacrtionId);
 
   bool OnAmfPlay(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc);
+  bool StartPlay(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  void OnAmfSeek(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc);
+  void OnAmfPause(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc);
 
   bool SendMsg(const std::shared_ptr<RtmpMuxMsgHeader> header, const std::shared_ptr<std::vector<uint8_t>> &data);
   bool SendUserControlMsg(const uint16_t msg, const std::shared_ptr<std::vector<uint8_t>> &data);
@@ -61,6 +84,9 @@ protected:
   bool SendWindowAckSize();
   bool SendSetPeerBandwidth();
   bool SendStreamBegin();
+  bool SendStreamEof();
+  bool SendStreamIsRecorded();
+  bool SendSetChunkSize(int chunkSize);
   bool SendAckSize();
 
   bool SendAmfCmd(std::shared_ptr<RtmpMuxMsgHeader> header, const std::shared_ptr<AmfDoc> &doc);
@@ -74,6 +100,8 @@ protected:
   bool SendVideoSequenceData(std::shared_ptr<std::vector<uint8_t>> seqHeader);
   bool SendAudioSequenceData(std::shared_ptr<std::vector<uint8_t>> seqHeader);
 
+  bool AppendAggregate(const std::shared_ptr<RtmpExportFrame> &frame);
+
 private:
   std::string _streamPath;
   std::string _streamApp;
@@ -94,6 +122,15 @@ private:
   uint64_t _lastAudioTimestamp = 0;
   uint8_t _audioControlByte = 0; // only player
   bool _isPlayStart = false;
+  bool _isPlayWait = false;    // vod open, edge pull
+  bool _isKeyFrameWait = true; // video start from key frame
+  bool _isRecorded = false;    // vod
+
+  // aggregate send(0: off, one message per frame)
+  uint32_t _aggregateTime = 0; // ms
+  std::vector<std::shared_ptr<RtmpExportFrame>> _aggregateFrames;
+  size_t _aggregateSize = 0;       // byte, sub message total
+  uint64_t _aggregateStartTick = 0; // ms
 
   std::weak_ptr<PlayerStreamEvent> _event;
 };
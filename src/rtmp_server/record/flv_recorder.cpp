@@ -0,0 +1,50 @@
+#include "flv_recorder.h"
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+FlvRecorder::FlvRecorder(const std::shared_ptr<RecordWriter> &writer,
+                         const std::shared_ptr<boost::asio::io_context> &ioContext)
+    : _writer(writer), _ioContext(ioContext) {}
+
+FlvRecorder::~FlvRecorder() { Close(); }
+
+//====================================================================================================
+// Open
+//====================================================================================================
+bool FlvRecorder::Open(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  _isVideo = mediaInfo->videoSeqHeader != nullptr;
+  _recordId = _writer->Open(streamPath, mediaInfo);
+  return _recordId >= 0;
+}
+
+//====================================================================================================
+// Close
+//  - frames already posted to the subscriber io_context are dropped by the writer
+//====================================================================================================
+void FlvRecorder::Close() {
+  if (auto recordId = _recordId.exchange(-1); recordId >= 0) {
+    _writer->Close(recordId);
+  }
+}
+
+//====================================================================================================
+// Send frame
+//====================================================================================================
+bool FlvRecorder::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  const auto recordId = _recordId.load();
+  if (recordId < 0) {
+    return true;
+  }
+
+  if (!_isStarted) {
+    if (_isVideo && !frame->IsKeyFrame()) {
+      return true;
+    }
+    _isStarted = true;
+  }
+
+  _writer->Write(recordId, frame->GetFlvTag(), static_cast<uint32_t>(frame->GetTimestamp()),
+                 frame->IsKeyFrame());
+  return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "record_writer.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+//====================================================================================================
+// FlvRecorder
+//  - one per published stream, subscribes to the StreamHub like a player
+//  - SendFrame only queues the shared flv tag to the RecordWriter(no disk io on the subscriber io_context)
+//  - recording starts on the first key frame(audio only : first frame)
+//====================================================================================================
+class FlvRecorder : public StreamSubscriber {
+public:
+  FlvRecorder(const std::shared_ptr<RecordWriter> &writer, const std::shared_ptr<boost::asio::io_context> &ioContext);
+  ~FlvRecorder() override;
+
+  bool Open(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  void Close();
+
+  // StreamSubscriber implement
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) override;
+  boost::asio::io_context &GetSubscriberContext() override { return *_ioContext; }
+
+private:
+  std::shared_ptr<RecordWriter> _writer;
+  std::shared_ptr<boost::asio::io_context> _ioContext;
+  std::atomic<int> _recordId{-1};
+  bool _isVideo = false;
+
+  // subscriber io_context only
+  bool _isStarted = false;
+};
@@ -0,0 +1,400 @@
+#include "record_writer.h"
+#include "media/flv/flv_mux_util.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/uio.h>
+#include <unistd.h>
+
+constexpr auto FlushInterval = std::chrono::milliseconds(200);
+constexpr size_t MaxPendingSize = 4 * 1024 * 1024;     // byte per file(flush before the interval)
+constexpr uint64_t MaxQueueSize = 256 * 1024 * 1024;   // byte(disk too slow : tags are dropped)
+constexpr uint64_t AllocateSize = 16 * 1024 * 1024;    // byte(fallocate step)
+constexpr size_t MetaDataBodySize = 48 * 1024;         // byte(reserved onMetaData, keyframe index ~2700)
+constexpr size_t MetaDataOffset = Flv::HeaderSize + Flv::PreviousTagSize;
+constexpr size_t KeyFrameEntrySize = 2 * 9;            // position + time(amf number)
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+RecordWriter::RecordWriter(const std::string &recordPath) : _recordPath(recordPath) {}
+
+RecordWriter::~RecordWriter() { Stop(); }
+
+//====================================================================================================
+// Start
+//====================================================================================================
+bool RecordWriter::Start() {
+  std::error_code error;
+  std::filesystem::create_directories(_recordPath, error);
+  if (error) {
+    LOG_ERROR("Record path create fail - path(%s) error(%s)", _recordPath.c_str(), error.message().c_str());
+    return false;
+  }
+
+  _running = true;
+  _thread = std::thread(&RecordWriter::WriterThread, this);
+  return true;
+}
+
+//====================================================================================================
+// Stop(open files are finalized)
+//====================================================================================================
+void RecordWriter::Stop() {
+  _running = false;
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+}
+
+//====================================================================================================
+// Open
+//  - file name : {recordPath}/{app}_{key}_{yyyymmdd-hhmmss}.flv
+//====================================================================================================
+int RecordWriter::Open(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (!_running) {
+    return -1;
+  }
+
+  auto name = streamPath;
+  std::replace(name.begin(), name.end(), '/', '_');
+
+  time_t now = time(nullptr);
+  tm tm;
+  localtime_r(&now, &tm);
+
+  Task task;
+  task.type = TaskType::Open;
+  task.recordId = _nextRecordId++;
+  task.filePath = StringHelper::Format("%s/%s_%04d%02d%02d-%02d%02d%02d.flv", _recordPath.c_str(), name.c_str(),
+                                       tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+  task.mediaInfo = mediaInfo;
+
+  auto recordId = task.recordId;
+  _tasks.Push(std::move(task));
+  return recordId;
+}
+
+//====================================================================================================
+// Write
+//  - called on the network threads, never blocks
+//====================================================================================================
+void RecordWriter::Write(int recordId, const std::shared_ptr<std::vector<uint8_t>> &tag, uint32_t timestamp,
+                         bool isKeyFrame) {
+  if (tag == nullptr || !_running) {
+    return;
+  }
+
+  if (_queueSize.fetch_add(tag->size()) + tag->size() > MaxQueueSize) {
+    _queueSize -= tag->size();
+    LOG_WARN("Record queue over - record(%d) size(%" PRIu64 ")", recordId, _queueSize.load());
+    return;
+  }
+
+  Task task;
+  task.recordId = recordId;
+  task.tag = tag;
+  task.timestamp = timestamp;
+  task.isKeyFrame = isKeyFrame;
+  _tasks.Push(std::move(task));
+}
+
+//====================================================================================================
+// Close
+//====================================================================================================
+void RecordWriter::Close(int recordId) {
+  Task task;
+  task.type = TaskType::Close;
+  task.recordId = recordId;
+  _tasks.Push(std::move(task));
+}
+
+//====================================================================================================
+// Writer thread
+//====================================================================================================
+void RecordWriter::WriterThread() {
+  while (true) {
+    const bool isRunning = _running;
+
+    Task task;
+    while (_tasks.Pop(task)) {
+      switch (task.type) {
+      case TaskType::Open:
+        OnOpen(task);
+        break;
+      case TaskType::Write:
+        _queueSize -= task.tag->size();
+        OnWrite(task);
+        break;
+      case TaskType::Close:
+        OnClose(task.recordId);
+        break;
+      }
+    }
+
+    for (auto it = _files.begin(); it != _files.end();) {
+      if (!Flush(it->second)) {
+        close(it->second.fd);
+        it = _files.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    if (!isRunning) {
+      while (!_files.empty()) {
+        OnClose(_files.begin()->first);
+      }
+      break;
+    }
+
+    std::this_thread::sleep_for(FlushInterval);
+  }
+}
+
+//====================================================================================================
+// Open file
+//  - flv header + reserved onMetaData + sequence headers
+//====================================================================================================
+void RecordWriter::OnOpen(Task &task) {
+  int fd = open(task.filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    LOG_ERROR("Record open fail - file(%s) error(%s)", task.filePath.c_str(), strerror(errno));
+    return;
+  }
+
+  auto &file = _files[task.recordId];
+  file.fd = fd;
+  file.filePath = task.filePath;
+  file.mediaInfo = task.mediaInfo;
+
+  const auto &mediaInfo = file.mediaInfo;
+  Append(file, FlvMuxUtil::MakeFlvHeader(mediaInfo->audioSeqHeader != nullptr, mediaInfo->videoSeqHeader != nullptr));
+
+  auto metaData = MakeMetaDataBody(file);
+  Append(file, FlvMuxUtil::MakeFlvTag(Flv::TagType::Script, 0, metaData.data(), metaData.size()));
+
+  for (const auto &[seqHeader, type] : {std::pair{mediaInfo->videoSeqHeader, Flv::TagType::Video},
+                                        std::pair{mediaInfo->audioSeqHeader, Flv::TagType::Audio}}) {
+    if (seqHeader != nullptr) {
+      Append(file, FlvMuxUtil::MakeFlvTag(type, 0, seqHeader->data(), seqHeader->size()));
+    }
+  }
+
+  LOG_INFO("Record open - record(%d) file(%s)", task.recordId, file.filePath.c_str());
+}
+
+//====================================================================================================
+// Write tag
+//====================================================================================================
+void RecordWriter::OnWrite(Task &task) {
+  auto it = _files.find(task.recordId);
+  if (it == _files.end()) {
+    // open fail or closed
+    return;
+  }
+
+  auto &file = it->second;
+  if (task.isKeyFrame) {
+    file.keyFrames.push_back({task.timestamp, file.writeOffset});
+  }
+  file.lastTimestamp = std::max(file.lastTimestamp, task.timestamp);
+
+  Append(file, task.tag);
+
+  if (file.pendingSize >= MaxPendingSize && !Flush(file)) {
+    close(file.fd);
+    _files.erase(it);
+  }
+}
+
+//====================================================================================================
+// Close file
+//  - rewrite the reserved onMetaData(same size) with the final values
+//====================================================================================================
+void RecordWriter::OnClose(int recordId) {
+  auto it = _files.find(recordId);
+  if (it == _files.end()) {
+    return;
+  }
+
+  auto &file = it->second;
+  if (Flush(file)) {
+    auto metaData = MakeMetaDataBody(file);
+    auto tag = FlvMuxUtil::MakeFlvTag(Flv::TagType::Script, 0, metaData.data(), metaData.size());
+    if (pwrite(file.fd, tag->data(), tag->size(), MetaDataOffset) != static_cast<ssize_t>(tag->size())) {
+      LOG_ERROR("Record metadata write fail - file(%s) error(%s)", file.filePath.c_str(), strerror(errno));
+    }
+  }
+
+  // release the reserved space over the file end(truncate to the same size)
+  if (file.allocateOffset != UINT64_MAX && file.allocateOffset > file.flushOffset) {
+    if (ftruncate(file.fd, static_cast<off_t>(file.flushOffset)) != 0) {
+      LOG_WARN("Record truncate fail - file(%s) error(%s)", file.filePath.c_str(), strerror(errno));
+    }
+  }
+
+  LOG_INFO("Record close - record(%d) file(%s) size(%" PRIu64 ") keyframe(%zu)", recordId, file.filePath.c_str(),
+           file.flushOffset, file.keyFrames.size());
+
+  close(file.fd);
+  _files.erase(it);
+}
+
+//====================================================================================================
+// Append(written on the next flush)
+//====================================================================================================
+void RecordWriter::Append(RecordFile &file, const std::shared_ptr<std::vector<uint8_t>> &tag) {
+  file.writeOffset += tag->size();
+  file.pendingSize += tag->size();
+  file.pendings.push_back(tag);
+}
+
+//====================================================================================================
+// Flush
+//  - pending tags are written by pwritev(IOV_MAX per call), partial writes continue from the written byte
+//====================================================================================================
+bool RecordWriter::Flush(RecordFile &file) {
+  if (file.pendings.empty()) {
+    return true;
+  }
+
+  if (file.allocateOffset != UINT64_MAX && file.writeOffset > file.allocateOffset) {
+    auto size = (file.writeOffset - file.allocateOffset + AllocateSize - 1) / AllocateSize * AllocateSize;
+    if (fallocate(file.fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(file.allocateOffset), static_cast<off_t>(size)) ==
+        0) {
+      file.allocateOffset += size;
+    } else {
+      file.allocateOffset = UINT64_MAX;
+    }
+  }
+
+  std::vector<iovec> iovs;
+  iovs.reserve(std::min<size_t>(file.pendings.size(), IOV_MAX));
+
+  size_t index = 0;
+  size_t skip = 0; // written byte of pendings[index]
+
+  while (index < file.pendings.size()) {
+    iovs.clear();
+    for (auto i = index; i < file.pendings.size() && iovs.size() < IOV_MAX; ++i) {
+      auto &data = *file.pendings[i];
+      auto offset = i == index ? skip : 0;
+      iovs.push_back({data.data() + offset, data.size() - offset});
+    }
+
+    auto written = pwritev(file.fd, iovs.data(), static_cast<int>(iovs.size()), static_cast<off_t>(file.flushOffset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("Record write fail - file(%s) error(%s)", file.filePath.c_str(), strerror(errno));
+      return false;
+    }
+
+    file.flushOffset += written;
+    auto remain = static_cast<size_t>(written);
+    while (remain > 0) {
+      auto size = file.pendings[index]->size() - skip;
+      if (remain < size) {
+        skip += remain;
+        break;
+      }
+      remain -= size;
+      skip = 0;
+      index++;
+    }
+  }
+
+  file.pendings.clear();
+  file.pendingSize = 0;
+  return true;
+}
+
+//====================================================================================================
+// Make onMetaData body(always MetaDataBodySize)
+//  - "onMetaData" EcmaArray[duration, filesize, width, height, codec ids, keyframes{filepositions, times}, padding]
+//  - over the reserved size the keyframe index is thinned out, the rest is filled by the padding string
+//====================================================================================================
+std::vector<uint8_t> RecordWriter::MakeMetaDataBody(const RecordFile &file) {
+  std::vector<uint8_t> body(MetaDataBodySize + 256, 0);
+  auto *output = body.data();
+
+  auto writeName = [&output](const char *name) {
+    auto length = std::strlen(name);
+    output += AmfUtil::WriteInt16(output, static_cast<uint16_t>(length));
+    std::memcpy(output, name, length);
+    output += length;
+  };
+
+  auto writeNumber = [&](const char *name, double value) {
+    writeName(name);
+    output += AmfUtil::EncodeNumber(output, value);
+  };
+
+  const auto &mediaInfo = file.mediaInfo;
+  const bool isVideo = mediaInfo->videoSeqHeader != nullptr;
+  const bool isAudio = mediaInfo->audioSeqHeader != nullptr;
+
+  output += AmfUtil::EncodeString(output, "onMetaData");
+  output += AmfUtil::WriteInt8(output, static_cast<uint8_t>(AmfTypeMarker::EcmaArray));
+  output += AmfUtil::WriteInt32(output, 4 + (isVideo ? 3 : 0) + (isAudio ? 3 : 0) + 1);
+
+  writeNumber("duration", file.lastTimestamp / 1000.0);
+  writeNumber("filesize", static_cast<double>(file.flushOffset));
+  if (isVideo) {
+    writeNumber("width", mediaInfo->video ? mediaInfo->video->width : 0);
+    writeNumber("height", mediaInfo->video ? mediaInfo->video->height : 0);
+    // enhanced rtmp : fourcc value as the codec id
+    const auto &seqHeader = *mediaInfo->videoSeqHeader;
+    const bool isExHeader = (seqHeader[0] & Rtmp::VideoExHeaderFlag) && seqHeader.size() >= Rtmp::VideoFrameIndex;
+    writeNumber("videocodecid", isExHeader ? Rtmp::MakeFourCc(seqHeader[1], seqHeader[2], seqHeader[3], seqHeader[4])
+                                           : seqHeader[0] & 0x0f);
+  }
+  if (isAudio) {
+    writeNumber("audiocodecid", mediaInfo->audioSeqHeader->front() >> 4);
+    writeNumber("audiosamplerate", mediaInfo->audio ? mediaInfo->audio->sampleRate : 0);
+    writeName("stereo");
+    output += AmfUtil::EncodeBoolean(output, mediaInfo->audio && mediaInfo->audio->channels > 1);
+  }
+  writeName("hasKeyframes");
+  output += AmfUtil::EncodeBoolean(output, !file.keyFrames.empty());
+
+  // keyframes : Object{filepositions: StrictArray, times: StrictArray}
+  constexpr size_t IndexHeaderSize = 64;
+  constexpr size_t PaddingHeaderSize = 16;
+  const auto fixedSize = static_cast<size_t>(output - body.data()) + IndexHeaderSize + PaddingHeaderSize;
+  const auto maxCount = fixedSize < MetaDataBodySize ? (MetaDataBodySize - fixedSize) / KeyFrameEntrySize : 0;
+  const auto step = file.keyFrames.size() > maxCount && maxCount != 0
+                        ? (file.keyFrames.size() + maxCount - 1) / maxCount
+                        : 1;
+
+  std::vector<const KeyFrame *> keyFrames;
+  for (size_t index = 0; maxCount != 0 && index < file.keyFrames.size(); index += step) {
+    keyFrames.push_back(&file.keyFrames[index]);
+  }
+
+  writeName("keyframes");
+  output += AmfUtil::WriteInt8(output, static_cast<uint8_t>(AmfTypeMarker::Object));
+  for (int type = 0; type < 2; ++type) {
+    writeName(type == 0 ? "filepositions" : "times");
+    output += AmfUtil::WriteInt8(output, static_cast<uint8_t>(AmfTypeMarker::StrictArray));
+    output += AmfUtil::WriteInt32(output, static_cast<uint32_t>(keyFrames.size()));
+    for (const auto *keyFrame : keyFrames) {
+      output += AmfUtil::EncodeNumber(output, type == 0 ? static_cast<double>(keyFrame->position)
+                                                        : keyFrame->timestamp / 1000.0);
+    }
+  }
+  output += AmfUtil::WriteInt24(output, static_cast<uint32_t>(AmfTypeMarker::ObjectEnd));
+
+  // padding string fills the body to the reserved size(name(2 + 7) + marker(1) + length(2) + end(3))
+  const auto used = static_cast<size_t>(output - body.data()) + 2 + 7 + 1 + 2 + 3;
+  writeName("padding");
+  output += AmfUtil::EncodeString(output, std::string(MetaDataBodySize - used, ' ').c_str());
+  output += AmfUtil::WriteInt24(output, static_cast<uint32_t>(AmfTypeMarker::ObjectEnd));
+
+  body.resize(output - body.data());
+  return body;
+}
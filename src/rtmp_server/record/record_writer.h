@@ -0,0 +1,79 @@
+#pragma once
+#include "common/mpsc_queue.hpp"
+#include "media/rtmp/rtmp_media_parser.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//====================================================================================================
+// RecordWriter(flv file)
+//  - one writer thread for every recording, no disk io on the network threads
+//  - producers push the shared flv tags to a lock free queue(no copy, no lock)
+//  - the thread wakes every FlushInterval, drains the queue and writes each file with pwritev batches
+//  - file space is reserved by fallocate in AllocateSize steps(file size kept)
+//  - onMetaData is reserved at the file head and rewritten on close(duration, filesize, keyframe index)
+//====================================================================================================
+class RecordWriter {
+public:
+  explicit RecordWriter(const std::string &recordPath);
+  ~RecordWriter();
+
+  bool Start();
+  void Stop();
+
+  // return record id(-1 : not running), file is opened on the writer thread
+  int Open(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo);
+  void Write(int recordId, const std::shared_ptr<std::vector<uint8_t>> &tag, uint32_t timestamp, bool isKeyFrame);
+  void Close(int recordId);
+
+private:
+  enum class TaskType { Open, Write, Close };
+
+  struct Task {
+    TaskType type = TaskType::Write;
+    int recordId = -1;
+    std::shared_ptr<std::vector<uint8_t>> tag = nullptr;
+    uint32_t timestamp = 0;
+    bool isKeyFrame = false;
+    std::string filePath;
+    std::shared_ptr<Rtmp::MediaInfo> mediaInfo = nullptr;
+  };
+
+  struct KeyFrame {
+    uint32_t timestamp; // ms
+    uint64_t position;  // tag offset in the file
+  };
+
+  struct RecordFile {
+    int fd = -1;
+    std::string filePath;
+    std::shared_ptr<Rtmp::MediaInfo> mediaInfo;
+    uint64_t writeOffset = 0;    // file size including pending tags
+    uint64_t flushOffset = 0;    // written to the file
+    uint64_t allocateOffset = 0; // fallocate end(UINT64_MAX : not supported)
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> pendings;
+    size_t pendingSize = 0;
+    std::vector<KeyFrame> keyFrames;
+    uint32_t lastTimestamp = 0;
+  };
+
+  void WriterThread();
+  void OnOpen(Task &task);
+  void OnWrite(Task &task);
+  void OnClose(int recordId);
+  void Append(RecordFile &file, const std::shared_ptr<std::vector<uint8_t>> &tag);
+  bool Flush(RecordFile &file);
+  static std::vector<uint8_t> MakeMetaDataBody(const RecordFile &file);
+
+  std::string _recordPath;
+  MpscQueue<Task> _tasks;
+  std::atomic<uint64_t> _queueSize{0}; // byte(tags waiting for the writer thread)
+  std::atomic<int> _nextRecordId{0};
+  std::atomic<bool> _running{false};
+  std::thread _thread;
+
+  std::map<int, RecordFile> _files; // writer thread only
+};
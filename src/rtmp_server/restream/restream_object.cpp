@@ -0,0 +1,78 @@
+#include "restream_object.h"
+#include "common/common_header.h"
+
+//====================================================================================================
+// Create
+//====================================================================================================
+bool RestreamObject::Create(const std::shared_ptr<Network::NetTcpParam> &param, const std::string &tcUrl,
+                            const std::string &app, const std::string &key) {
+  if (!Network::TcpObject::Create(param)) {
+    return false;
+  }
+
+  _stream = std::make_shared<RestreamStream>(std::static_pointer_cast<RestreamObject>(shared_from_this()), tcUrl,
+                                             app, key);
+  return true;
+}
+
+//====================================================================================================
+// Publish start(handshake)
+//====================================================================================================
+bool RestreamObject::PublishStart() { return _stream->Start(); }
+
+//====================================================================================================
+//  Recv Handler
+//====================================================================================================
+int RestreamObject::RecvHandler(std::span<const uint8_t> data) { return _stream->RecvHandler(data); }
+
+//====================================================================================================
+// stream send
+//====================================================================================================
+bool RestreamObject::StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data) {
+  if (!PostSend(data)) {
+    LOG_ERROR("StreamSendData - post send fail - object(%s) url(%s)", _objectName.c_str(), _url.c_str());
+    return false;
+  }
+  return true;
+}
+
+//====================================================================================================
+// publish start(NetStream.Publish.Start)
+//  - media info first, then gop cache + live frames from the hub
+//====================================================================================================
+bool RestreamObject::OnStreamPublish() {
+  if (!_stream->SendMediaInfo(_streamHub->GetMediaInfo())) {
+    LOG_ERROR("OnStreamPublish - media info send fail - object(%s) url(%s)", _objectName.c_str(), _url.c_str());
+    return false;
+  }
+
+  LOG_INFO("Restream publish start - index(%d) stream(%s) url(%s)", _indexKey,
+           _streamHub->GetStreamPath().c_str(), _url.c_str());
+  _sendDrop.SetLogName(StringHelper::Format("Restream index(%d) url(%s)", _indexKey, _url.c_str()));
+
+  auto frames = _streamHub->AddSubscriber(StreamHub::MakeSubscriberKey(_objectKey, _indexKey),
+                                          std::static_pointer_cast<RestreamObject>(shared_from_this()));
+  for (const auto &frame : frames) {
+    SendFrame(frame);
+  }
+  return true;
+}
+
+//====================================================================================================
+// Send frame
+//  - called on the restream io_context(StreamHub delivery task)
+//====================================================================================================
+bool RestreamObject::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (frame->IsVideo() && _isKeyFrameWait) {
+    if (!frame->IsKeyFrame()) {
+      return true;
+    }
+    _isKeyFrameWait = false;
+  }
+
+  if (!_sendDrop.Check(*this, frame)) {
+    return true;
+  }
+
+  return _stream->SendFrame(frame);
+}
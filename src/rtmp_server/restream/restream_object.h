@@ -0,0 +1,47 @@
+#pragma once
+#include "network/network_tcp_object.h"
+#include "restream_stream.h"
+#include "rtmp_server/stream/stream_hub.h"
+#include <memory>
+#include <string>
+
+//====================================================================================================
+// Restream Object(outbound publish session)
+//  - one per destination, subscribes to the local hub after NetStream.Publish.Start
+//  - slow destination : frames are dropped until the next key frame under the send policy
+//====================================================================================================
+class RestreamObject : public RestreamStreamEvent, public StreamSubscriber, public Network::TcpObject {
+public:
+  RestreamObject(const std::shared_ptr<StreamHub> &streamHub, const std::string &url,
+                 const PlayerSendPolicy &sendPolicy)
+      : _streamHub(streamHub), _url(url), _sendDrop(sendPolicy) {}
+  virtual ~RestreamObject() = default;
+
+public:
+  bool Create(const std::shared_ptr<Network::NetTcpParam> &param, const std::string &tcUrl, const std::string &app,
+              const std::string &key);
+  bool PublishStart();
+  const std::string &GetUrl() { return _url; }
+  std::shared_ptr<StreamHub> GetStreamHub() const { return _streamHub; }
+  uint64_t GetDropCount() const { return _sendDrop.GetDropCount(); }
+
+  // StreamSubscriber implement
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) override;
+  boost::asio::io_context &GetSubscriberContext() override { return GetIoContext(); }
+
+protected:
+  int RecvHandler(std::span<const uint8_t> data) override;
+
+  // RestreamStream implement
+  bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data);
+  bool OnStreamPublish();
+
+private:
+  std::shared_ptr<RestreamStream> _stream;
+  std::shared_ptr<StreamHub> _streamHub;
+  std::string _url;
+
+  // slow destination drop(restream io_context thread only)
+  PlayerSendDrop _sendDrop;
+  bool _isKeyFrameWait = true; // empty gop cache : the destination starts on a key frame
+};
@@ -0,0 +1,280 @@
+#include "restream_service.h"
+#include "common/common_header.h"
+#include <algorithm>
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+RestreamService::RestreamService(int objectKey, const std::string &objectName,
+                                 const std::shared_ptr<Network::NetEvent> &netEvent, const PlayerSendPolicy &sendPolicy)
+    : Network::TcpManager(objectKey, objectName, netEvent), _sendPolicy(sendPolicy) {}
+
+//====================================================================================================
+// Start
+//  - urls not in the list are closed, new urls connect now, the others keep their session
+//  - a new hub(republish) reconnects the kept urls too
+//====================================================================================================
+void RestreamService::Start(const std::string &streamPath, const std::shared_ptr<StreamHub> &streamHub,
+                            const std::vector<std::string> &urls) {
+  std::vector<int> removeIndexKeys;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_targetsLock);
+    for (auto it = _targets.begin(); it != _targets.end();) {
+      auto &target = it->second;
+      if (target.streamPath != streamPath) {
+        ++it;
+        continue;
+      }
+
+      const bool isKeep = std::find(urls.begin(), urls.end(), target.url) != urls.end();
+      if (target.indexKey != -1 && (!isKeep || target.streamHub != streamHub)) {
+        removeIndexKeys.push_back(target.indexKey);
+        target.indexKey = -1;
+      }
+
+      if (!isKeep) {
+        LOG_INFO("Restream remove - stream(%s) url(%s)", streamPath.c_str(), target.url.c_str());
+        it = _targets.erase(it);
+        continue;
+      }
+
+      target.streamHub = streamHub;
+      target.retryCount = 0;
+      target.retryTime = 0;
+      ++it;
+    }
+
+    for (const auto &url : urls) {
+      auto exist = std::find_if(_targets.begin(), _targets.end(), [&](const auto &item) {
+        return item.second.streamPath == streamPath && item.second.url == url;
+      });
+      if (exist != _targets.end()) {
+        continue;
+      }
+
+      Target target;
+      target.streamPath = streamPath;
+      target.url = url;
+      target.streamHub = streamHub;
+      if (!ParseUrl(url, target)) {
+        LOG_ERROR("Restream url fail - stream(%s) url(%s)", streamPath.c_str(), url.c_str());
+        continue;
+      }
+
+      LOG_INFO("Restream add - stream(%s) url(%s)", streamPath.c_str(), url.c_str());
+      _targets.emplace(++_targetId, std::move(target));
+    }
+  }
+
+  RemoveObjects(removeIndexKeys);
+
+  if (streamHub != nullptr) {
+    CheckReconnect();
+  }
+}
+
+//====================================================================================================
+// Stop(all destinations of the stream)
+//====================================================================================================
+void RestreamService::Stop(const std::string &streamPath) { Start(streamPath, nullptr, {}); }
+
+//====================================================================================================
+// Reconnect check
+//  - connect due destinations, retry count is reset after a stable connection
+//====================================================================================================
+void RestreamService::CheckReconnect() {
+  const auto currentTime = GetCurrentMs();
+  std::vector<std::tuple<int, std::string, int>> connects;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_targetsLock);
+    for (auto &[targetId, target] : _targets) {
+      if (target.indexKey != -1) {
+        if (target.retryCount != 0 && currentTime - target.connectTime >= RetryResetTime) {
+          target.retryCount = 0;
+        }
+        continue;
+      }
+
+      if (target.isConnecting || target.streamHub == nullptr || currentTime < target.retryTime) {
+        continue;
+      }
+
+      target.isConnecting = true;
+      connects.emplace_back(targetId, target.host, target.port);
+    }
+  }
+
+  for (const auto &[targetId, host, port] : connects) {
+    if (!Connect(targetId, host, port)) {
+      OnConnectFail(targetId);
+    }
+  }
+}
+
+//====================================================================================================
+// Connect
+//====================================================================================================
+bool RestreamService::Connect(int targetId, const std::string &host, int port) {
+  return ResolveConnect(host, port, std::make_shared<RestreamConnectedParam>(targetId));
+}
+
+//====================================================================================================
+// Object 추가(Connected)
+//====================================================================================================
+int RestreamService::ConnectedAdd(const std::shared_ptr<RestreamConnectedParam> &param) {
+  if (param->socket == nullptr) {
+    return -1;
+  }
+
+  Target target;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_targetsLock);
+    auto it = _targets.find(param->targetId);
+    if (it == _targets.end() || it->second.streamHub == nullptr) {
+      return -1; // removed while connecting
+    }
+    target = it->second;
+  }
+
+  const auto tcUrl = StringHelper::Format("rtmp://%s:%d/%s", target.host.c_str(), target.port, target.app.c_str());
+
+  auto object = std::make_shared<RestreamObject>(target.streamHub, target.url, _sendPolicy);
+  if (!object->Create(std::make_shared<Network::NetTcpParam>(_objectKey, _objectName, param->socket, _netEvent), tcUrl,
+                      target.app, target.key)) {
+    return -1;
+  }
+
+  auto indexKey = Insert(object);
+  if (indexKey == -1) {
+    return -1;
+  }
+
+  // start before the target owns the indexKey : a failed start is retried by OnConnectFail only, not by Closed too
+  if (!object->PublishStart()) {
+    Remove(indexKey);
+    return -1;
+  }
+
+  bool isTarget = false;
+
+  // --- Lock Block ---
+  {
+    std::lock_guard<std::mutex> lock(_targetsLock);
+    auto it = _targets.find(param->targetId);
+    if (it != _targets.end() && it->second.streamHub == target.streamHub) {
+      it->second.indexKey = indexKey;
+      it->second.isConnecting = false;
+      it->second.connectTime = GetCurrentMs();
+      isTarget = true;
+    }
+  }
+
+  if (!isTarget) {
+    Remove(indexKey); // removed or republished while connecting
+    return -1;
+  }
+
+  return indexKey;
+}
+
+//====================================================================================================
+// Connect fail
+//====================================================================================================
+void RestreamService::OnConnectFail(int targetId) {
+  // --- Lock Block ---
+  std::lock_guard<std::mutex> lock(_targetsLock);
+  if (auto it = _targets.find(targetId); it != _targets.end()) {
+    auto &target = it->second;
+    target.isConnecting = false;
+    target.indexKey = -1;
+    target.retryTime = GetCurrentMs() + GetRetryDelay(target.retryCount++);
+
+    LOG_WARN("Restream connect fail - stream(%s) url(%s) retry(%u)", target.streamPath.c_str(), target.url.c_str(),
+             target.retryCount);
+  }
+}
+
+//====================================================================================================
+// Closed
+//  - destination closed by the network, reconnect after the backoff delay
+//====================================================================================================
+void RestreamService::Closed(int indexKey) {
+  RemoveObjects({indexKey});
+
+  // --- Lock Block ---
+  std::lock_guard<std::mutex> lock(_targetsLock);
+  for (auto &[targetId, target] : _targets) {
+    if (target.indexKey != indexKey) {
+      continue;
+    }
+
+    target.indexKey = -1;
+    target.retryTime = GetCurrentMs() + GetRetryDelay(target.retryCount++);
+
+    LOG_WARN("Restream closed - stream(%s) url(%s) retry(%u)", target.streamPath.c_str(), target.url.c_str(),
+             target.retryCount);
+    break;
+  }
+}
+
+//====================================================================================================
+// Remove objects(hub subscriber + session)
+//====================================================================================================
+void RestreamService::RemoveObjects(const std::vector<int> &indexKeys) {
+  for (auto indexKey : indexKeys) {
+    if (auto object = std::static_pointer_cast<RestreamObject>(Find(indexKey)); object != nullptr) {
+      object->GetStreamHub()->RemoveSubscriber(StreamHub::MakeSubscriberKey(_objectKey, indexKey));
+    }
+    Remove(indexKey);
+  }
+}
+
+//====================================================================================================
+// Get target count
+//====================================================================================================
+uint32_t RestreamService::GetTargetCount() const {
+  std::lock_guard<std::mutex> lock(_targetsLock);
+  return static_cast<uint32_t>(_targets.size());
+}
+
+//====================================================================================================
+// Url parse
+//  - rtmp://host[:port]/app/key(key may contain '/' and a query)
+//====================================================================================================
+bool RestreamService::ParseUrl(const std::string &url, Target &target) {
+  const std::string scheme = "rtmp://";
+  if (url.compare(0, scheme.size(), scheme) != 0) {
+    return false;
+  }
+
+  const auto hostEnd = url.find('/', scheme.size());
+  const auto appEnd = (hostEnd != std::string::npos) ? url.find('/', hostEnd + 1) : std::string::npos;
+  if (appEnd == std::string::npos || appEnd + 1 >= url.size()) {
+    return false;
+  }
+
+  auto host = url.substr(scheme.size(), hostEnd - scheme.size());
+  if (const auto pos = host.rfind(':'); pos != std::string::npos) {
+    target.port = std::atoi(host.substr(pos + 1).c_str());
+    host = host.substr(0, pos);
+  }
+
+  target.host = host;
+  target.app = url.substr(hostEnd + 1, appEnd - hostEnd - 1);
+  target.key = url.substr(appEnd + 1);
+
+  return !target.host.empty() && !target.app.empty() && target.port > 0;
+}
+
+//====================================================================================================
+// Retry delay(exponential backoff)
+//====================================================================================================
+uint64_t RestreamService::GetRetryDelay(uint32_t retryCount) {
+  return std::min<uint64_t>(RetryMinTime << std::min<uint32_t>(retryCount, 16), RetryMaxTime);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "network/network_tcp_manager.h"
+#include "restream_object.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct RestreamConnectedParam : public Network::TcpConnectedParam {
+  explicit RestreamConnectedParam(int targetId_) : targetId(targetId_) {}
+  int targetId;
+};
+
+//====================================================================================================
+// Restream Service
+//  - rtmp publish client, a published stream is forwarded to N destinations(rtmp://host[:port]/app/key)
+//  - Start -> connect -> OnConnected(RestreamConnectedParam) -> ConnectedAdd
+//  - every destination reconnects by itself(backoff), a failing one does not affect the others
+//====================================================================================================
+class RestreamService : public Network::TcpManager {
+public:
+  RestreamService(int objectKey, const std::string &objectName, const std::shared_ptr<Network::NetEvent> &netEvent,
+                  const PlayerSendPolicy &sendPolicy);
+
+  void Start(const std::string &streamPath, const std::shared_ptr<StreamHub> &streamHub,
+             const std::vector<std::string> &urls); // destination list replace
+  void Stop(const std::string &streamPath);
+  void CheckReconnect(); // timer
+
+  int ConnectedAdd(const std::shared_ptr<RestreamConnectedParam> &param);
+  void OnConnectFail(int targetId);
+  void Closed(int indexKey); // network close(subscriber remove + reconnect wait)
+
+  uint32_t GetTargetCount() const;
+
+  static constexpr uint64_t RetryMinTime = 1000;    // ms
+  static constexpr uint64_t RetryMaxTime = 60000;   // ms
+  static constexpr uint64_t RetryResetTime = 30000; // ms(stable connection)
+
+private:
+  struct Target {
+    std::string streamPath;
+    std::string url;
+    std::string host;
+    int port = 1935;
+    std::string app;
+    std::string key;
+    std::shared_ptr<StreamHub> streamHub = nullptr;
+    int indexKey = -1; // -1 : not connected
+    bool isConnecting = false;
+    uint32_t retryCount = 0;
+    uint64_t retryTime = 0;   // ms(next connect)
+    uint64_t connectTime = 0; // ms
+  };
+
+  static bool ParseUrl(const std::string &url, Target &target);
+  static uint64_t GetRetryDelay(uint32_t retryCount);
+  bool Connect(int targetId, const std::string &host, int port);
+  void RemoveObjects(const std::vector<int> &indexKeys);
+
+private:
+  PlayerSendPolicy _sendPolicy;
+
+  int _targetId = 0;
+  std::map<int, Target> _targets; // id, never locked while a slot shard lock is held
+  mutable std::mutex _targetsLock;
+};
@@ -0,0 +1,174 @@
+#include "restream_stream.h"
+#include <utility>
+
+constexpr double ConnectTransactionId = 1.0;
+constexpr double ReleaseStreamTransactionId = 2.0;
+constexpr double FcPublishTransactionId = 3.0;
+constexpr double CreateStreamTransactionId = 4.0;
+constexpr double PublishTransactionId = 5.0;
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+RestreamStream::RestreamStream(const std::shared_ptr<RestreamStreamEvent> &event, const std::string &tcUrl,
+                               const std::string &app, const std::string &key)
+    : RtmpClientSession(event, "restream", tcUrl, app, key), _event(event) {}
+
+//====================================================================================================
+// Handshake complete(SetChunkSize + connect)
+//====================================================================================================
+bool RestreamStream::OnHandshakeComplete() {
+  auto object = std::make_shared<AmfObject>();
+  object->AddProp("app", _streamApp.c_str());
+  object->AddProp("type", "nonprivate");
+  object->AddProp("flashVer", "FMLE/3.0 (compatible; FMSc/1.0)");
+  object->AddProp("swfUrl", _tcUrl.c_str());
+  object->AddProp("tcUrl", _tcUrl.c_str());
+
+  return SendSetChunkSize(ChunkSize) && SendAmfConnect(object, ConnectTransactionId);
+}
+
+//====================================================================================================
+// Amf - _result
+//====================================================================================================
+bool RestreamStream::OnAmfResult(const std::shared_ptr<AmfDoc> &doc, double transactionId) {
+  if (transactionId == ConnectTransactionId) {
+    if (!SendAmfStreamCmd(Rtmp::Cmd::ReleaseStream, ReleaseStreamTransactionId) ||
+        !SendAmfStreamCmd(Rtmp::Cmd::FcPublish, FcPublishTransactionId) ||
+        !SendAmfCreateStream(CreateStreamTransactionId)) {
+      LOG_ERROR("restream - send amf create stream fail - url(%s)", _tcUrl.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  if (transactionId == CreateStreamTransactionId) {
+    if (!OnAmfCreateStreamResult(doc)) {
+      return false;
+    }
+
+    if (!SendAmfPublish()) {
+      LOG_ERROR("restream - send amf publish fail - url(%s)", _tcUrl.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Amf - _error
+//  - releaseStream/FCPublish are optional on most servers
+//====================================================================================================
+bool RestreamStream::OnAmfError(double transactionId) {
+  if (transactionId == ReleaseStreamTransactionId || transactionId == FcPublishTransactionId) {
+    return true;
+  }
+
+  return RtmpClientSession::OnAmfError(transactionId);
+}
+
+//====================================================================================================
+// Amf - onStatus
+//====================================================================================================
+bool RestreamStream::OnAmfStatus(const std::string &level, const std::string &code) {
+  if (level == "error") {
+    return false;
+  }
+
+  if (code == "NetStream.Publish.Start" && !_isPublish) {
+    _isPublish = true;
+
+    auto event = _event.lock();
+    return event && event->OnStreamPublish();
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Send media info(metadata + sequence headers)
+//====================================================================================================
+bool RestreamStream::SendMediaInfo(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
+  if (mediaInfo->metaData != nullptr) {
+    auto body = BufferPool::Alloc(mediaInfo->metaData->GetEncodeSize());
+    body->resize(mediaInfo->metaData->Encode(body->data()));
+    if (!body->empty() && !SendMediaMsg(Rtmp::MsgType::Amf0DataMsg, body)) {
+      return false;
+    }
+  }
+
+  if (mediaInfo->audioSeqHeader != nullptr && !SendMediaMsg(Rtmp::MsgType::AudioMsg, mediaInfo->audioSeqHeader)) {
+    return false;
+  }
+
+  if (mediaInfo->videoSeqHeader != nullptr && !SendMediaMsg(Rtmp::MsgType::VideoMsg, mediaInfo->videoSeqHeader)) {
+    return false;
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Send frame
+//  - chunk data is made once per chunk size/stream id and shared by the destinations
+//====================================================================================================
+bool RestreamStream::SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (!_isPublish) {
+    return true;
+  }
+
+  auto chunkData = frame->GetChunkData(ChunkSize, _streamId);
+  if (chunkData == nullptr) {
+    return false;
+  }
+
+  return SendData(chunkData);
+}
+
+//====================================================================================================
+// Send media message(Type_0, same chunk stream as the frames)
+//====================================================================================================
+bool RestreamStream::SendMediaMsg(Rtmp::MsgType type, const std::shared_ptr<std::vector<uint8_t>> &data) {
+  RtmpMuxMsgHeader header(static_cast<int>(Rtmp::ChunkStreamType::Stream), 0, static_cast<int>(type), _streamId,
+                          data->size());
+
+  auto exportData = RtmpExportChunk::ExportMsgData(ChunkSize, header, data);
+  if (exportData == nullptr) {
+    return false;
+  }
+
+  return SendData(exportData);
+}
+
+//====================================================================================================
+// Send amf stream command(releaseStream, FCPublish)
+//====================================================================================================
+bool RestreamStream::SendAmfStreamCmd(const std::string &cmd, double transactionId) {
+  auto doc = std::make_shared<AmfDoc>();
+  doc->AddProp(cmd);
+  doc->AddProp(transactionId);
+  doc->AddProp(AmfDataType::Null);
+  doc->AddProp(_streamKey.c_str());
+
+  return SendAmfCmd(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Control), 0,
+                                                       static_cast<int>(Rtmp::MsgType::Amf0CmdMsg), 0, 0),
+                    doc);
+}
+
+//====================================================================================================
+// Send amf publish
+//====================================================================================================
+bool RestreamStream::SendAmfPublish() {
+  auto doc = std::make_shared<AmfDoc>();
+  doc->AddProp(Rtmp::Cmd::Publish);
+  doc->AddProp(PublishTransactionId);
+  doc->AddProp(AmfDataType::Null);
+  doc->AddProp(_streamKey.c_str());
+  doc->AddProp("live");
+
+  return SendAmfCmd(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Media), 0,
+                                                       static_cast<int>(Rtmp::MsgType::Amf0CmdMsg), _streamId, 0),
+                    doc);
+}
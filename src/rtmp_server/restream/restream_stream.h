@@ -0,0 +1,53 @@
+#pragma once
+#include "common/common_header.h"
+#include "media/rtmp/rtmp_export_frame.h"
+#include "media/rtmp/rtmp_media_parser.h"
+#include "rtmp_server/stream/rtmp_client_session.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class RestreamStreamEvent : public RtmpClientSessionEvent {
+public:
+  virtual ~RestreamStreamEvent() = default;
+
+  virtual bool OnStreamPublish() = 0; // NetStream.Publish.Start
+};
+
+//====================================================================================================
+// Restream Stream(rtmp publish client)
+// -> C0 C1                             <- S0 S1 S2       -> C2
+// -> SetChunkSize, connect             <- _result
+// -> releaseStream, FCPublish, createStream <- _result(stream id)
+// -> publish(key, live)                <- onStatus(NetStream.Publish.Start)
+// -> metadata, sequence headers, frames(shared chunk data)
+//====================================================================================================
+class RestreamStream : public RtmpClientSession {
+public:
+  RestreamStream(const std::shared_ptr<RestreamStreamEvent> &event, const std::string &tcUrl, const std::string &app,
+                 const std::string &key);
+  virtual ~RestreamStream() = default;
+
+  bool IsPublish() const { return _isPublish; }
+
+  bool SendMediaInfo(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo); // metadata + sequence headers
+  bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame);
+
+  static constexpr int ChunkSize = 4096; // same for every destination, frame chunk data is shared
+
+protected:
+  bool OnHandshakeComplete() override;
+  bool OnAmfResult(const std::shared_ptr<AmfDoc> &doc, double transactionId) override;
+  bool OnAmfError(double transactionId) override;
+  bool OnAmfStatus(const std::string &level, const std::string &code) override;
+
+  bool SendMediaMsg(Rtmp::MsgType type, const std::shared_ptr<std::vector<uint8_t>> &data);
+
+  bool SendAmfStreamCmd(const std::string &cmd, double transactionId); // releaseStream, FCPublish
+  bool SendAmfPublish();
+
+private:
+  bool _isPublish = false;
+
+  std::weak_ptr<RestreamStreamEvent> _event;
+};
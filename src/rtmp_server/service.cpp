@@ -1,4 +1,5 @@
 ﻿#include "main_object.h"
+#include <algorithm>
 #include <condition_variable>
 #include <filesystem>
 #include <iomanip>
@@ -86,8 +87,59 @@ int main(int argc, char *argv[]) {
   param->hostIp = config->GetValue("HOST_IP", Network::TcpManager::GetLocalIP());
   param->studioPort = std::stoi(config->GetValue("STUDIO_PORT", "1935"));
   param->playerPort = std::stoi(config->GetValue("PLAYER_PORT", "7775"));
+  param->flvPort = std::stoi(config->GetValue("FLV_PORT", "0")); // 0 : http-flv disabled
+  param->hlsPort = std::stoi(config->GetValue("HLS_PORT", "0")); // 0 : hls(service + packagers) disabled
   param->controllerHost = config->GetValue("CONTROLLER_HOST", "localhost");
   param->controllerPort = std::stoi(config->GetValue("CONTROLLER_PORT", "7777"));
+  param->gopCacheDuration = std::stoul(config->GetValue("GOP_CACHE_DURATION", "10000"));
+  param->gopCacheSize = std::stoull(config->GetValue("GOP_CACHE_SIZE", "33554432"));
+  param->gopBurstRate = std::stoul(config->GetValue("GOP_BURST_RATE", "0"));
+  param->playerSendPolicy.maxBufferSize = std::stoull(config->GetValue("PLAYER_MAX_SEND_BUFFER", "8388608"));
+  param->playerSendPolicy.maxDelay = std::stoul(config->GetValue("PLAYER_MAX_SEND_DELAY", "5000"));
+  param->playerSendPolicy.isAudioDrop = config->GetValue("PLAYER_AUDIO_DROP", "false") == "true";
+  param->playerAggregateTime = std::stoul(config->GetValue("PLAYER_AGGREGATE_TIME", "0"));
+  param->hls.segmentDuration = std::stoul(config->GetValue("HLS_SEGMENT_DURATION", "2000"));
+  param->hls.segmentCount = std::stoul(config->GetValue("HLS_SEGMENT_COUNT", "6"));
+  param->hls.maxCacheSize = std::stoull(config->GetValue("HLS_CACHE_SIZE", "67108864"));
+  param->hls.partDuration = std::stoul(config->GetValue("HLS_PART_DURATION", "500"));
+  param->recordPath = config->GetValue("RECORD_PATH", "");
+  param->vodPath = config->GetValue("VOD_PATH", param->recordPath);
+  param->edgeOriginHost = config->GetValue("EDGE_ORIGIN_HOST", "");
+  param->edgeOriginPort = std::stoi(config->GetValue("EDGE_ORIGIN_PORT", "1935"));
+  param->edgeIdleTime = std::stoul(config->GetValue("EDGE_IDLE_TIME", "30000"));
+  param->restreamSendPolicy.maxBufferSize = std::stoull(config->GetValue("RESTREAM_MAX_SEND_BUFFER", "16777216"));
+  param->restreamSendPolicy.maxDelay = std::stoul(config->GetValue("RESTREAM_MAX_SEND_DELAY", "10000"));
+  param->restreamSendPolicy.isAudioDrop = true; // destination keeps a/v in sync
+
+  // NETWORK_CPU_SET=2-7 : services default to the other cpus(no network cpu set : no pin)
+  param->networkCpuSet = ParseCpuSet(config->GetValue("NETWORK_CPU_SET", ""));
+  param->serviceCpuSet = ParseCpuSet(config->GetValue("SERVICE_CPU_SET", ""));
+  param->networkBusyPoll = std::stoul(config->GetValue("NETWORK_BUSY_POLL", "0"));
+  param->networkReusePort = config->GetValue("NETWORK_REUSE_PORT", "false") == "true";
+
+  if (param->networkCpuSet.empty()) {
+    param->serviceCpuSet.clear();
+  } else if (param->serviceCpuSet.empty()) {
+    for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); ++cpu) {
+      if (!std::binary_search(param->networkCpuSet.begin(), param->networkCpuSet.end(), cpu)) {
+        param->serviceCpuSet.push_back(cpu);
+      }
+    }
+  }
+
+  // threads made from here(timer, record, controller, monitor) inherit the service cpus
+  if (!param->serviceCpuSet.empty() && !SetCurrentThreadCpuSet(param->serviceCpuSet)) {
+    LOG_WARN("Service cpu set fail - cpu(%s)", Config::CpuSetToString(param->serviceCpuSet).c_str());
+  }
+
+  // RESTREAM_URLS=app=rtmp://a/app/key rtmp://b/app/key;app2=rtmp://c/app/key
+  auto restreamItems = StringHelper::Tokenize(config->GetValue("RESTREAM_URLS", ""), ";");
+  for (const auto &item : *restreamItems) {
+    if (const auto pos = item.find('='); pos != std::string::npos) {
+      auto urls = StringHelper::Tokenize(item.substr(pos + 1), " ");
+      param->restreamUrls[StringHelper::Trim(item.substr(0, pos), " ")].assign(urls->begin(), urls->end());
+    }
+  }
 
   // Config 정보 출력
   std::cout << "[ Configuration Settings ]" << std::endl;
@@ -0,0 +1,49 @@
+#include "gop_cache.h"
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+GopCache::GopCache(uint32_t maxDuration, uint64_t maxSize) : _maxDuration(maxDuration), _maxSize(maxSize) {}
+
+//====================================================================================================
+// Push
+//====================================================================================================
+void GopCache::Push(const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (!IsEnable()) {
+    return;
+  }
+
+  if (frame->IsKeyFrame()) {
+    Clear();
+  } else if (_frames.empty()) {
+    // wait key frame
+    return;
+  }
+
+  _frames.push_back(frame);
+  _size += frame->GetSize();
+
+  auto firstTimestamp = _frames.front()->GetTimestamp();
+  auto duration = frame->GetTimestamp() > firstTimestamp ? frame->GetTimestamp() - firstTimestamp : 0;
+
+  if ((_maxSize != 0 && _size > _maxSize) || (_maxDuration != 0 && duration > _maxDuration)) {
+    LOG_WARN("Gop cache over - count(%zu) size(%" PRIu64 ":%" PRIu64 ") duration(%" PRIu64 ":%u)", _frames.size(),
+             _size, _maxSize, duration, _maxDuration);
+    Clear();
+  }
+}
+
+//====================================================================================================
+// Clear
+//====================================================================================================
+void GopCache::Clear() {
+  _frames.clear();
+  _size = 0;
+}
+
+//====================================================================================================
+// GetFrames
+//====================================================================================================
+std::vector<std::shared_ptr<RtmpExportFrame>> GopCache::GetFrames() const {
+  return std::vector<std::shared_ptr<RtmpExportFrame>>(_frames.begin(), _frames.end());
+}
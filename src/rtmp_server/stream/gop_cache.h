@@ -0,0 +1,31 @@
+#pragma once
+#include "media/rtmp/rtmp_export_frame.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+//====================================================================================================
+// GopCache
+//  - frames from the last key frame(audio included) for new players
+//  - over the duration/size limit the cache is cleared and waits for the next key frame
+//  - not thread safe(owner lock)
+//====================================================================================================
+class GopCache {
+public:
+  GopCache(uint32_t maxDuration, uint64_t maxSize);
+  ~GopCache() = default;
+
+  void Push(const std::shared_ptr<RtmpExportFrame> &frame);
+  void Clear();
+  std::vector<std::shared_ptr<RtmpExportFrame>> GetFrames() const;
+  bool IsEnable() const { return _maxDuration != 0 || _maxSize != 0; }
+  size_t GetCount() const { return _frames.size(); }
+  uint64_t GetSize() const { return _size; }
+
+private:
+  uint32_t _maxDuration; // ms(0: no limit)
+  uint64_t _maxSize;     // byte(0: no limit)
+
+  std::deque<std::shared_ptr<RtmpExportFrame>> _frames;
+  uint64_t _size = 0;
+};
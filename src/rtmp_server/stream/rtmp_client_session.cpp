@@ -0,0 +1,434 @@
+#include "rtmp_client_session.h"
+#include "stream_ingest.h"
+#include <utility>
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+RtmpClientSession::RtmpClientSession(const std::shared_ptr<RtmpClientSessionEvent> &event, const char *logName,
+                                     const std::string &tcUrl, const std::string &streamApp,
+                                     const std::string &streamKey)
+    : _logName(logName), _tcUrl(tcUrl), _streamApp(streamApp), _streamKey(streamKey),
+      _streamPath(streamApp + "/" + streamKey), _sessionEvent(event) {}
+
+//====================================================================================================
+// Start(C0 + C1)
+//====================================================================================================
+bool RtmpClientSession::Start() {
+  if (!SendData(RtmpHandshake::MakeC0_C1())) {
+    LOG_ERROR("%s - handshake c0+c1 send fail - stream(%s)", _logName, _streamPath.c_str());
+    return false;
+  }
+
+  _handshakeState = Rtmp::HandshakeState::C1;
+  return true;
+}
+
+//====================================================================================================
+// Recv handler
+//====================================================================================================
+int RtmpClientSession::RecvHandler(std::span<const uint8_t> data) {
+  if (data.size() > Rtmp::MaxPacketSize) {
+    LOG_ERROR("%s - recv data size fail - stream(%s) size(%zu)", _logName, _streamPath.c_str(), data.size());
+    return -1;
+  }
+
+  int procSize = (_handshakeState != Rtmp::HandshakeState::Complete) ? RecvHandshake(data) : RecvChunk(data);
+
+  if (procSize < 0) {
+    LOG_ERROR("%s - process size fail - stream(%s) size(%d)", _logName, _streamPath.c_str(), procSize);
+    return -1;
+  }
+
+  return procSize;
+}
+
+//====================================================================================================
+// Handshake(S0 + S1 + S2)
+//  - S2 check none, C2 = S1
+//====================================================================================================
+int32_t RtmpClientSession::RecvHandshake(std::span<const uint8_t> data) {
+  if (_handshakeState != Rtmp::HandshakeState::C1) {
+    LOG_ERROR("%s - handshake state fail - stream(%s) state(%d)", _logName, _streamPath.c_str(),
+              static_cast<int32_t>(_handshakeState));
+    return -1;
+  }
+
+  constexpr int procSize = 1 + Rtmp::HandshakePacketSize * 2; // s0 + s1 + s2
+  if (static_cast<int>(data.size()) < procSize) {
+    return 0;
+  }
+
+  if (data[0] != Rtmp::HandshakeVersion) {
+    LOG_ERROR("%s - handshake version fail - stream(%s) version(%d:%d)", _logName, _streamPath.c_str(), data[0],
+              Rtmp::HandshakeVersion);
+    return -1;
+  }
+
+  if (!SendData(RtmpHandshake::MakeC2(data.data() + 1))) {
+    LOG_ERROR("%s - handshake c2 send fail - stream(%s)", _logName, _streamPath.c_str());
+    return -1;
+  }
+
+  _handshakeState = Rtmp::HandshakeState::Complete;
+
+  if (!OnHandshakeComplete()) {
+    LOG_ERROR("%s - send amf connect fail - stream(%s)", _logName, _streamPath.c_str());
+    return -1;
+  }
+
+  return procSize;
+}
+
+//====================================================================================================
+// Recv chunk
+//====================================================================================================
+int32_t RtmpClientSession::RecvChunk(std::span<const uint8_t> data) {
+  int procSize = 0;
+
+  while (procSize < static_cast<int>(data.size())) {
+    auto [size, isComplete] = _importChunk->ImportStreamData(data.data() + procSize, data.size() - procSize);
+
+    if (size == 0) {
+      break;
+    } else if (size < 0) {
+      LOG_ERROR("%s - importStream fail - stream(%s)", _logName, _streamPath.c_str());
+      return size;
+    }
+
+    if (isComplete && !ProcessChunkMsg()) {
+      LOG_ERROR("%s - chunk message fail - stream(%s)", _logName, _streamPath.c_str());
+      return -1;
+    }
+
+    procSize += size;
+  }
+
+  // Acknowledgement append
+  _ackTraffic += procSize;
+
+  if (_ackTraffic > _ackSize) {
+    SendAckSize();
+    _ackTraffic = 0;
+  }
+
+  return procSize;
+}
+
+//====================================================================================================
+// Process chunk message
+//====================================================================================================
+bool RtmpClientSession::ProcessChunkMsg() {
+  while (true) {
+    auto msg = _importChunk->GetMessage();
+
+    if (!msg || !msg->body) {
+      break;
+    }
+
+    if (msg->header->bodySize > Rtmp::MaxPacketSize) {
+      LOG_ERROR("%s - packet size fail - stream(%s) size(%u:%u)", _logName, _streamPath.c_str(),
+                msg->header->bodySize, Rtmp::MaxPacketSize);
+      return false;
+    }
+
+    bool result = true;
+    auto type = msg->header->typeId;
+
+    if (StreamIngest::IsMediaMsg(type)) {
+      result = OnMediaMsg(msg);
+    } else if (type == static_cast<int>(Rtmp::MsgType::SetChunkSize)) {
+      result = OnSetChunkSize(msg);
+    } else if (type == static_cast<int>(Rtmp::MsgType::Amf0CmdMsg)) {
+      result = OnAmfCmdMsg(msg);
+    } else if (type == static_cast<int>(Rtmp::MsgType::WindowAckSize)) {
+      OnWindowAckSize(msg);
+    } else if (type == static_cast<int>(Rtmp::MsgType::UserControlMsg)) {
+      result = OnUserControlMsg(msg);
+    } else if (type != static_cast<int>(Rtmp::MsgType::SetPeerBandWidth) &&
+               type != static_cast<int>(Rtmp::MsgType::Ack)) {
+      LOG_WARN("%s - unknown type - stream(%s) type(%d)", _logName, _streamPath.c_str(), type);
+    }
+
+    if (!result) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Chunk Message - media(audio, video, aggregate, amf0 data)
+//  - a publish session receives control/command messages only
+//====================================================================================================
+bool RtmpClientSession::OnMediaMsg(const std::shared_ptr<ImportMsg> &msg) {
+  LOG_WARN("%s - unexpected media message - stream(%s) type(%d)", _logName, _streamPath.c_str(),
+           msg->header->typeId);
+  return true;
+}
+
+//====================================================================================================
+// Chunk Message - SetChunkSize
+//====================================================================================================
+bool RtmpClientSession::OnSetChunkSize(const std::shared_ptr<ImportMsg> &msg) {
+  if (msg->body->size() < 4) {
+    return false;
+  }
+
+  auto chunkSize = RtmpMuxUtil::ReadInt32(msg->body->data());
+  if (chunkSize <= 0) {
+    LOG_ERROR("%s - chunkSize fail - stream(%s)", _logName, _streamPath.c_str());
+    return false;
+  }
+
+  _importChunk->SetChunkSize(chunkSize);
+  return true;
+}
+
+//====================================================================================================
+// Chunk Message - WindowAckSize
+//====================================================================================================
+void RtmpClientSession::OnWindowAckSize(const std::shared_ptr<ImportMsg> &msg) {
+  if (msg->body->size() < 4) {
+    return;
+  }
+
+  if (auto ackSize = RtmpMuxUtil::ReadInt32(msg->body->data()); ackSize != 0) {
+    _ackSize = ackSize / 2;
+    _ackTraffic = 0;
+  }
+}
+
+//====================================================================================================
+// Chunk Message - UserControl
+//====================================================================================================
+bool RtmpClientSession::OnUserControlMsg(const std::shared_ptr<ImportMsg> &msg) {
+  if (msg->body->size() < 2) {
+    return true;
+  }
+
+  const auto type = RtmpMuxUtil::ReadInt16(msg->body->data());
+  if (type == static_cast<int>(Rtmp::UserControlMsgType::PingRequest) && msg->body->size() >= 6) {
+    return SendPingResponse(RtmpMuxUtil::ReadInt32(msg->body->data() + 2));
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Chunk Message - Amf0 command
+//====================================================================================================
+bool RtmpClientSession::OnAmfCmdMsg(const std::shared_ptr<ImportMsg> &msg) {
+  auto doc = std::make_shared<AmfDoc>();
+  if (doc->Decode(msg->body) == 0) {
+    LOG_WARN("%s - amf doc size 0 - stream(%s)", _logName, _streamPath.c_str());
+    return true;
+  }
+
+  std::string cmd;
+  if (doc->GetProp(0) != nullptr && doc->GetProp(0)->GetType() == AmfDataType::String) {
+    cmd = doc->GetProp(0)->GetString();
+  }
+
+  double transactionId = 0.0;
+  if (doc->GetProp(1) != nullptr && doc->GetProp(1)->GetType() == AmfDataType::Number) {
+    transactionId = doc->GetProp(1)->GetNumber();
+  }
+
+  if (cmd == Rtmp::Cmd::Result) {
+    return OnAmfResult(doc, transactionId);
+  } else if (cmd == Rtmp::Cmd::Error) {
+    return OnAmfError(transactionId);
+  } else if (cmd == Rtmp::Cmd::OnStatus) {
+    return OnAmfOnStatus(doc);
+  }
+
+  // onBWDone, onFCPublish, close ...
+  LOG_DEBUG("%s - amf0 cmd message - stream(%s) message(%s:%.1f)", _logName, _streamPath.c_str(), cmd.c_str(),
+            transactionId);
+  return true;
+}
+
+//====================================================================================================
+// Amf - _error
+//====================================================================================================
+bool RtmpClientSession::OnAmfError(double transactionId) {
+  LOG_ERROR("%s - amf error - stream(%s) transaction(%.1f)", _logName, _streamPath.c_str(), transactionId);
+  return false;
+}
+
+//====================================================================================================
+// Amf - onStatus(level, code)
+//====================================================================================================
+bool RtmpClientSession::OnAmfOnStatus(const std::shared_ptr<AmfDoc> &doc) {
+  if (doc->GetProp(3) == nullptr || doc->GetProp(3)->GetType() != AmfDataType::Object) {
+    return true;
+  }
+
+  auto object = doc->GetProp(3)->GetObject();
+  std::string level;
+  std::string code;
+  int32_t index;
+
+  if ((index = object->FindName("level")) >= 0 && object->GetType(index) == AmfDataType::String) {
+    level = object->GetString(index);
+  }
+
+  if ((index = object->FindName("code")) >= 0 && object->GetType(index) == AmfDataType::String) {
+    code = object->GetString(index);
+  }
+
+  LOG_INFO("%s - on status - stream(%s) level(%s) code(%s)", _logName, _streamPath.c_str(), level.c_str(),
+           code.c_str());
+
+  return OnAmfStatus(level, code);
+}
+
+//====================================================================================================
+// Amf - createStream _result(stream id)
+//====================================================================================================
+bool RtmpClientSession::OnAmfCreateStreamResult(const std::shared_ptr<AmfDoc> &doc) {
+  if (doc->GetProp(3) == nullptr || doc->GetProp(3)->GetType() != AmfDataType::Number) {
+    LOG_ERROR("%s - create stream result fail - stream(%s)", _logName, _streamPath.c_str());
+    return false;
+  }
+
+  _streamId = static_cast<uint32_t>(doc->GetProp(3)->GetNumber());
+  return true;
+}
+
+//====================================================================================================
+// Send data
+//====================================================================================================
+bool RtmpClientSession::SendData(const std::shared_ptr<std::vector<uint8_t>> &data) {
+  auto event = _sessionEvent.lock();
+  if (!event) {
+    return false;
+  }
+
+  return event->StreamSendData(data);
+}
+
+//====================================================================================================
+// Send message
+//====================================================================================================
+bool RtmpClientSession::SendMsg(const std::shared_ptr<RtmpMuxMsgHeader> &header,
+                                const std::shared_ptr<std::vector<uint8_t>> &data) {
+  auto exportData = _exportChunk->ExportStreamData(*header, data);
+  if (!exportData || exportData->empty()) {
+    return false;
+  }
+
+  return SendData(exportData);
+}
+
+//====================================================================================================
+// Send amf command
+//====================================================================================================
+bool RtmpClientSession::SendAmfCmd(const std::shared_ptr<RtmpMuxMsgHeader> &header,
+                                   const std::shared_ptr<AmfDoc> &doc) {
+  auto body = BufferPool::Alloc(doc->GetEncodeSize());
+
+  uint32_t bodySize = static_cast<uint32_t>(doc->Encode(body->data()));
+  if (bodySize == 0) {
+    return false;
+  }
+
+  header->bodySize = bodySize;
+  body->resize(bodySize);
+
+  return SendMsg(header, body);
+}
+
+//====================================================================================================
+// Send user control message
+//====================================================================================================
+bool RtmpClientSession::SendUserControlMsg(uint16_t msg, const std::shared_ptr<std::vector<uint8_t>> &data) {
+  data->insert(data->begin(), 2, 0);
+  RtmpMuxUtil::WriteInt16(data->data(), msg);
+
+  return SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Urgent), 0,
+                                                    static_cast<int>(Rtmp::MsgType::UserControlMsg), 0, data->size()),
+                 data);
+}
+
+//====================================================================================================
+// Send set chunk size
+//====================================================================================================
+bool RtmpClientSession::SendSetChunkSize(uint32_t chunkSize) {
+  auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+  RtmpMuxUtil::WriteInt32(body->data(), chunkSize);
+
+  if (!SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Urgent), 0,
+                                                  static_cast<int>(Rtmp::MsgType::SetChunkSize), 0, body->size()),
+               body)) {
+    return false;
+  }
+
+  _exportChunk->SetChunkSize(chunkSize);
+  return true;
+}
+
+//====================================================================================================
+// Send window acknowledgement size
+//====================================================================================================
+bool RtmpClientSession::SendWindowAckSize() {
+  auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+  RtmpMuxUtil::WriteInt32(body->data(), Rtmp::DefaultAckSize);
+
+  return SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Urgent), 0,
+                                                    static_cast<int>(Rtmp::MsgType::WindowAckSize), 0, body->size()),
+                 body);
+}
+
+//====================================================================================================
+// Send acknowledgement
+//====================================================================================================
+bool RtmpClientSession::SendAckSize() {
+  auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+  RtmpMuxUtil::WriteInt32(body->data(), _ackTraffic);
+
+  return SendMsg(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Urgent), 0,
+                                                    static_cast<int>(Rtmp::MsgType::Ack), 0, body->size()),
+                 body);
+}
+
+//====================================================================================================
+// Send ping response
+//====================================================================================================
+bool RtmpClientSession::SendPingResponse(uint32_t timestamp) {
+  auto body = std::make_shared<std::vector<uint8_t>>(4);
+  RtmpMuxUtil::WriteInt32(body->data(), timestamp);
+
+  return SendUserControlMsg(static_cast<uint16_t>(Rtmp::UserControlMsgType::PingResponse), body);
+}
+
+//====================================================================================================
+// Send amf connect
+//  - object : command object(app, tcUrl, client properties)
+//====================================================================================================
+bool RtmpClientSession::SendAmfConnect(const std::shared_ptr<AmfObject> &object, double transactionId) {
+  auto doc = std::make_shared<AmfDoc>();
+  doc->AddProp(Rtmp::Cmd::Connect);
+  doc->AddProp(transactionId);
+  doc->AddProp(object);
+
+  return SendAmfCmd(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Control), 0,
+                                                       static_cast<int>(Rtmp::MsgType::Amf0CmdMsg), 0, 0),
+                    doc);
+}
+
+//====================================================================================================
+// Send amf createStream
+//====================================================================================================
+bool RtmpClientSession::SendAmfCreateStream(double transactionId) {
+  auto doc = std::make_shared<AmfDoc>();
+  doc->AddProp(Rtmp::Cmd::CreateStream);
+  doc->AddProp(transactionId);
+  doc->AddProp(AmfDataType::Null);
+
+  return SendAmfCmd(std::make_shared<RtmpMuxMsgHeader>(static_cast<int>(Rtmp::ChunkStreamType::Control), 0,
+                                                       static_cast<int>(Rtmp::MsgType::Amf0CmdMsg), 0, 0),
+                    doc);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "common/common_header.h"
+#include "media/rtmp/amf_document.h"
+#include "media/rtmp/rtmp_export_chunk.h"
+#include "media/rtmp/rtmp_handshake.h"
+#include "media/rtmp/rtmp_import_chunk.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+class RtmpClientSessionEvent {
+public:
+  virtual ~RtmpClientSessionEvent() = default;
+
+  virtual bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data) = 0;
+};
+
+//====================================================================================================
+// Rtmp Client Session(outgoing connection to another rtmp server)
+//  - handshake(C0 C1 -> S0 S1 S2 -> C2), control messages, acknowledgement, amf command send
+//  - derived session(edge play, restream publish) drives the command sequence from _result/onStatus
+//====================================================================================================
+class RtmpClientSession {
+public:
+  RtmpClientSession(const std::shared_ptr<RtmpClientSessionEvent> &event, const char *logName,
+                    const std::string &tcUrl, const std::string &streamApp, const std::string &streamKey);
+  virtual ~RtmpClientSession() = default;
+
+  bool Start(); // C0 + C1
+  int RecvHandler(std::span<const uint8_t> data);
+  const std::string &GetStreamPath() { return _streamPath; }
+
+protected:
+  virtual bool OnHandshakeComplete() = 0; // first commands(connect)
+  virtual bool OnMediaMsg(const std::shared_ptr<ImportMsg> &msg);
+  virtual bool OnAmfResult(const std::shared_ptr<AmfDoc> &doc, double transactionId) = 0;
+  virtual bool OnAmfError(double transactionId);
+  virtual bool OnAmfStatus(const std::string &level, const std::string &code) = 0;
+
+  int32_t RecvHandshake(std::span<const uint8_t> data);
+  int32_t RecvChunk(std::span<const uint8_t> data);
+
+  bool ProcessChunkMsg();
+  bool OnSetChunkSize(const std::shared_ptr<ImportMsg> &msg);
+  void OnWindowAckSize(const std::shared_ptr<ImportMsg> &msg);
+  bool OnUserControlMsg(const std::shared_ptr<ImportMsg> &msg);
+  bool OnAmfCmdMsg(const std::shared_ptr<ImportMsg> &msg);
+  bool OnAmfOnStatus(const std::shared_ptr<AmfDoc> &doc);
+  bool OnAmfCreateStreamResult(const std::shared_ptr<AmfDoc> &doc); // stream id
+
+  bool SendData(const std::shared_ptr<std::vector<uint8_t>> &data);
+  bool SendMsg(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<std::vector<uint8_t>> &data);
+  bool SendAmfCmd(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc);
+  bool SendUserControlMsg(uint16_t msg, const std::shared_ptr<std::vector<uint8_t>> &data);
+  bool SendSetChunkSize(uint32_t chunkSize);
+  bool SendWindowAckSize();
+  bool SendAckSize();
+  bool SendPingResponse(uint32_t timestamp);
+
+  bool SendAmfConnect(const std::shared_ptr<AmfObject> &object, double transactionId);
+  bool SendAmfCreateStream(double transactionId);
+
+protected:
+  const char *_logName;
+  std::string _tcUrl;
+  std::string _streamApp;
+  std::string _streamKey;
+  std::string _streamPath; // app/key
+
+  Rtmp::HandshakeState _handshakeState = Rtmp::HandshakeState::Ready;
+  std::unique_ptr<RtmpImportChunk> _importChunk = std::make_unique<RtmpImportChunk>(Rtmp::DefaultChunkSize);
+  std::unique_ptr<RtmpExportChunk> _exportChunk = std::make_unique<RtmpExportChunk>(false, Rtmp::DefaultChunkSize);
+
+  uint32_t _streamId = 0;
+  uint32_t _ackSize = Rtmp::DefaultAckSize / 2;
+  uint32_t _ackTraffic = 0;
+
+private:
+  std::weak_ptr<RtmpClientSessionEvent> _sessionEvent;
+};
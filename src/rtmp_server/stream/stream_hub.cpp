@@ -0,0 +1,156 @@
+#include "stream_hub.h"
+#include <algorithm>
+
+//====================================================================================================
+// Player send drop - send over check
+//====================================================================================================
+bool PlayerSendDrop::IsSendOver(Network::TcpObject &object) const {
+  if (_policy.maxBufferSize != 0 && object.GetSendBufferSize() > _policy.maxBufferSize) {
+    return true;
+  }
+
+  if (_policy.maxDelay != 0 && object.GetSendQueueDelay() > _policy.maxDelay) {
+    return true;
+  }
+
+  return false;
+}
+
+//====================================================================================================
+// Player send drop - send policy check
+//  - return false : frame drop
+//====================================================================================================
+bool PlayerSendDrop::Check(Network::TcpObject &object, const std::shared_ptr<RtmpExportFrame> &frame) {
+  if (!_isDropping) {
+    if (!IsSendOver(object)) {
+      return true;
+    }
+
+    _isDropping = true;
+    _dropStart++;
+    LOG_WARN("%s send over, drop start - buffer(%" PRIu64 ") delay(%" PRIu64 ")", _logName.c_str(),
+             object.GetSendBufferSize(), object.GetSendQueueDelay());
+  }
+
+  // resume at a key frame under the limit
+  if (frame->IsKeyFrame() && !IsSendOver(object)) {
+    _isDropping = false;
+    LOG_INFO("%s drop end - drop(video:%" PRIu64 " audio:%" PRIu64 ")", _logName.c_str(), _dropVideoCount.load(),
+             _dropAudioCount.load());
+    return true;
+  }
+
+  if (!frame->IsVideo() && !_policy.isAudioDrop) {
+    return true;
+  }
+
+  if (frame->IsVideo()) {
+    _dropVideoCount++;
+  } else {
+    _dropAudioCount++;
+  }
+  _dropSize += frame->GetSize();
+  return false;
+}
+
+//====================================================================================================
+// Player send drop - drop info
+//====================================================================================================
+PlayerDropInfo PlayerSendDrop::GetDropInfo(const std::string &streamPath, const std::string &remoteIp) const {
+  return {streamPath, remoteIp, _dropVideoCount.load(), _dropAudioCount.load(), _dropSize.load(), _dropStart.load()};
+}
+
+//====================================================================================================
+// Constructor
+//====================================================================================================
+StreamHub::StreamHub(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo,
+                     uint32_t gopCacheDuration, uint64_t gopCacheSize)
+    : _streamPath(streamPath), _mediaInfo(mediaInfo), _gopCache(gopCacheDuration, gopCacheSize),
+      _subscribers(std::make_shared<const Subscribers>()) {}
+
+//====================================================================================================
+// Get subscriber count
+//====================================================================================================
+size_t StreamHub::GetSubscriberCount() const {
+  size_t count = 0;
+  auto subscribers = _subscribers.load(); // keep the snapshot alive(range-for does not extend the temporary)
+  for (const auto &group : *subscribers) {
+    count += group.subscribers.size();
+  }
+  return count;
+}
+
+//====================================================================================================
+// Add subscriber
+//  - subscriber add + gop copy in one lock block(no frame lost/duplicated between gop and live)
+//====================================================================================================
+std::vector<std::shared_ptr<RtmpExportFrame>>
+StreamHub::AddSubscriber(uint64_t key, const std::shared_ptr<StreamSubscriber> &subscriber) {
+  std::lock_guard<std::mutex> lock(_writeLock);
+
+  auto ioContext = &subscriber->GetSubscriberContext();
+  auto subscribers = std::make_shared<Subscribers>(*_subscribers.load());
+
+  auto group = std::find_if(subscribers->begin(), subscribers->end(),
+                            [ioContext](const ContextGroup &item) { return item.ioContext == ioContext; });
+  if (group == subscribers->end()) {
+    group = subscribers->insert(subscribers->end(), {ioContext, {}});
+  }
+  group->subscribers.push_back({key, subscriber});
+
+  _subscribers.store(std::move(subscribers));
+
+  return _gopCache.GetFrames();
+}
+
+//====================================================================================================
+// Remove subscriber
+//====================================================================================================
+void StreamHub::RemoveSubscriber(uint64_t key) {
+  std::lock_guard<std::mutex> lock(_writeLock);
+
+  auto subscribers = std::make_shared<Subscribers>();
+  auto current = _subscribers.load();
+  for (const auto &group : *current) {
+    ContextGroup newGroup{group.ioContext, {}};
+    for (const auto &subscriber : group.subscribers) {
+      if (subscriber.key != key && !subscriber.subscriber.expired()) {
+        newGroup.subscribers.push_back(subscriber);
+      }
+    }
+
+    if (!newGroup.subscribers.empty()) {
+      subscribers->push_back(std::move(newGroup));
+    }
+  }
+  _subscribers.store(std::move(subscribers));
+}
+
+//====================================================================================================
+// Push frame
+//  - chunk 데이터는 frame 당 한번만 생성(RtmpExportFrame)
+//  - publisher thread posts one task per io_context, socket send stays on the owner thread
+//====================================================================================================
+void StreamHub::PushFrame(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) {
+  auto exportFrame = std::make_shared<RtmpExportFrame>(frame, isVideo);
+  std::shared_ptr<const Subscribers> subscribers;
+
+  if (_gopCache.IsEnable()) {
+    // gop push and snapshot must be atomic against AddSubscriber
+    std::lock_guard<std::mutex> lock(_writeLock);
+    _gopCache.Push(exportFrame);
+    subscribers = _subscribers.load();
+  } else {
+    subscribers = _subscribers.load();
+  }
+
+  for (size_t index = 0; index < subscribers->size(); ++index) {
+    boost::asio::post(*(*subscribers)[index].ioContext, [subscribers, index, exportFrame]() {
+      for (const auto &subscriber : (*subscribers)[index].subscribers) {
+        if (auto object = subscriber.subscriber.lock(); object != nullptr) {
+          object->SendFrame(exportFrame);
+        }
+      }
+    });
+  }
+}
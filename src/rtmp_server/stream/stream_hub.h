@@ -0,0 +1,108 @@
+#pragma once
+#include "gop_cache.h"
+#include "media/rtmp/rtmp_export_frame.h"
+#include "media/rtmp/rtmp_media_parser.h"
+#include "network/network_tcp_object.h"
+#include <atomic>
+#include <boost/asio.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//====================================================================================================
+// Player send policy(slow viewer, rtmp/http-flv/restream)
+//  - over a limit : drop video(audio optional) until the next key frame under the limit
+//====================================================================================================
+struct PlayerSendPolicy {
+  uint64_t maxBufferSize = 0; // byte(0: no limit)
+  uint32_t maxDelay = 0;      // ms, oldest unsent data wait time(0: no limit)
+  bool isAudioDrop = false;
+};
+
+struct PlayerDropInfo {
+  std::string streamPath;
+  std::string remoteIp;
+  uint64_t videoCount = 0;
+  uint64_t audioCount = 0;
+  uint64_t dropSize = 0;  // byte
+  uint32_t dropStart = 0; // drop start count
+};
+
+//====================================================================================================
+// Player send drop(PlayerSendPolicy state of one session)
+//  - Check/IsSendOver : session io_context thread only, counters are read by the info timer
+//====================================================================================================
+class PlayerSendDrop {
+public:
+  explicit PlayerSendDrop(const PlayerSendPolicy &policy) : _policy(policy) {}
+
+  void SetLogName(const std::string &logName) { _logName = logName; } // ex) Player index(1) stream(app/key)
+  bool IsSendOver(Network::TcpObject &object) const;
+  bool Check(Network::TcpObject &object, const std::shared_ptr<RtmpExportFrame> &frame); // false : frame drop
+  PlayerDropInfo GetDropInfo(const std::string &streamPath, const std::string &remoteIp) const;
+  uint64_t GetDropCount() const { return _dropVideoCount.load() + _dropAudioCount.load(); }
+
+private:
+  PlayerSendPolicy _policy;
+  std::string _logName;
+  bool _isDropping = false;
+  std::atomic<uint64_t> _dropVideoCount{0};
+  std::atomic<uint64_t> _dropAudioCount{0};
+  std::atomic<uint64_t> _dropSize{0};
+  std::atomic<uint32_t> _dropStart{0};
+};
+
+class StreamSubscriber {
+public:
+  virtual ~StreamSubscriber() = default;
+
+  virtual bool SendFrame(const std::shared_ptr<RtmpExportFrame> &frame) = 0;
+  virtual boost::asio::io_context &GetSubscriberContext() = 0; // SendFrame is called on this context
+};
+
+//====================================================================================================
+// StreamHub
+//  - one per published stream(media info + gop cache + subscribers)
+//  - publisher resolves the hub once at publish time, players subscribe at play start
+//  - frame delivery reads a copy-on-write subscriber snapshot(no global lock)
+//  - subscribers are grouped by io_context, one delivery task is posted per context
+//====================================================================================================
+class StreamHub {
+public:
+  StreamHub(const std::string &streamPath, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo,
+            uint32_t gopCacheDuration, uint64_t gopCacheSize);
+  ~StreamHub() = default;
+
+  const std::string &GetStreamPath() const { return _streamPath; }
+  const std::shared_ptr<Rtmp::MediaInfo> &GetMediaInfo() const { return _mediaInfo; }
+  size_t GetSubscriberCount() const;
+
+  // subscriber key : network object key + index key(index key is unique per service only)
+  static uint64_t MakeSubscriberKey(int objectKey, int indexKey) {
+    return (static_cast<uint64_t>(objectKey) << 32) | static_cast<uint32_t>(indexKey);
+  }
+
+  std::vector<std::shared_ptr<RtmpExportFrame>> AddSubscriber(uint64_t key,
+                                                              const std::shared_ptr<StreamSubscriber> &subscriber);
+  void RemoveSubscriber(uint64_t key);
+  void PushFrame(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo);
+
+private:
+  struct Subscriber {
+    uint64_t key;
+    std::weak_ptr<StreamSubscriber> subscriber;
+  };
+  struct ContextGroup {
+    boost::asio::io_context *ioContext;
+    std::vector<Subscriber> subscribers;
+  };
+  using Subscribers = std::vector<ContextGroup>;
+
+  std::string _streamPath;
+  std::shared_ptr<Rtmp::MediaInfo> _mediaInfo;
+
+  GopCache _gopCache; // _writeLock
+  std::atomic<std::shared_ptr<const Subscribers>> _subscribers;
+  std::mutex _writeLock; // subscriber change + gop push(stream local)
+};
@@ -0,0 +1,257 @@
+#include "stream_ingest.h"
+#include <vector>
+
+//====================================================================================================
+// Media message type(audio, video, aggregate, amf0 data)
+//====================================================================================================
+bool StreamIngest::IsMediaMsg(int type) {
+  return type == static_cast<int>(Rtmp::MsgType::AudioMsg) || type == static_cast<int>(Rtmp::MsgType::VideoMsg) ||
+         type == static_cast<int>(Rtmp::MsgType::AggregateMsg) ||
+         type == static_cast<int>(Rtmp::MsgType::Amf0DataMsg);
+}
+
+//====================================================================================================
+// Media message
+//====================================================================================================
+bool StreamIngest::OnMediaMsg(const std::shared_ptr<ImportMsg> &msg) {
+  auto type = msg->header->typeId;
+
+  if (type == static_cast<int>(Rtmp::MsgType::AudioMsg)) {
+    return OnAudioMsg(msg);
+  } else if (type == static_cast<int>(Rtmp::MsgType::VideoMsg)) {
+    return OnVideoMsg(msg);
+  } else if (type == static_cast<int>(Rtmp::MsgType::AggregateMsg)) {
+    return OnAggregateMsg(msg);
+  } else if (type == static_cast<int>(Rtmp::MsgType::Amf0DataMsg)) {
+    OnAmfDataMsg(msg);
+    return true;
+  }
+
+  LOG_WARN("%s - unknown media type - stream(%s) type(%d)", _logName, _streamPath.c_str(), type);
+  return true;
+}
+
+//====================================================================================================
+// Aggregate
+//  - audio/video/data sub messages are handled like single messages(nginx-rtmp, srs)
+//====================================================================================================
+bool StreamIngest::OnAggregateMsg(const std::shared_ptr<ImportMsg> &msg) {
+  std::vector<std::shared_ptr<ImportMsg>> msgs;
+  if (!RtmpImportChunk::SplitAggregateMsg(msg, msgs)) {
+    LOG_ERROR("%s - aggregate parse fail - stream(%s) size(%u)", _logName, _streamPath.c_str(),
+              msg->header->bodySize);
+    return false;
+  }
+
+  for (const auto &subMsg : msgs) {
+    if (subMsg->header->typeId == static_cast<int>(Rtmp::MsgType::AggregateMsg)) {
+      LOG_WARN("%s - nested aggregate - stream(%s)", _logName, _streamPath.c_str());
+      continue;
+    }
+
+    if (!OnMediaMsg(subMsg)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//====================================================================================================
+// Audio
+//====================================================================================================
+bool StreamIngest::OnAudioMsg(const std::shared_ptr<ImportMsg> &msg) {
+  auto header = msg->header;
+  _lastAudioTimestamp = header->timestamp;
+
+  if (header->bodySize < 2) {
+    LOG_ERROR("%s - audio size fail - stream(%s) size(%d)", _logName, _streamPath.c_str(), header->bodySize);
+    return false;
+  }
+
+  if (msg->body->at(1) == 0x00) {
+    if (_mediaInfo->audio) {
+      return true; // same stream, config resent
+    }
+
+    Rtmp::MediaParser parser;
+    auto config = parser.AacSeqParse(msg->body);
+    if (!config) {
+      LOG_ERROR("%s - audio config parse fail - stream(%s)", _logName, _streamPath.c_str());
+      return false;
+    }
+
+    _mediaInfo->audio = config;
+    _mediaInfo->audioSeqHeader = msg->body;
+    return CheckStreamReady();
+  }
+
+  if (!_isReady) {
+    return true;
+  }
+
+  return _event.OnIngestData(std::make_shared<Rtmp::Frame>(header->timestamp, msg->body), false);
+}
+
+//====================================================================================================
+// Video
+//  - h264, hevc(legacy 12 or enhanced hvc1), av1(enhanced av01) : passed to players unchanged
+//====================================================================================================
+bool StreamIngest::OnVideoMsg(const std::shared_ptr<ImportMsg> &msg) {
+  auto header = msg->header;
+  _lastVideoTimestamp = header->timestamp;
+
+  if (header->bodySize <= Rtmp::VideoDataMinSize) {
+    LOG_ERROR("%s - video size fail - stream(%s) size(%d)", _logName, _streamPath.c_str(), header->bodySize);
+    return true;
+  }
+
+  if (Rtmp::IsVideoSequenceHeader(msg->body->data(), msg->body->size())) {
+    if (_mediaInfo->video) {
+      return true; // same stream, config resent
+    }
+
+    if (Rtmp::GetVideoCodecId(msg->body->data(), msg->body->size()) == Rtmp::VideoCodecId::Unknown) {
+      LOG_ERROR("%s - video codec fail - stream(%s) header(0x%02x)", _logName, _streamPath.c_str(), (*msg->body)[0]);
+      return false;
+    }
+
+    // Codec/SPS/PPS Load
+    Rtmp::MediaParser parser;
+    auto config = parser.VideoSeqParse(msg->body);
+    if (!config) {
+      LOG_ERROR("%s - video config parse fail - stream(%s)", _logName, _streamPath.c_str());
+      return false;
+    }
+
+    _mediaInfo->video = config;
+    _mediaInfo->videoSeqHeader = msg->body;
+    return CheckStreamReady();
+  }
+
+  if (!_isReady) {
+    return true;
+  }
+
+  return _event.OnIngestData(std::make_shared<Rtmp::Frame>(header->timestamp, msg->body), true);
+}
+
+//====================================================================================================
+// Amf0 data
+//  - @setDataFrame onMetaData(publisher), onMetaData(origin server)
+//  - kept as received, players get the source document
+//====================================================================================================
+void StreamIngest::OnAmfDataMsg(const std::shared_ptr<ImportMsg> &msg) {
+  auto doc = std::make_shared<AmfDoc>();
+  if (doc->Decode(msg->body) == 0) {
+    LOG_WARN("%s - amf0 data message doc length 0 - stream(%s)", _logName, _streamPath.c_str());
+    return;
+  }
+
+  std::string cmd;
+  if (doc->GetProp(0) != nullptr && doc->GetProp(0)->GetType() == AmfDataType::String) {
+    cmd = doc->GetProp(0)->GetString();
+  }
+
+  std::string dataName;
+  if (doc->GetProp(1) != nullptr && doc->GetProp(1)->GetType() == AmfDataType::String) {
+    dataName = doc->GetProp(1)->GetString();
+  }
+
+  if (cmd == Rtmp::Cmd::SetDataFrame && dataName == Rtmp::Cmd::OnMetaData) {
+    OnMetaData(doc, 2);
+  } else if (cmd == Rtmp::Cmd::OnMetaData) {
+    OnMetaData(doc, 1);
+  } else {
+    LOG_WARN("%s - unknown amf0 data message - stream(%s) message(%s)", _logName, _streamPath.c_str(), cmd.c_str());
+  }
+}
+
+//====================================================================================================
+// Metadata
+//  - objectIndex : property index of the metadata object(or ecma array)
+//====================================================================================================
+void StreamIngest::OnMetaData(const std::shared_ptr<AmfDoc> &doc, int objectIndex) {
+  _mediaInfo->metaData = doc;
+
+  auto prop = doc->GetProp(objectIndex);
+  if (prop == nullptr) {
+    return;
+  }
+
+  AmfObjectArray *object = nullptr;
+  int index = 0;
+
+  if (prop->GetType() == AmfDataType::Object)
+    object = reinterpret_cast<AmfObjectArray *>(prop->GetObject().get());
+  else if (prop->GetType() == AmfDataType::Array)
+    object = reinterpret_cast<AmfObjectArray *>(prop->GetArray().get());
+
+  if (object == nullptr) {
+    return;
+  }
+
+  auto metaInfo = std::make_shared<Rtmp::MetaInfo>();
+
+  // DeviceType
+  if ((index = object->FindName("videodevice")) >= 0 && object->GetType(index) == AmfDataType::String) {
+    metaInfo->encoder = object->GetString(index); // DeviceType - XSplit
+  } else if ((index = object->FindName("encoder")) >= 0 && object->GetType(index) == AmfDataType::String) {
+    metaInfo->encoder = object->GetString(index); // DeviceType - OBS
+  }
+  metaInfo->encoder = StringHelper::Replace(metaInfo->encoder, "%", "");
+
+  if ((index = object->FindName("framerate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoFps = object->GetNumber(index);
+  } else if ((index = object->FindName("videoframerate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoFps = object->GetNumber(index);
+  }
+
+  if ((index = object->FindName("width")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoWidth = object->GetNumber(index); // Width
+  }
+
+  if ((index = object->FindName("height")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoHeight = object->GetNumber(index); // Height
+  }
+
+  if ((index = object->FindName("videodatarate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoBps = object->GetNumber(index); // Video Data Rate
+  }
+
+  if ((index = object->FindName("bitrate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
+    metaInfo->videoBps = object->GetNumber(index); // Video Data Rate
+  }
+
+  if ((index = object->FindName("maxBitrate")) >= 0 && object->GetType(index) == AmfDataType::String) {
+    metaInfo->videoBps = atoi(object->GetString(index));
+  }
+
+  // audio bitrate
+  if (((index = object->FindName("audiodatarate")) >= 0 || (index = object->FindName("audiobitrate")) >= 0) &&
+      (object->GetType(index) == AmfDataType::Number)) {
+    metaInfo->audioBps = object->GetNumber(index); // Audio Data Rate
+  }
+
+  _mediaInfo->metaInfo = metaInfo;
+
+  std::cout << "=== Meta Info ===" << std::endl;
+  std::cout << "Encoder: " << metaInfo->encoder << std::endl;
+  std::cout << "Video Fps: " << metaInfo->videoFps << std::endl;
+  std::cout << "Video Bitrate: " << metaInfo->videoBps << std::endl;
+  std::cout << "Video Width: " << metaInfo->videoWidth << std::endl;
+  std::cout << "Video Height: " << metaInfo->videoHeight << std::endl;
+  std::cout << "Audio Bitrate: " << metaInfo->audioBps << std::endl;
+}
+
+//====================================================================================================
+// Check stream ready(video + audio config)
+//====================================================================================================
+bool StreamIngest::CheckStreamReady() {
+  if (_isReady || !_mediaInfo->video || !_mediaInfo->audio) {
+    return true;
+  }
+
+  _isReady = true;
+  return _event.OnIngestReady(_mediaInfo);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "common/common_header.h"
+#include "media/rtmp/amf_document.h"
+#include "media/rtmp/rtmp_import_chunk.h"
+#include "media/rtmp/rtmp_media_parser.h"
+#include <memory>
+#include <string>
+
+class StreamIngestEvent {
+public:
+  virtual ~StreamIngestEvent() = default;
+
+  virtual bool OnIngestReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) = 0;
+  virtual bool OnIngestData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) = 0;
+};
+
+//====================================================================================================
+// StreamIngest
+//  - media messages of an incoming rtmp stream(studio publish, edge play) : audio/video/aggregate/data
+//  - sequence headers build the media info, ready once video + audio are known(resent config ignored)
+//  - frames are passed to the owner after ready
+//====================================================================================================
+class StreamIngest {
+public:
+  StreamIngest(StreamIngestEvent &event, const char *logName) : _event(event), _logName(logName) {}
+  ~StreamIngest() = default;
+
+  static bool IsMediaMsg(int type);
+
+  bool OnMediaMsg(const std::shared_ptr<ImportMsg> &msg);
+  void SetStreamPath(const std::string &streamPath) { _streamPath = streamPath; }
+  const std::shared_ptr<Rtmp::MediaInfo> &GetMediaInfo() const { return _mediaInfo; }
+  uint32_t GetLastVideoTimestamp() const { return _lastVideoTimestamp; }
+  uint32_t GetLastAudioTimestamp() const { return _lastAudioTimestamp; }
+
+private:
+  bool OnAudioMsg(const std::shared_ptr<ImportMsg> &msg);
+  bool OnVideoMsg(const std::shared_ptr<ImportMsg> &msg);
+  bool OnAggregateMsg(const std::shared_ptr<ImportMsg> &msg);
+  void OnAmfDataMsg(const std::shared_ptr<ImportMsg> &msg);
+  void OnMetaData(const std::shared_ptr<AmfDoc> &doc, int objectIndex);
+  bool CheckStreamReady();
+
+private:
+  StreamIngestEvent &_event;
+  const char *_logName;
+  std::string _streamPath;
+
+  std::shared_ptr<Rtmp::MediaInfo> _mediaInfo = std::make_shared<Rtmp::MediaInfo>();
+  bool _isReady = false;
+
+  uint32_t _lastVideoTimestamp = 0;
+  uint32_t _lastAudioTimestamp = 0;
+};
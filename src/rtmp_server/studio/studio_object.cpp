@@ -42,7 +42,7 @@ bool StudioObject::SendPackt(int dataSize, uint8_t *data) {
 //====================================================================================================
 //  Recv Handler
 //====================================================================================================
-int StudioObject::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) { return _stream->RecvHandler(data); }
+int StudioObject::RecvHandler(std::span<const uint8_t> data) { return _stream->RecvHandler(data); }
 
 //====================================================================================================
 // stream send
@@ -75,7 +75,8 @@ bool StudioObject::OnStreamStart(const std::string &streamPath) {
 bool StudioObject::OnStreamReady(const std::string &streamApp, const std::string &streamKey,
                                  const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
   // Callback
-  if (!_event->OnStudioReady(_indexKey, _streamPath, streamApp, streamKey, mediaInfo)) {
+  _streamHub = _event->OnStudioReady(_indexKey, _streamPath, streamApp, streamKey, mediaInfo);
+  if (_streamHub == nullptr) {
     LOG_ERROR("OnStreamReady - ready complete fail - object(%s) stream(%s) ", _objectName.c_str(), _streamPath.c_str());
     return false;
   }
@@ -91,12 +92,14 @@ bool StudioObject::OnStreamData(const std::shared_ptr<Rtmp::Frame> &frame, bool
     return true;
   }
 
-  // Callback
-  if (!_event->OnStudioStream(_indexKey, _streamPath, frame, isVideo)) {
-    LOG_ERROR("OnStreamData - stream data fail - object(%s) stream(%s)", _objectName.c_str(), _streamPath.c_str());
+  if (_streamHub == nullptr) {
+    LOG_ERROR("OnStreamData - stream hub none - object(%s) stream(%s)", _objectName.c_str(), _streamPath.c_str());
     return false;
   }
 
+  // Player에 데이터 전달
+  _streamHub->PushFrame(frame, isVideo);
+
   auto curTick = GetCurrentTick();
 
   if (_fpsCheck.checkTick == 0) {
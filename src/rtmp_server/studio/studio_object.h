@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "network/network_tcp_object.h"
+#include "rtmp_server/stream/stream_hub.h"
 #include "studio_stream.h"
 #include <memory>
 #include <vector>
@@ -34,10 +35,9 @@ public:
   virtual ~StudioEvent() = default;
 
   virtual bool OnStudioStart(int indexKey, const std::string &streamPath) = 0;
-  virtual bool OnStudioReady(int indexKey, const std::string &streamStreamPath, const std::string &streamApp,
-                             const std::string &streamKey, const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) = 0;
-  virtual bool OnStudioStream(int indexKey, const std::string &streamStreamPath,  const std::shared_ptr<Rtmp::Frame> &frame,
-                              bool isVideo) = 0;
+  virtual std::shared_ptr<StreamHub> OnStudioReady(int indexKey, const std::string &streamStreamPath,
+                                                   const std::string &streamApp, const std::string &streamKey,
+                                                   const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) = 0;
 };
 
 //====================================================================================================
@@ -57,7 +57,7 @@ public:
   bool StreamStop();
 
 protected:
-  int RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) override;
+  int RecvHandler(std::span<const uint8_t> data) override;
 
   // RtmpEncooderStream implement
   bool StreamSendData(const std::shared_ptr<std::vector<uint8_t>> &data);
@@ -71,6 +71,7 @@ private:
   std::shared_ptr<StudioStream> _stream;
   std::string _streamPath;
   std::string _mediaId;
+  std::shared_ptr<StreamHub> _streamHub = nullptr; // resolved once at ready
 
   // Framerate check
   FpsCheck _fpsCheck;
@@ -36,8 +36,7 @@ const std::string &StudioService::GetStreamPath(int indexKey) {
 // Stream start
 //====================================================================================================
 bool StudioService::StreamStart(const std::string &streamPath, const std::string &mediaId) {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
-  for (const auto &[indexKey, object] : _netObjects) {
+  for (const auto &object : GetObjects()) {
     if (std::static_pointer_cast<StudioObject>(object)->GetStreamPath() == streamPath) {
       return std::static_pointer_cast<StudioObject>(object)->StreamStart(mediaId);
     }
@@ -49,8 +48,7 @@ bool StudioService::StreamStart(const std::string &streamPath, const std::string
 // Stream stop
 //====================================================================================================
 bool StudioService::StreamStop(const std::string &streamPath) {
-  std::lock_guard<std::mutex> lock(_netObjectsLock);
-  for (const auto &[indexKey, object] : _netObjects) {
+  for (const auto &object : GetObjects()) {
     if (std::static_pointer_cast<StudioObject>(object)->GetStreamPath() == streamPath) {
       return std::static_pointer_cast<StudioObject>(object)->StreamStop();
     }
@@ -64,9 +62,7 @@ bool StudioService::StreamStop(const std::string &streamPath) {
 std::shared_ptr<std::vector<std::shared_ptr<InputStreamingInfo>>> StudioService::GetCurrentStreamingInfo() {
   auto infos = std::make_shared<std::vector<std::shared_ptr<InputStreamingInfo>>>();
 
-  std::lock_guard<std::mutex> networkLock(_netObjectsLock);
-
-  for (const auto &[indexKey, object] : _netObjects) {
+  for (const auto &object : GetObjects()) {
     infos->push_back(std::static_pointer_cast<StudioObject>(object)->GetCurrentStreamingInfo());
   }
 
@@ -3,9 +3,9 @@
 #include <utility>
 
 // OnDataReceived
-int StudioStream::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data) {
-  if (data->size() > Rtmp::MaxPacketSize) {
-    LOG_ERROR("studio - recv data size fail - stream(%s) size(%d)", _streamPath.c_str(), data->size());
+int StudioStream::RecvHandler(std::span<const uint8_t> data) {
+  if (data.size() > Rtmp::MaxPacketSize) {
+    LOG_ERROR("studio - recv data size fail - stream(%s) size(%zu)", _streamPath.c_str(), data.size());
     return -1;
   }
 
@@ -20,7 +20,7 @@ int StudioStream::RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data)
 }
 
 // Handshake
-int StudioStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+int StudioStream::RecvHandshake(std::span<const uint8_t> data) {
   int procSize = 0;
 
   if (_handshakeState == Rtmp::HandshakeState::Ready) {
@@ -33,14 +33,14 @@ int StudioStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
   }
 
   // Process Data Size Check
-  if (static_cast<int>(data->size()) < procSize) {
+  if (static_cast<int>(data.size()) < procSize) {
     return 0;
   }
 
   // c0+c1 / s0+s1+s2
   if (_handshakeState == Rtmp::HandshakeState::Ready) {
-    if ((*data)[0] != Rtmp::HandshakeVersion) {
-      LOG_WRITE("studio - handshake version fail - version(%d:%d)", (*data)[0], Rtmp::HandshakeVersion);
+    if (data[0] != Rtmp::HandshakeVersion) {
+      LOG_WRITE("studio - handshake version fail - version(%d:%d)", data[0], Rtmp::HandshakeVersion);
       return -1;
     }
     _handshakeState = Rtmp::HandshakeState::C0;
@@ -57,8 +57,8 @@ int StudioStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
   _handshakeState = Rtmp::HandshakeState::C2;
 
   // chunk가 같이 들어오는 경우 처리
-  if (procSize < static_cast<int>(data->size())) {
-    int chunkProcSize = RecvChunk(std::make_shared<std::vector<uint8_t>>(data->begin() + procSize, data->end()));
+  if (procSize < static_cast<int>(data.size())) {
+    int chunkProcSize = RecvChunk(data.subspan(procSize));
 
     if (chunkProcSize < 0) {
       return -1;
@@ -73,7 +73,7 @@ int StudioStream::RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>
 }
 
 // SendHandshake
-bool StudioStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+bool StudioStream::SendHandshake(std::span<const uint8_t> data) {
   _handshakeState = Rtmp::HandshakeState::C1;
 
   // S0 S1 S2 Send
@@ -82,7 +82,7 @@ bool StudioStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t
     return false;
   }
 
-  if (!event->StreamSendData(RtmpHandshake::MakeS0_S1_S2(data->data() + 1))) {
+  if (!event->StreamSendData(RtmpHandshake::MakeS0_S1_S2(data.data() + 1))) {
     LOG_ERROR("studio - handshake s0+s1+s2 send fail");
     return false;
   }
@@ -93,11 +93,11 @@ bool StudioStream::SendHandshake(const std::shared_ptr<const std::vector<uint8_t
 }
 
 // RecvChunk
-int32_t StudioStream::RecvChunk(const std::shared_ptr<const std::vector<uint8_t>> &data) {
+int32_t StudioStream::RecvChunk(std::span<const uint8_t> data) {
   int procSize = 0;
 
-  while (procSize < static_cast<int>(data->size())) {
-    auto [size, isComplete] = _importChunk->ImportStreamData(data->data() + procSize, data->size() - procSize);
+  while (procSize < static_cast<int>(data.size())) {
+    auto [size, isComplete] = _importChunk->ImportStreamData(data.data() + procSize, data.size() - procSize);
 
     if (size == 0) {
       break;
@@ -147,14 +147,10 @@ bool StudioStream::ProcessChunkMsg() {
     bool result = true;
     auto type = msg->header->typeId;
 
-    if (type == static_cast<int>(Rtmp::MsgType::AudioMsg)) {
-      result = OnAudioMsg(msg);
-    } else if (type == static_cast<int>(Rtmp::MsgType::VideoMsg)) {
-      result = OnVideoMsg(msg);
+    if (StreamIngest::IsMediaMsg(type)) {
+      result = _ingest.OnMediaMsg(msg);
     } else if (type == static_cast<int>(Rtmp::MsgType::SetChunkSize)) {
       result = OnSetChunkSize(msg);
-    } else if (type == static_cast<int>(Rtmp::MsgType::Amf0DataMsg)) {
-      OnAmfDataMsg(msg);
     } else if (type == static_cast<int>(Rtmp::MsgType::Amf0CmdMsg)) {
       OnAmfCmdMsg(msg);
     } else if (type == static_cast<int>(Rtmp::MsgType::WindowAckSize)) {
@@ -235,31 +231,6 @@ void StudioStream::OnAmfCmdMsg(const std::shared_ptr<ImportMsg> &msg) {
   }
 }
 
-// OnAmfDataMsg
-void StudioStream::OnAmfDataMsg(const std::shared_ptr<ImportMsg> &msg) {
-  auto doc = std::make_shared<AmfDoc>();
-  if (doc->Decode(msg->body) == 0) {
-    LOG_WARN("studio - amf0 data message doc length 0 - stream(%s)", _streamPath.c_str());
-    return;
-  }
-
-  std::string cmd;
-  if (doc->GetProp(0) != nullptr && doc->GetProp(0)->GetType() == AmfDataType::String) {
-    cmd = doc->GetProp(0)->GetString();
-  }
-
-  std::string dataName;
-  if (doc->GetProp(1) != nullptr && doc->GetProp(1)->GetType() == AmfDataType::String) {
-    dataName = doc->GetProp(1)->GetString();
-  }
-
-  if (cmd == Rtmp::Cmd::SetDataFrame && dataName == Rtmp::Cmd::OnMetaData) {
-    OnAmfMetaData(doc);
-  } else {
-    LOG_WARN("studio - unknown amf0 data message - stream(%s) message(%s)", _streamPath.c_str(), cmd.c_str());
-  }
-}
-
 // OnAmfConnect
 void StudioStream::OnAmfConnect(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc,
                                 double transacrtionId) {
@@ -338,6 +309,7 @@ void StudioStream::OnAmfPublish(const std::shared_ptr<RtmpMuxMsgHeader> &header,
   // stream key setting
   _streamKey = doc->GetProp(3)->GetString();
   _streamPath = _streamApp + "/" + _streamKey;
+  _ingest.SetStreamPath(_streamPath);
   _chunkStreamId = header->chunkStreamId;
 
   auto event = _event.lock();
@@ -380,7 +352,7 @@ bool StudioStream::SendMsg(std::shared_ptr<RtmpMuxMsgHeader> header,
     return false;
   }
 
-  auto exportData = _exportChunk->ExportStreamData(header, data);
+  auto exportData = _exportChunk->ExportStreamData(*header, data);
 
   if (!exportData || !exportData->data()) {
     return false;
@@ -400,7 +372,7 @@ bool StudioStream::SendAmfCmd(std::shared_ptr<RtmpMuxMsgHeader> header, const st
     return false;
   }
 
-  auto body = std::make_shared<std::vector<uint8_t>>(2048);
+  auto body = BufferPool::Alloc(2048);
 
   // body
   uint32_t bodySize = static_cast<uint32_t>(doc->Encode(body->data()));
@@ -552,180 +524,22 @@ bool StudioStream::SendAmfOnStatus(uint32_t chunkStreamId, uint32_t streamId, co
       doc);
 }
 
-// OnAudioMsg
-bool StudioStream::OnAudioMsg(const std::shared_ptr<ImportMsg> &msg) {
-  auto header = msg->header;
-
-  // set last timestamp
-  _lastAudioTimestamp = header->timestamp;
-
-  if (header->bodySize > Rtmp::MaxPacketSize || header->bodySize < 2) {
-    LOG_ERROR("studio - audio size fail - stream(%s) size(%d)", _streamPath.c_str(), header->bodySize);
-    return false;
-  }
-
-  if (!_mediaInfo->audio && msg->body->at(1) == 0x00) {
-    Rtmp::MediaParser parser;
-    auto config = parser.AacSeqParse(msg->body);
-    if (!config) {
-      LOG_ERROR("studio - audio config parse fail - stream(%s)", _streamPath.c_str());
-      return false;
-    }
-
-    _mediaInfo->audio = config;
-    _mediaInfo->audioSeqHeader = msg->body;
-
-    CheckStreamReady();
-
-    return true;
-  }
-
-  if (!_mediaInfo->audio) {
-    return true;
-  }
-
+// OnIngestReady
+bool StudioStream::OnIngestReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) {
   auto event = _event.lock();
   if (!event) {
     return false;
   }
 
-  return event->OnStreamData(std::make_shared<Rtmp::Frame>(header->timestamp, msg->body), false);
+  return event->OnStreamReady(_streamApp, _streamKey, mediaInfo);
 }
 
-// OnVideoMsg
-bool StudioStream::OnVideoMsg(const std::shared_ptr<ImportMsg> &msg) {
-  auto header = msg->header;
-
-  // set last timestamp
-  _lastVideoTimestamp = header->timestamp;
-
-  if (header->bodySize <= Rtmp::VideoDataMinSize || header->bodySize > Rtmp::MaxPacketSize) {
-    LOG_ERROR("studio - video size fail - stream(%s) size(%d)", _streamPath.c_str(), header->bodySize);
-    return true;
-  }
-
-  if (!_mediaInfo->video && msg->body->at(1) == 0x00) {
-    const auto codecId = (*msg->body)[0] & 0x0f;
-    if (codecId != 7) {
-      // TODO: 12(HEVC) 13(AV1)
-      LOG_ERROR("studio - video codec fail - stream(%s)", _streamPath.c_str());
-      return false;
-    }
-
-    // Codec/SPS/PPS Load
-    Rtmp::MediaParser parser;
-    auto config = parser.H264SeqParse(msg->body);
-    if (!config) {
-      LOG_ERROR("studio - video config parse fail - stream(%s)", _streamPath.c_str());
-      return false;
-    }
-
-    _mediaInfo->video = config;
-    _mediaInfo->videoSeqHeader = msg->body;
-
-    CheckStreamReady();
-
-    return true;
-  }
-
-  if (!_mediaInfo->video) {
-    return true;
-  }
-
-  if (header->bodySize < Rtmp::VideoFrameIndex) {
-    LOG_ERROR("studio - video body size fail - stream(%s) size(%u:%d)", _streamPath.c_str(), header->bodySize,
-              Rtmp::VideoFrameIndex);
-    return false;
-  }
-
+// OnIngestData
+bool StudioStream::OnIngestData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) {
   auto event = _event.lock();
   if (!event) {
     return false;
   }
 
-  return event->OnStreamData(std::make_shared<Rtmp::Frame>(header->timestamp, msg->body), true);
+  return event->OnStreamData(frame, isVideo);
 }
-
-// CheckStreamReady
-bool StudioStream::CheckStreamReady() {
-  if (!_mediaInfo->video || !_mediaInfo->audio) {
-    return false;
-  }
-
-  auto event = _event.lock();
-  if (!event) {
-    return false;
-  }
-
-  return event->OnStreamReady(_streamApp, _streamKey, _mediaInfo);
-}
-
-// OnAmfMetaData
-bool StudioStream::OnAmfMetaData(const std::shared_ptr<AmfDoc> &doc) {
-  if (doc->GetProp(2) == nullptr) {
-    return false;
-  }
-
-  AmfObjectArray *object = nullptr;
-  int index = 0;
-
-  if (doc->GetProp(2)->GetType() == AmfDataType::Object)
-    object = reinterpret_cast<AmfObjectArray *>(doc->GetProp(2)->GetObject().get());
-  else
-    object = reinterpret_cast<AmfObjectArray *>(doc->GetProp(2)->GetArray().get());
-
-  auto metaInfo = std::make_shared<Rtmp::MetaInfo>();
-
-  // DeviceType
-  if ((index = object->FindName("videodevice")) >= 0 && object->GetType(index) == AmfDataType::String) {
-    metaInfo->encoder = object->GetString(index); // DeviceType - XSplit
-  } else if ((index = object->FindName("encoder")) >= 0 && object->GetType(index) == AmfDataType::String) {
-    metaInfo->encoder = object->GetString(index); // DeviceType - OBS
-  }
-  metaInfo->encoder = StringHelper::Replace(metaInfo->encoder, "%", "");
-
-  if ((index = object->FindName("framerate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoFps = object->GetNumber(index);
-  } else if ((index = object->FindName("videoframerate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoFps = object->GetNumber(index);
-  }
-
-  if ((index = object->FindName("width")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoWidth = object->GetNumber(index); // Width
-  }
-
-  if ((index = object->FindName("height")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoHeight = object->GetNumber(index); // Height
-  }
-
-  if ((index = object->FindName("videodatarate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoBps = object->GetNumber(index); // Video Data Rate
-  }
-
-  if ((index = object->FindName("bitrate")) >= 0 && object->GetType(index) == AmfDataType::Number) {
-    metaInfo->videoBps = object->GetNumber(index); // Video Data Rate
-  }
-
-  if ((index = object->FindName("maxBitrate")) >= 0 && object->GetType(index) == AmfDataType::String) {
-    metaInfo->videoBps = atoi(object->GetString(index));
-  }
-
-  // audio bitrate
-  if (((index = object->FindName("audiodatarate")) >= 0 || (index = object->FindName("audiobitrate")) >= 0) &&
-      (object->GetType(index) == AmfDataType::Number)) {
-    metaInfo->audioBps = object->GetNumber(index); // Audio Data Rate
-  }
-
-  _mediaInfo->metaInfo = metaInfo;
-  _mediaInfo->metaData = doc;
-
-  std::cout << "=== Meta Info ===" << std::endl;
-  std::cout << "Encoder: " << metaInfo->encoder << std::endl;
-  std::cout << "Video Fps: " << metaInfo->videoFps << std::endl;
-  std::cout << "Video Bitrate: " << metaInfo->videoBps << std::endl;
-  std::cout << "Video Width: " << metaInfo->videoWidth << std::endl;
-  std::cout << "Video Height: " << metaInfo->videoHeight << std::endl;
-  std::cout << "Audio Bitrate: " << metaInfo->audioBps << std::endl;
-
-  return true;
-}
\ No newline at end of file
@@ -5,9 +5,11 @@
 #include "media/rtmp/rtmp_handshake.h"
 #include "media/rtmp/rtmp_import_chunk.h"
 #include "media/rtmp/rtmp_media_parser.h"
+#include "rtmp_server/stream/stream_ingest.h"
 #include <functional>
 #include <map>
 #include <memory>
+#include <span>
 #include <time.h>
 #include <vector>
 
@@ -22,29 +24,29 @@ public:
   virtual bool OnStreamData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) = 0;
 };
 
-class StudioStream {
+class StudioStream : public StreamIngestEvent {
 public:
   StudioStream(const std::shared_ptr<StudioStreamEvent> &event) : _event(std::move(event)) {}
   virtual ~StudioStream() = default;
 
-  int RecvHandler(const std::shared_ptr<std::vector<uint8_t>> &data);
+  int RecvHandler(std::span<const uint8_t> data);
   const std::string &GetStreamPath() { return _streamPath; }
-  uint32_t GetLastVideoTimestamp() { return _lastVideoTimestamp; }
-  uint32_t GetLastAudioTimestamp() { return _lastAudioTimestamp; }
+  uint32_t GetLastVideoTimestamp() { return _ingest.GetLastVideoTimestamp(); }
+  uint32_t GetLastAudioTimestamp() { return _ingest.GetLastAudioTimestamp(); }
+
+  bool OnIngestReady(const std::shared_ptr<Rtmp::MediaInfo> &mediaInfo) override;
+  bool OnIngestData(const std::shared_ptr<Rtmp::Frame> &frame, bool isVideo) override;
 
 protected:
-  int32_t RecvHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data);
-  int32_t RecvChunk(const std::shared_ptr<const std::vector<uint8_t>> &data);
+  int32_t RecvHandshake(std::span<const uint8_t> data);
+  int32_t RecvChunk(std::span<const uint8_t> data);
 
-  bool SendHandshake(const std::shared_ptr<const std::vector<uint8_t>> &data);
+  bool SendHandshake(std::span<const uint8_t> data);
 
   bool ProcessChunkMsg();
   bool OnSetChunkSize(const std::shared_ptr<ImportMsg> &msg);
   void OnWindowAckSize(const std::shared_ptr<ImportMsg> &msg);
   void OnAmfCmdMsg(const std::shared_ptr<ImportMsg> &msg);
-  void OnAmfDataMsg(const std::shared_ptr<ImportMsg> &msg);
-  bool OnAudioMsg(const std::shared_ptr<ImportMsg> &msg);
-  bool OnVideoMsg(const std::shared_ptr<ImportMsg> &msg);
 
   void OnAmfConnect(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc,
                     double transacrtionId);
@@ -56,7 +58,6 @@ protected:
                     double transacrtionId);
   void OnAmfDeleteStream(const std::shared_ptr<RtmpMuxMsgHeader> &header, const std::shared_ptr<AmfDoc> &doc,
                          double transacrtionId);
-  bool OnAmfMetaData(const std::shared_ptr<AmfDoc> &doc);
 
   bool SendMsg(const std::shared_ptr<RtmpMuxMsgHeader> header, const std::shared_ptr<std::vector<uint8_t>> &data);
   bool SendUserControlMsg(const uint16_t msg, const std::shared_ptr<std::vector<uint8_t>> &data);
@@ -73,8 +74,6 @@ protected:
   bool SendAmfOnStatus(uint32_t chunkStreamId, uint32_t streamId, const char *level, const char *code,
                        const char *description, double client_id);
 
-  bool CheckStreamReady();
-
 private:
   std::string _streamPath;
   std::string _streamApp;
@@ -83,7 +82,6 @@ private:
   Rtmp::HandshakeState _handshakeState = Rtmp::HandshakeState::Ready;
   std::unique_ptr<RtmpImportChunk> _importChunk = std::make_unique<RtmpImportChunk>(Rtmp::DefaultChunkSize);
   std::unique_ptr<RtmpExportChunk> _exportChunk = std::make_unique<RtmpExportChunk>(false, Rtmp::DefaultChunkSize);
-  std::shared_ptr<Rtmp::MediaInfo> _mediaInfo = std::make_shared<Rtmp::MediaInfo>();
 
   uint32_t _streamId = 0;
   uint32_t _peerBandwidth = Rtmp::DefaultPeerBandWidth;
@@ -92,8 +90,6 @@ private:
   double _clientId = 12345.0;
   int _chunkStreamId = 0;
 
-  uint64_t _lastVideoTimestamp = 0;
-  uint64_t _lastAudioTimestamp = 0;
-
   std::weak_ptr<StudioStreamEvent> _event;
+  StreamIngest _ingest{*this, "studio"};
 };
\ No newline at end of file
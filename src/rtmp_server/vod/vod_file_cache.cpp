@@ -0,0 +1,127 @@
+#include "vod_file_cache.h"
+#include "common/common_header.h"
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+
+//====================================================================================================
+// Open
+//  - file is opened(index scan) outside the lock, the first one in the cache wins
+//====================================================================================================
+std::shared_ptr<FlvFile> VodFileCache::Open(const std::string &streamPath) {
+  // no path escape
+  if (streamPath.empty() || streamPath.front() == '/' || streamPath.find("..") != std::string::npos ||
+      streamPath.find('\\') != std::string::npos) {
+    LOG_WARN("Vod file - invalid stream - stream(%s)", streamPath.c_str());
+    return nullptr;
+  }
+
+  auto name = streamPath;
+  if (name.size() > 4 && name.compare(name.size() - 4, 4, ".flv") == 0) {
+    name.resize(name.size() - 4);
+  }
+
+  auto flatName = name;
+  std::replace(flatName.begin(), flatName.end(), '/', '_');
+
+  for (const auto &filePath : {_vodPath + "/" + name + ".flv", FindRecordFile(flatName)}) {
+    if (filePath.empty()) {
+      continue;
+    }
+
+    if (auto file = Find(filePath)) {
+      return file;
+    }
+
+    auto file = std::make_shared<FlvFile>();
+    if (!file->Open(filePath)) {
+      continue;
+    }
+
+    // --- Lock Block ---
+    std::lock_guard<std::mutex> lock(_filesLock);
+    auto &cacheFile = _files[filePath];
+    if (cacheFile.file == nullptr || cacheFile.file->IsModified()) {
+      cacheFile.file = file;
+    }
+    cacheFile.lastUseTime = GetCurrentMs();
+    return cacheFile.file;
+  }
+
+  return nullptr;
+}
+
+//====================================================================================================
+// Find record file
+//  - RecordWriter file name : {app}_{key}_{yyyymmdd-hhmmss}.flv, the newest name is the latest record
+//====================================================================================================
+std::string VodFileCache::FindRecordFile(const std::string &flatName) const {
+  static constexpr size_t TimeSize = 15; // yyyymmdd-hhmmss
+
+  auto dir = opendir(_vodPath.c_str());
+  if (dir == nullptr) {
+    return "";
+  }
+
+  const auto prefix = flatName + "_";
+  std::string newestName;
+
+  while (auto entry = readdir(dir)) {
+    const std::string fileName = entry->d_name;
+    if (fileName.size() != prefix.size() + TimeSize + 4 || fileName.compare(0, prefix.size(), prefix) != 0 ||
+        fileName.compare(fileName.size() - 4, 4, ".flv") != 0) {
+      continue;
+    }
+
+    // exact time part : key "a" must not match the records of key "a_b"
+    bool isTime = true;
+    for (size_t index = 0; index < TimeSize; ++index) {
+      const auto c = fileName[prefix.size() + index];
+      if (index == 8 ? c != '-' : !isdigit(static_cast<unsigned char>(c))) {
+        isTime = false;
+        break;
+      }
+    }
+
+    if (isTime && fileName > newestName) {
+      newestName = fileName;
+    }
+  }
+
+  closedir(dir);
+  return newestName.empty() ? "" : _vodPath + "/" + newestName;
+}
+
+//====================================================================================================
+// Find(opened and not changed)
+//====================================================================================================
+std::shared_ptr<FlvFile> VodFileCache::Find(const std::string &filePath) {
+  std::lock_guard<std::mutex> lock(_filesLock);
+
+  auto it = _files.find(filePath);
+  if (it == _files.end()) {
+    return nullptr;
+  }
+
+  if (it->second.file->IsModified()) {
+    _files.erase(it);
+    return nullptr;
+  }
+
+  it->second.lastUseTime = GetCurrentMs();
+  return it->second.file;
+}
+
+//====================================================================================================
+// Cleanup
+//  - unused files over KeepTime are unmapped(the players still hold theirs)
+//====================================================================================================
+void VodFileCache::Cleanup() {
+  const auto currentTime = GetCurrentMs();
+
+  std::lock_guard<std::mutex> lock(_filesLock);
+  std::erase_if(_files, [currentTime](const auto &item) {
+    const auto &cacheFile = item.second;
+    return cacheFile.file.use_count() == 1 && cacheFile.lastUseTime + KeepTime < currentTime;
+  });
+}
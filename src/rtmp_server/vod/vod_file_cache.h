@@ -0,0 +1,37 @@
+#pragma once
+#include "media/flv/flv_file.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+//====================================================================================================
+// VodFileCache(recorded flv files)
+//  - stream(app/key) -> {vodPath}/{app}/{key}.flv
+//    else the newest record file(RecordWriter) {vodPath}/{app}_{key}_{yyyymmdd-hhmmss}.flv
+//  - opened files(mapping + key frame index) are shared by every player and kept KeepTime after the last use
+//  - a changed file(size/mtime) is opened again, players on the old mapping keep it until they end
+//====================================================================================================
+class VodFileCache {
+public:
+  explicit VodFileCache(const std::string &vodPath) : _vodPath(vodPath) {}
+  ~VodFileCache() = default;
+
+  std::shared_ptr<FlvFile> Open(const std::string &streamPath); // blocking(stat, mapping, index scan), not on network
+  void Cleanup(); // garbage timer
+
+  static constexpr uint64_t KeepTime = 60000; // ms
+
+private:
+  struct CacheFile {
+    std::shared_ptr<FlvFile> file;
+    uint64_t lastUseTime; // ms
+  };
+
+  std::shared_ptr<FlvFile> Find(const std::string &filePath);
+  std::string FindRecordFile(const std::string &flatName) const; // blocking(directory scan)
+
+  std::string _vodPath;
+  std::map<std::string, CacheFile> _files; // file path, _filesLock
+  std::mutex _filesLock;
+};